@@ -109,6 +109,200 @@ inline IType Round(double val)
 inline bool operator==(const IntPoint &l, const IntPoint &r) { return l.x() == r.x() && l.y() == r.y(); }
 inline bool operator!=(const IntPoint &l, const IntPoint &r) { return l.x() != r.x() || l.y() != r.y(); }
 
+//------------------------------------------------------------------------------
+// Vectorized kernels of the offsetter with a runtime CPU dispatch.
+// The kernels evaluate the very same IEEE double operations in the same order as the scalar code,
+// thus their results are bit identical to the scalar implementation. FMA is not used on purpose.
+//------------------------------------------------------------------------------
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  // SSE2 is the baseline of any x64 CPU.
+  #define CLIPPERLIB_SIMD_SSE2
+  #include <emmintrin.h>
+  #if defined(CLIPPERLIB_INT32) && ! defined(CLIPPERLIB_USE_XYZ)
+    // Normals are vectorized for the tightly packed 32bit (x, y) points only.
+    #define CLIPPERLIB_SIMD_NORMALS
+    #if defined(__GNUC__) && ! defined(_MSC_VER)
+      // GCC / Clang: compile the AVX kernel for its target only, select it at runtime.
+      #define CLIPPERLIB_SIMD_AVX
+      #define CLIPPERLIB_TARGET_AVX __attribute__((target("avx")))
+      #include <immintrin.h>
+    #elif defined(_MSC_VER) && ! defined(__clang__)
+      // MSVC accepts AVX intrinsics in any function.
+      #define CLIPPERLIB_SIMD_AVX
+      #define CLIPPERLIB_TARGET_AVX
+      #include <immintrin.h>
+      #include <intrin.h>
+    #endif
+  #endif
+#endif
+
+// Unit normal of a segment (pt1, pt2), (0, 0) for a zero length segment.
+static inline DoublePoint GetUnitNormal(const IntPoint &pt1, const IntPoint &pt2)
+{
+  if(pt2.x() == pt1.x() && pt2.y() == pt1.y()) 
+    return DoublePoint(0, 0);
+
+  double Dx = double(pt2.x() - pt1.x());
+  double dy = double(pt2.y() - pt1.y());
+  double f = 1.0 / std::sqrt( Dx*Dx + dy*dy );
+  Dx *= f;
+  dy *= f;
+  return DoublePoint(dy, -Dx);
+}
+
+// Unit normals of segments (pts[i], pts[i + 1]) for i = 0 .. cnt - 1.
+typedef void (*UnitNormalsFn)(const IntPoint *pts, size_t cnt, DoublePoint *out);
+
+static void UnitNormalsScalar(const IntPoint *pts, size_t cnt, DoublePoint *out)
+{
+  for (size_t i = 0; i < cnt; ++ i)
+    out[i] = GetUnitNormal(pts[i], pts[i + 1]);
+}
+
+#ifdef CLIPPERLIB_SIMD_NORMALS
+static_assert(sizeof(IntPoint) == 2 * sizeof(int32_t), "IntPoint is expected to be a tightly packed (x, y) pair of int32_t");
+
+// Differences (pts[i + 1] - pts[i], pts[i + 2] - pts[i + 1]) reordered to (dx0, dx1, dy0, dy1).
+// The differences are calculated with 32bit integers as GetUnitNormal() does.
+static inline __m128i SegmentVectorsSSE2(const IntPoint *pts)
+{
+  __m128i d = _mm_sub_epi32(
+    _mm_loadu_si128(reinterpret_cast<const __m128i*>(pts + 1)),
+    _mm_loadu_si128(reinterpret_cast<const __m128i*>(pts)));
+  return _mm_shuffle_epi32(d, _MM_SHUFFLE(3, 1, 2, 0));
+}
+
+static void UnitNormalsSSE2(const IntPoint *pts, size_t cnt, DoublePoint *out)
+{
+  const __m128d one  = _mm_set1_pd(1.);
+  const __m128d zero = _mm_setzero_pd();
+  const __m128d sign = _mm_set1_pd(-0.);
+  size_t i = 0;
+  for (; i + 2 <= cnt; i += 2) {
+    __m128i d  = SegmentVectorsSSE2(pts + i);
+    __m128d dx = _mm_cvtepi32_pd(d);
+    __m128d dy = _mm_cvtepi32_pd(_mm_unpackhi_epi64(d, d));
+    __m128d l2 = _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy));
+    // A non-zero integer vector never has a zero length, thus l2 == 0 if and only if pt1 == pt2.
+    __m128d degenerate = _mm_cmpeq_pd(l2, zero);
+    __m128d f  = _mm_div_pd(one, _mm_sqrt_pd(l2));
+    __m128d nx = _mm_andnot_pd(degenerate, _mm_mul_pd(dy, f));
+    // Negation by flipping the sign bit, the same as the unary minus of GetUnitNormal().
+    __m128d ny = _mm_andnot_pd(degenerate, _mm_xor_pd(_mm_mul_pd(dx, f), sign));
+    _mm_storeu_pd(out[i].data(),     _mm_unpacklo_pd(nx, ny));
+    _mm_storeu_pd(out[i + 1].data(), _mm_unpackhi_pd(nx, ny));
+  }
+  UnitNormalsScalar(pts + i, cnt - i, out + i);
+}
+
+#ifdef CLIPPERLIB_SIMD_AVX
+CLIPPERLIB_TARGET_AVX static void UnitNormalsAVX(const IntPoint *pts, size_t cnt, DoublePoint *out)
+{
+  const __m256d one  = _mm256_set1_pd(1.);
+  const __m256d zero = _mm256_setzero_pd();
+  const __m256d sign = _mm256_set1_pd(-0.);
+  size_t i = 0;
+  for (; i + 4 <= cnt; i += 4) {
+    __m128i d01 = SegmentVectorsSSE2(pts + i);
+    __m128i d23 = SegmentVectorsSSE2(pts + i + 2);
+    __m256d dx  = _mm256_cvtepi32_pd(_mm_unpacklo_epi64(d01, d23));
+    __m256d dy  = _mm256_cvtepi32_pd(_mm_unpackhi_epi64(d01, d23));
+    __m256d l2  = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+    __m256d degenerate = _mm256_cmp_pd(l2, zero, _CMP_EQ_OQ);
+    __m256d f   = _mm256_div_pd(one, _mm256_sqrt_pd(l2));
+    __m256d nx  = _mm256_andnot_pd(degenerate, _mm256_mul_pd(dy, f));
+    __m256d ny  = _mm256_andnot_pd(degenerate, _mm256_xor_pd(_mm256_mul_pd(dx, f), sign));
+    // Interleave to (nx0, ny0, nx1, ny1), (nx2, ny2, nx3, ny3).
+    __m256d lo  = _mm256_unpacklo_pd(nx, ny);
+    __m256d hi  = _mm256_unpackhi_pd(nx, ny);
+    _mm256_storeu_pd(out[i].data(),     _mm256_permute2f128_pd(lo, hi, 0x20));
+    _mm256_storeu_pd(out[i + 2].data(), _mm256_permute2f128_pd(lo, hi, 0x31));
+  }
+  UnitNormalsSSE2(pts + i, cnt - i, out + i);
+}
+
+static bool CpuHasAVX()
+{
+#ifdef _MSC_VER
+  int info[4];
+  __cpuid(info, 1);
+  // AVX supported by the CPU and its registers saved by the OS (OSXSAVE + XCR0 bits 1 and 2).
+  return (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6;
+#else
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx");
+#endif
+}
+#endif // CLIPPERLIB_SIMD_AVX
+#endif // CLIPPERLIB_SIMD_NORMALS
+
+// Kernels of the offsetter, see ClipperOffset::SetKernels().
+struct SimdKernels
+{
+  UnitNormalsFn unit_normals;
+  bool          round_sse2;
+};
+
+static bool OffsetKernelsSupported(OffsetKernels kernels)
+{
+  switch (kernels) {
+  case OffsetKernels::Scalar:
+    return true;
+  case OffsetKernels::SSE2:
+#ifdef CLIPPERLIB_SIMD_SSE2
+    return true;
+#else
+    return false;
+#endif // CLIPPERLIB_SIMD_SSE2
+  case OffsetKernels::AVX:
+#ifdef CLIPPERLIB_SIMD_AVX
+    {
+      // Queried just once.
+      static const bool has_avx = CpuHasAVX();
+      return has_avx;
+    }
+#else
+    return false;
+#endif // CLIPPERLIB_SIMD_AVX
+  }
+  return false;
+}
+
+static inline SimdKernels simd_kernels(OffsetKernels kernels)
+{
+  switch (kernels) {
+#ifdef CLIPPERLIB_SIMD_AVX
+  case OffsetKernels::AVX:
+    return { UnitNormalsAVX, true };
+#endif // CLIPPERLIB_SIMD_AVX
+#ifdef CLIPPERLIB_SIMD_SSE2
+  case OffsetKernels::SSE2:
+#ifdef CLIPPERLIB_SIMD_NORMALS
+    return { UnitNormalsSSE2, true };
+#else
+    return { UnitNormalsScalar, true };
+#endif // CLIPPERLIB_SIMD_NORMALS
+#endif // CLIPPERLIB_SIMD_SSE2
+  default:
+    return { UnitNormalsScalar, false };
+  }
+}
+
+OffsetKernels ClipperOffset::DefaultKernels()
+{
+  return OffsetKernelsSupported(OffsetKernels::AVX)  ? OffsetKernels::AVX :
+         OffsetKernelsSupported(OffsetKernels::SSE2) ? OffsetKernels::SSE2 : OffsetKernels::Scalar;
+}
+
+bool ClipperOffset::SetKernels(OffsetKernels kernels)
+{
+  if (! OffsetKernelsSupported(kernels))
+    return false;
+  m_kernels = kernels;
+  return true;
+}
+
 //------------------------------------------------------------------------------
 // PolyTree methods ...
 //------------------------------------------------------------------------------
@@ -426,9 +620,9 @@ void ReversePolyPtLinks(OutPt *pp)
 }
 //------------------------------------------------------------------------------
 
+// The edge is expected to be zero initialized by ClipperBase::AllocateEdges().
 inline void InitEdge(TEdge* e, TEdge* eNext, TEdge* ePrev, const IntPoint& Pt)
 {
-  std::memset(e, 0, sizeof(TEdge));
   e->Next = eNext;
   e->Prev = ePrev;
   e->Curr = Pt;
@@ -766,8 +960,8 @@ bool ClipperBase::AddPath(const Path &pg, PolyType PolyTyp, bool Closed)
   if ((Closed && highI < 2) || (!Closed && highI < 1))
     return false;
 
-  // Allocate a new edge array.
-  Edges edges(highI + 1);
+  // Allocate a new edge array or recycle one released by Clear().
+  Edges edges = AllocateEdges(highI + 1);
   // Fill in the edge array.
   bool result = AddPathInternal(pg, highI, PolyTyp, Closed, edges.data());
   if (result)
@@ -959,6 +1153,9 @@ bool ClipperBase::AddPathInternal(const Path &pg, int highI, PolyType PolyTyp, b
 void ClipperBase::Clear()
 {
   m_MinimaList.clear();
+  // Keep the edge arrays for reuse.
+  for (Edges &edges : m_edges)
+    m_edges_free.emplace_back(std::move(edges));
   m_edges.clear();
 #ifndef CLIPPERLIB_INT32
   m_UseFullRange = false;
@@ -967,6 +1164,28 @@ void ClipperBase::Clear()
 }
 //------------------------------------------------------------------------------
 
+void ClipperBase::ReleaseBuffers()
+{
+  assert(m_edges.empty());
+  m_edges_free.clear();
+  m_edges_free.shrink_to_fit();
+  m_edges.shrink_to_fit();
+  m_MinimaList.shrink_to_fit();
+}
+//------------------------------------------------------------------------------
+
+ClipperBase::Edges ClipperBase::AllocateEdges(size_t num_edges)
+{
+  Edges edges;
+  if (! m_edges_free.empty()) {
+    edges = std::move(m_edges_free.back());
+    m_edges_free.pop_back();
+  }
+  edges.assign(num_edges, TEdge());
+  return edges;
+}
+//------------------------------------------------------------------------------
+
 // Initialize the Local Minima List:
 // Sort the LML entries, initialize the left / right bound edges of each Local Minima.
 void ClipperBase::Reset()
@@ -1042,6 +1261,7 @@ IntRect ClipperBase::GetBounds()
 Clipper::Clipper(int initOptions) : 
   ClipperBase(),
   m_OutPtsFree(nullptr),
+  m_OutPtsChunksUsed(0),
   m_OutPtsChunkLast(m_OutPtsChunkSize),
   m_ActiveEdges(nullptr),
   m_SortedEdges(nullptr)
@@ -1174,23 +1394,33 @@ OutPt* Clipper::AllocateOutPt()
     m_OutPtsFree = pt->Next;
   } else if (m_OutPtsChunkLast < m_OutPtsChunkSize) {
     // Get a point from the last chunk.
-    pt = &m_OutPts.back()[m_OutPtsChunkLast ++];
+    pt = &m_OutPts[m_OutPtsChunksUsed - 1][m_OutPtsChunkLast ++];
   } else {
-    // The last chunk is full. Allocate a new one.
-    m_OutPts.emplace_back();
+    // The last chunk is full. Reuse a chunk retained by DisposeAllOutRecs() or allocate a new one.
+    if (m_OutPtsChunksUsed == m_OutPts.size())
+      m_OutPts.emplace_back();
     m_OutPtsChunkLast = 1;
-    pt = &m_OutPts.back().front();
+    pt = &m_OutPts[m_OutPtsChunksUsed ++].front();
   }
   return pt;
 }
 
 void Clipper::DisposeAllOutRecs()
 {
-  m_OutPts.clear();
+  // Keep the chunks of output points for reuse.
+  m_OutPtsChunksUsed = 0;
   m_OutPtsFree = nullptr;
   m_OutPtsChunkLast = m_OutPtsChunkSize;
   m_PolyOuts.clear();
 }
+
+size_t Clipper::BuffersSize() const
+{
+  size_t out = m_OutPts.size() * sizeof(std::array<OutPt, m_OutPtsChunkSize>) + m_MinimaList.capacity() * sizeof(LocalMinimum);
+  for (const Edges &edges : m_edges_free)
+    out += edges.capacity() * sizeof(TEdge);
+  return out;
+}
 //------------------------------------------------------------------------------
 
 void Clipper::SetWindingCount(TEdge &edge) const
@@ -3338,23 +3568,6 @@ void Clipper::JoinCommonEdges()
   }
 }
 
-//------------------------------------------------------------------------------
-// ClipperOffset support functions ...
-//------------------------------------------------------------------------------
-
-DoublePoint GetUnitNormal(const IntPoint &pt1, const IntPoint &pt2)
-{
-  if(pt2.x() == pt1.x() && pt2.y() == pt1.y()) 
-    return DoublePoint(0, 0);
-
-  double Dx = double(pt2.x() - pt1.x());
-  double dy = double(pt2.y() - pt1.y());
-  double f = 1.0 / std::sqrt( Dx*Dx + dy*dy );
-  Dx *= f;
-  dy *= f;
-  return DoublePoint(dy, -Dx);
-}
-
 //------------------------------------------------------------------------------
 // ClipperOffset class
 //------------------------------------------------------------------------------
@@ -3368,6 +3581,28 @@ void ClipperOffset::Clear()
 }
 //------------------------------------------------------------------------------
 
+void ClipperOffset::ReleaseBuffers()
+{
+  assert(m_polyNodes.Childs.empty());
+  m_destPolys.clear();
+  m_destPolys.shrink_to_fit();
+  m_srcPoly.clear();
+  m_srcPoly.shrink_to_fit();
+  m_destPoly.clear();
+  m_destPoly.shrink_to_fit();
+  m_normals.clear();
+  m_normals.shrink_to_fit();
+  m_clipper.ReleaseBuffers();
+}
+//------------------------------------------------------------------------------
+
+size_t ClipperOffset::BuffersSize() const
+{
+  return m_clipper.BuffersSize() + m_destPolys.capacity() * sizeof(Path) +
+    (m_srcPoly.capacity() + m_destPoly.capacity()) * sizeof(IntPoint) + m_normals.capacity() * sizeof(DoublePoint);
+}
+//------------------------------------------------------------------------------
+
 void ClipperOffset::AddPath(const Path& path, JoinType joinType, EndType endType)
 {
   int highI = (int)path.size() - 1;
@@ -3465,7 +3700,7 @@ void ClipperOffset::Execute(Paths& solution, double delta)
   DoOffset(delta);
   
   //now clean up 'corners' ...
-  Clipper clpr;
+  Clipper &clpr = m_clipper;
   clpr.AddPaths(m_destPolys, ptSubject, true);
   if (delta > 0)
   {
@@ -3486,6 +3721,9 @@ void ClipperOffset::Execute(Paths& solution, double delta)
     if (! solution.empty())
       solution.erase(solution.begin());
   }
+  // Keep the buffers of the union engine for the next Execute().
+  clpr.Clear();
+  clpr.ReverseSolution(false);
 }
 //------------------------------------------------------------------------------
 
@@ -3496,7 +3734,7 @@ void ClipperOffset::Execute(PolyTree& solution, double delta)
   DoOffset(delta);
 
   //now clean up 'corners' ...
-  Clipper clpr;
+  Clipper &clpr = m_clipper;
   clpr.AddPaths(m_destPolys, ptSubject, true);
   if (delta > 0)
   {
@@ -3517,6 +3755,8 @@ void ClipperOffset::Execute(PolyTree& solution, double delta)
     //remove the outer PolyNode rectangle ...
     solution.RemoveOutermostPolygon();
   }
+  clpr.Clear();
+  clpr.ReverseSolution(false);
 }
 //------------------------------------------------------------------------------
 
@@ -3600,14 +3840,12 @@ void ClipperOffset::DoOffset(double delta)
       continue;
     }
     //build m_normals ...
-    m_normals.clear();
-    m_normals.reserve(len);
-    for (int j = 0; j < len - 1; ++j)
-      m_normals.emplace_back(GetUnitNormal(m_srcPoly[j], m_srcPoly[j + 1]));
+    m_normals.resize(len);
+    simd_kernels(m_kernels).unit_normals(m_srcPoly.data(), len - 1, m_normals.data());
     if (node.m_endtype == etClosedLine || node.m_endtype == etClosedPolygon)
-      m_normals.emplace_back(GetUnitNormal(m_srcPoly[len - 1], m_srcPoly[0]));
+      m_normals[len - 1] = GetUnitNormal(m_srcPoly[len - 1], m_srcPoly[0]);
     else
-      m_normals.emplace_back(DoublePoint(m_normals[len - 2]));
+      m_normals[len - 1] = m_normals[len - 2];
 
     if (node.m_endtype == etClosedPolygon)
     {
@@ -3761,15 +3999,35 @@ void ClipperOffset::DoRound(int j, int k)
   m_normals[k].x() * m_normals[j].x() + m_normals[k].y() * m_normals[j].y());
   auto steps = std::max<int>(Round<cInt>(m_StepsPerRad * std::fabs(a)), 1);
 
-  double X = m_normals[k].x(), Y = m_normals[k].y(), X2;
-  for (int i = 0; i < steps; ++i)
+#ifdef CLIPPERLIB_SIMD_SSE2
+  if (simd_kernels(m_kernels).round_sse2) {
+    // The (X, Y) pair of the scalar code below rotated in a single register:
+    // X * cos - sin * Y == X * cos + Y * (-sin) and X * sin + Y * cos are evaluated exactly.
+    const __m128d cos_sin  = _mm_set_pd(m_sin, m_cos);
+    const __m128d msin_cos = _mm_set_pd(m_cos, - m_sin);
+    const __m128d delta    = _mm_set1_pd(m_delta);
+    const __m128d pt       = _mm_set_pd(double(m_srcPoly[j].y()), double(m_srcPoly[j].x()));
+    __m128d       XY       = _mm_loadu_pd(m_normals[k].data());
+    for (int i = 0; i < steps; ++i)
+    {
+      double p[2];
+      _mm_storeu_pd(p, _mm_add_pd(pt, _mm_mul_pd(XY, delta)));
+      m_destPoly.emplace_back(IntPoint2d(Round<cInt>(p[0]), Round<cInt>(p[1])));
+      XY = _mm_add_pd(_mm_mul_pd(_mm_unpacklo_pd(XY, XY), cos_sin), _mm_mul_pd(_mm_unpackhi_pd(XY, XY), msin_cos));
+    }
+  } else
+#endif // CLIPPERLIB_SIMD_SSE2
   {
-    m_destPoly.emplace_back(IntPoint2d(
-        Round<cInt>(m_srcPoly[j].x() + X * m_delta),
-        Round<cInt>(m_srcPoly[j].y() + Y * m_delta)));
-    X2 = X;
-    X = X * m_cos - m_sin * Y;
-    Y = X2 * m_sin + Y * m_cos;
+    double X = m_normals[k].x(), Y = m_normals[k].y(), X2;
+    for (int i = 0; i < steps; ++i)
+    {
+      m_destPoly.emplace_back(IntPoint2d(
+          Round<cInt>(m_srcPoly[j].x() + X * m_delta),
+          Round<cInt>(m_srcPoly[j].y() + Y * m_delta)));
+      X2 = X;
+      X = X * m_cos - m_sin * Y;
+      Y = X2 * m_sin + Y * m_cos;
+    }
   }
   m_destPoly.emplace_back(IntPoint2d(
   Round<cInt>(m_srcPoly[j].x() + m_normals[j].x() * m_delta),
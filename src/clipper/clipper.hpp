@@ -357,8 +357,8 @@ public:
     if (num_edges_total == 0)
       return false;
 
-    // Allocate a new edge array.
-    std::vector<TEdge, Allocator<TEdge>> edges(num_edges_total);
+    // Allocate a new edge array or recycle one released by Clear().
+    Edges edges = AllocateEdges(num_edges_total);
     // Fill in the edge array.
     bool result = false;
     TEdge *p_edge = edges.data();
@@ -379,7 +379,11 @@ public:
     return result;
   }
 
+  // Clear the paths. Buffers allocated for the edges are retained to be reused by the next AddPath() / AddPaths() calls,
+  // they are released by ReleaseBuffers() or by the destructor.
   void Clear();
+  // Release the buffers retained by Clear() for reuse.
+  void ReleaseBuffers();
   IntRect GetBounds();
   // By default, when three or more vertices are collinear in input polygons (subject or clip), the Clipper object removes the 'inner' vertices before clipping.
   // When enabled the PreserveCollinear property prevents this default behavior to allow these inner vertices to appear in the solution.
@@ -407,6 +411,9 @@ protected:
   // A vector of edges per each input path.
   using Edges = std::vector<TEdge, Allocator<TEdge>>;
   std::vector<Edges, Allocator<Edges>> m_edges;
+  // Edge arrays released by Clear(), to be recycled by AllocateEdges().
+  std::vector<Edges, Allocator<Edges>> m_edges_free;
+  Edges AllocateEdges(size_t num_edges);
   // Don't remove intermediate vertices of a collinear sequence of points.
   bool             m_PreserveCollinear;
   // Is any of the paths inserted by AddPath() or AddPaths() open?
@@ -419,7 +426,13 @@ class Clipper : public ClipperBase
 public:
   Clipper(int initOptions = 0);
   ~Clipper() { Clear(); }
+  // Clear the paths and the output, keep the allocated buffers for reuse by the next Execute(),
+  // so that a single Clipper may be used for many small boolean operations efficiently.
   void Clear() { ClipperBase::Clear(); DisposeAllOutRecs(); }
+  // Release the buffers retained for reuse. Only valid for a cleared Clipper.
+  void ReleaseBuffers() { ClipperBase::ReleaseBuffers(); m_OutPts.clear(); m_OutPts.shrink_to_fit(); m_PolyOuts.shrink_to_fit(); }
+  // Approximate number of bytes held by the buffers retained for reuse.
+  size_t BuffersSize() const;
   bool Execute(ClipType clipType,
       Paths &solution,
       PolyFillType fillType = pftEvenOdd) 
@@ -456,6 +469,8 @@ private:
   std::deque<std::array<OutPt, m_OutPtsChunkSize>, Allocator<std::array<OutPt, m_OutPtsChunkSize>>> m_OutPts;
   // List of free output points, to be used before taking a point from m_OutPts or allocating a new chunk.
   OutPt                *m_OutPtsFree;
+  // Number of chunks of m_OutPts in use, the chunks above are retained for reuse.
+  size_t                m_OutPtsChunksUsed;
   size_t                m_OutPtsChunkLast;
 
   std::vector<Join, Allocator<Join>>     m_Joins;
@@ -535,11 +550,15 @@ private:
 };
 //------------------------------------------------------------------------------
 
+// Kernels of ClipperOffset calculating the segment normals and the round joins.
+// The vectorized kernels produce results bit identical to the scalar kernels.
+enum class OffsetKernels { Scalar, SSE2, AVX };
+
 class ClipperOffset 
 {
 public:
   ClipperOffset(double miterLimit = 2.0, double roundPrecision = 0.25, double shortestEdgeLength = 0.) :
-    MiterLimit(miterLimit), ArcTolerance(roundPrecision), ShortestEdgeLength(shortestEdgeLength), m_lowest(-1, 0) {}
+    MiterLimit(miterLimit), ArcTolerance(roundPrecision), ShortestEdgeLength(shortestEdgeLength), m_lowest(-1, 0), m_kernels(DefaultKernels()) {}
   ~ClipperOffset() { Clear(); }
   void AddPath(const Path& path, JoinType joinType, EndType endType);
   template<typename PathsProvider>
@@ -549,7 +568,18 @@ public:
   }
   void Execute(Paths& solution, double delta);
   void Execute(PolyTree& solution, double delta);
+  // Clear the paths. The buffers of the offsetter and of its union engine are retained for reuse by the next Execute().
   void Clear();
+  // Release the buffers retained for reuse. Only valid for a cleared ClipperOffset.
+  void ReleaseBuffers();
+  // Approximate number of bytes held by the buffers retained for reuse.
+  size_t BuffersSize() const;
+  // Select the kernels of this offsetter, by default the fastest kernels supported by the CPU are used.
+  // Returns false if the kernels are not supported by the build or by the CPU, the selection is not changed then.
+  bool SetKernels(OffsetKernels kernels);
+  OffsetKernels Kernels() const { return m_kernels; }
+  // The fastest kernels supported by the CPU the process runs on.
+  static OffsetKernels DefaultKernels();
   double MiterLimit;
   double ArcTolerance;
   double ShortestEdgeLength;
@@ -565,6 +595,9 @@ private:
   // y: index of the lowest point in the lowest contour
   IntPoint m_lowest;
   PolyNode m_polyNodes;
+  // Engine to clean up the offsetted contours, reused by subsequent Execute() calls.
+  Clipper m_clipper;
+  OffsetKernels m_kernels;
 
   void FixOrientations();
   void DoOffset(double delta);
@@ -11,10 +11,18 @@
 #define slic3r_AABBTreeIndirect_hpp_
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
 #include <limits>
 #include <type_traits>
 #include <vector>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    // Ray packets are tested against bounding boxes four rays at a time, see detail::RayPacket.
+    #define SLIC3R_AABB_RAY_PACKET_SSE2
+    #include <emmintrin.h>
+#endif
+
 #include <Eigen/Geometry>
 
 #include "BoundingBox.hpp"
@@ -474,6 +482,107 @@ namespace detail {
 		}
 	}
 
+	// Next node of a depth first traversal of the implicit balanced tree, once the subtree of node_idx has been processed
+	// or skipped. As the parent and the sibling of a node are addressed by the power of two rule, no stack is needed:
+	// Left children have odd indices, their right sibling follows, right children return to their parent.
+	// Returns zero (the root) if the traversal is finished.
+	inline size_t next_node_stackless(size_t node_idx)
+	{
+		for (; node_idx != 0; node_idx = (node_idx - 1) / 2)
+			if (node_idx & 1)
+				return node_idx + 1;
+		return 0;
+	}
+
+	// Packet of rays traversing the AABB tree together, stored as a structure of arrays of floats
+	// to let the compiler vectorize the ray / box tests over the whole packet.
+	// The ray / box tests are conservative: The float slab intervals are widened by a bound of the rounding error,
+	// thus a box may be entered that the exact test would reject, but no box is skipped that the exact test would enter.
+	// The ray / triangle tests are done with the accuracy of the input rays, thus the hits are the same as of the single ray queries.
+	template<size_t PacketSize>
+	struct RayPacket {
+		static_assert(PacketSize > 0 && PacketSize <= 32, "Ray packet must fit a 32 bit mask");
+		alignas(16) std::array<float, PacketSize> origin[3];
+		alignas(16) std::array<float, PacketSize> invdir[3];
+		// Bound of the rounding error of the ray parameter calculated by intersect_box() for each axis.
+		alignas(16) std::array<float, PacketSize> error[3];
+		// Parameter of the closest hit found so far, infinity if not hit yet, negative for rays not in the packet.
+		alignas(16) std::array<float, PacketSize> min_t;
+
+		// max_coord is the maximum absolute value of a bounding box coordinate of the tree.
+		template<typename VectorType>
+		void set_ray(size_t i, const VectorType &origin, const VectorType &dir, float max_coord) {
+			if (! origin.allFinite() || ! dir.allFinite()) {
+				// Degenerate ray, for example shot along a normal of a degenerate triangle. It does not hit anything,
+				// while the NaNs ignored by intersect_box() would make the whole tree to be traversed.
+				this->set_empty(i);
+				return;
+			}
+			for (int axis = 0; axis < 3; ++ axis) {
+				this->origin[axis][i] = float(origin[axis]);
+				this->invdir[axis][i] = float(1. / double(dir[axis]));
+				// Rounding of the origin, of the inverse direction, of the subtraction and of the multiplication
+				// with a safety factor. Infinite for rays parallel with the axis, then the axis does not limit the ray.
+				this->error[axis][i]  = 4.f * std::numeric_limits<float>::epsilon() *
+					(2.f * std::abs(this->origin[axis][i]) + max_coord) * std::abs(this->invdir[axis][i]);
+			}
+			this->min_t[i] = std::numeric_limits<float>::infinity();
+		}
+		// Ray not in the packet, misses everything as it ends before it starts.
+		void set_empty(size_t i) {
+			for (int axis = 0; axis < 3; ++ axis)
+				this->origin[axis][i] = this->invdir[axis][i] = this->error[axis][i] = 0.f;
+			this->min_t[i] = -1.f;
+		}
+
+		// Mark the rays of the packet, whose ray segment <0, min_t) may intersect the box, with bits of the returned mask.
+		template<typename BoxScalar>
+		uint32_t intersect_box(const Eigen::AlignedBox<BoxScalar, 3> &box) const {
+#ifdef SLIC3R_AABB_RAY_PACKET_SSE2
+			if constexpr (PacketSize % 4 == 0) {
+				uint32_t mask = 0;
+				for (size_t i = 0; i < PacketSize; i += 4) {
+					const __m128 packet_min_t = _mm_load_ps(min_t.data() + i);
+					__m128 tmin = _mm_setzero_ps();
+					__m128 tmax = packet_min_t;
+					for (int axis = 0; axis < 3; ++ axis) {
+						const __m128 o   = _mm_load_ps(origin[axis].data() + i);
+						const __m128 inv = _mm_load_ps(invdir[axis].data() + i);
+						const __m128 err = _mm_load_ps(error[axis].data() + i);
+						const __m128 t0  = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(float(box.min()[axis])), o), inv);
+						const __m128 t1  = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(float(box.max()[axis])), o), inv);
+						// _mm_min_ps / _mm_max_ps return the second operand if any is NaN, thus NaNs are ignored as in the scalar code below.
+						tmin = _mm_max_ps(_mm_sub_ps(_mm_min_ps(t0, t1), err), tmin);
+						tmax = _mm_min_ps(_mm_add_ps(_mm_max_ps(t0, t1), err), tmax);
+					}
+					const __m128 hit = _mm_and_ps(_mm_and_ps(_mm_cmple_ps(tmin, tmax), _mm_cmplt_ps(tmin, packet_min_t)), _mm_cmpgt_ps(tmax, _mm_setzero_ps()));
+					mask |= uint32_t(_mm_movemask_ps(hit)) << i;
+				}
+				return mask;
+			}
+#endif // SLIC3R_AABB_RAY_PACKET_SSE2
+			std::array<float, PacketSize> tmin, tmax;
+			tmin.fill(0.f);
+			tmax = min_t;
+			for (int axis = 0; axis < 3; ++ axis) {
+				const float bmin = float(box.min()[axis]);
+				const float bmax = float(box.max()[axis]);
+				for (size_t i = 0; i < PacketSize; ++ i) {
+					const float t0 = (bmin - origin[axis][i]) * invdir[axis][i];
+					const float t1 = (bmax - origin[axis][i]) * invdir[axis][i];
+					// NaN (zero times infinity) is ignored by the min / max below, which is conservative.
+					tmin[i] = std::max(tmin[i], std::min(t0, t1) - error[axis][i]);
+					tmax[i] = std::min(tmax[i], std::max(t0, t1) + error[axis][i]);
+				}
+			}
+			uint32_t mask = 0;
+			for (size_t i = 0; i < PacketSize; ++ i)
+				if (tmin[i] <= tmax[i] && tmin[i] < min_t[i] && tmax[i] > 0.f)
+					mask |= uint32_t(1) << i;
+			return mask;
+		}
+	};
+
     // Real-time collision detection, Ericson, Chapter 5
     template<typename Vector>
     static inline Vector closest_point_to_triangle(const Vector &p, const Vector &a, const Vector &b, const Vector &c)
@@ -791,6 +900,78 @@ inline bool intersect_ray_all_hits(
 	return ! hits.empty();
 }
 
+// Number of rays traced together by intersect_ray_packet_first_hit(), if not specified otherwise.
+static constexpr size_t RayPacketSize = 8;
+
+// Find the first intersections of a packet of rays with indexed triangle set, returning the same hits
+// as intersect_ray_first_hit() would for each ray separately.
+// The rays descend the tree together, which pays off for coherent rays, such as rays shot from a common origin
+// into a hemisphere. The bounding boxes are tested for all rays of the packet at once in single precision
+// and the tree is traversed without a stack nor recursion.
+// Only the first num_rays rays of the packet are traced, hits[i].id is set to -1 for rays not hitting anything.
+// Returns true if any of the rays hit the indexed triangle set.
+template<size_t PacketSize = RayPacketSize, typename VertexType, typename IndexedFaceType, typename TreeType, typename VectorType>
+inline bool intersect_ray_packet_first_hit(
+	// Indexed triangle set - 3D vertices.
+	const std::vector<VertexType> 		    &vertices,
+	// Indexed triangle set - triangular faces, references to vertices.
+	const std::vector<IndexedFaceType> 	    &faces,
+	// AABBTreeIndirect::Tree over vertices & faces, bounding boxes built with the accuracy of vertices.
+	const TreeType 						    &tree,
+	// Origins of the rays.
+	const std::array<VectorType, PacketSize> &origins,
+	// Directions of the rays.
+	const std::array<VectorType, PacketSize> &dirs,
+	// Number of valid rays at the start of origins / dirs, at most PacketSize.
+	const size_t                             num_rays,
+	// First intersections of the rays with the indexed triangle set.
+	std::array<igl::Hit, PacketSize>        &hits,
+	// Epsilon for the ray-triangle intersection, it should be proportional to an average triangle edge length.
+	const double 						     eps = 0.000001)
+{
+	assert(num_rays <= PacketSize);
+	for (igl::Hit &hit : hits)
+		hit.id = -1;
+	if (tree.empty() || num_rays == 0)
+		return false;
+
+	const auto &root_bbox = tree.node(0).bbox;
+	const float max_coord = float(std::max(root_bbox.min().cwiseAbs().maxCoeff(), root_bbox.max().cwiseAbs().maxCoeff()));
+	detail::RayPacket<PacketSize> packet;
+	for (size_t i = 0; i < PacketSize; ++ i)
+		if (i < num_rays)
+			packet.set_ray(i, origins[i], dirs[i], max_coord);
+		else
+			packet.set_empty(i);
+
+	bool    any_hit  = false;
+	size_t  node_idx = 0;
+	do {
+		const auto &node = tree.node(node_idx);
+		assert(node.is_valid());
+		if (uint32_t mask = packet.intersect_box(node.bbox); mask == 0) {
+			// Skip the subtree.
+			node_idx = detail::next_node_stackless(node_idx);
+		} else if (node.is_leaf()) {
+            auto face = faces[node.idx];
+			for (size_t i = 0; i < num_rays; ++ i)
+				if (mask & (uint32_t(1) << i)) {
+				    double t, u, v;
+				    if (detail::intersect_triangle(origins[i], dirs[i], vertices[face(0)], vertices[face(1)], vertices[face(2)], t, u, v, eps) &&
+				    	t > 0. && float(t) < packet.min_t[i]) {
+		                hits[i] = igl::Hit { int(node.idx), -1, float(u), float(v), float(t) };
+						packet.min_t[i] = hits[i].t;
+						any_hit = true;
+					}
+				}
+			node_idx = detail::next_node_stackless(node_idx);
+		} else
+			// Descend into the left child first, as intersect_ray_recursive_first_hit() does.
+			node_idx = TreeType::left_child_idx(node_idx);
+	} while (node_idx != 0);
+	return any_hit;
+}
+
 // Finding a closest triangle, its closest point and squared distance to the closest point
 // on a 3D indexed triangle set using a pre-built AABBTreeIndirect::Tree.
 // Closest point to triangle test will be performed with the accuracy of VectorType::Scalar
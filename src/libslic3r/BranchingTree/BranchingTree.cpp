@@ -30,6 +30,19 @@ void build_tree(PointCloud &nodes, Builder &builder)
         float  dst_euql      = NaNf;
     };
     auto distances = reserve_vector<NodeDistance>(initK);
+
+    struct Candidate
+    {
+        size_t closest_node_id;
+        Node   closest_node;
+        size_t conn_idx = 0;
+
+        // The closest node is a bed point too far for a ground bridge, a
+        // detour suggested by the builder is tried instead.
+        bool avoid = false;
+    };
+    std::vector<Candidate>  candidates;
+    std::vector<Connection> connections;
     double prev_dist_max = 0.;
     size_t K = initK;
     bool   routed = true;
@@ -70,47 +83,33 @@ void build_tree(PointCloud &nodes, Builder &builder)
         prev_dist_max = dmax;
         K *= 2;
 
-        auto closest_it = distances.begin();
-        routed = false;
-        while (closest_it != distances.end() && !routed && builder.is_valid()) {
-            size_t closest_node_id = closest_it->node_id;
-            Node closest_node = nodes.get(closest_node_id);
+        // Assemble the candidate connections first, so that the builder can
+        // check all of them at once. Nothing is modified until a connection
+        // is added, thus the candidates don't depend on each other.
+        candidates.clear();
+        connections.clear();
+        for (const NodeDistance &nd : distances) {
+            Candidate cand{nd.node_id, nodes.get(nd.node_id)};
+            Node &closest_node = cand.closest_node;
 
-            auto type = nodes.get_type(closest_node_id);
-            float w = nodes.get(node_id).weight + closest_it->dst_branching;
+            float w = nodes.get(node_id).weight + nd.dst_branching;
             closest_node.Rmin = std::max(node.Rmin, closest_node.Rmin);
 
-            switch (type) {
+            std::optional<Connection> conn;
+            switch (nodes.get_type(nd.node_id)) {
             case BED: {
                 closest_node.weight = w;
-                double max_br_len   = nodes.properties().max_branch_length();
-                if (closest_it->dst_branching > max_br_len) {
-                    std::optional<Vec3f> avo = builder.suggest_avoidance(node, max_br_len);
-                    if (!avo)
-                        break;
-
-                    Node new_node {*avo, node.Rmin};
-                    new_node.weight = nodes.get(node_id).weight + (node.pos - *avo).norm();
-                    new_node.left   = node.id;
-                    if ((routed = builder.add_bridge(node, new_node))) {
-                        size_t new_idx = nodes.insert_junction(new_node);
-                        ptsqueue.push(new_idx);
-                    }
-                } else if ((routed = builder.add_ground_bridge(node, closest_node))) {
-                    closest_node.left = closest_node.right = node_id;
-                    nodes.get(closest_node_id) = closest_node;
-                    nodes.mark_unreachable(closest_node_id);
-                }
+                double max_br_len   = properties.max_branch_length();
+                if (nd.dst_branching > max_br_len)
+                    cand.avoid = true;
+                else
+                    conn = Connection{Connection::GroundBridge, node, closest_node};
 
                 break;
             }
             case MESH: {
                 closest_node.weight = w;
-                if ((routed = builder.add_mesh_bridge(node, closest_node))) {
-                    closest_node.left = closest_node.right = node_id;
-                    nodes.get(closest_node_id) = closest_node;
-                    nodes.mark_unreachable(closest_node_id);
-                }
+                conn = Connection{Connection::MeshBridge, node, closest_node};
 
                 break;
             }
@@ -123,7 +122,7 @@ void build_tree(PointCloud &nodes, Builder &builder)
                     float mergedist_closest = (*mergept - closest_node.pos).norm();
                     float mergedist_node = (*mergept - node.pos).norm();
                     float Wnode = nodes.get(node_id).weight;
-                    float Wclosest = nodes.get(closest_node_id).weight;
+                    float Wclosest = nodes.get(nd.node_id).weight;
                     float Wsum = std::max(Wnode, Wclosest);
                     float distsum = std::max(mergedist_closest, mergedist_node);
                     w = Wsum + distsum;
@@ -133,30 +132,12 @@ void build_tree(PointCloud &nodes, Builder &builder)
                         mergenode.weight = w;
                         mergenode.id = int(nodes.next_junction_id());
 
-                        if ((routed = builder.add_merger(node, closest_node, mergenode))) {
-                            mergenode.left = node_id;
-                            mergenode.right = closest_node_id;
-                            size_t new_idx = nodes.insert_junction(mergenode);
-                            ptsqueue.push(new_idx);
-                            size_t qid = nodes.get_queue_idx(closest_node_id);
-
-                            if (qid != PointCloud::Unqueued)
-                                ptsqueue.remove(nodes.get_queue_idx(closest_node_id));
-
-                            nodes.mark_unreachable(closest_node_id);
-                        }
+                        conn = Connection{Connection::Merger, node, closest_node, mergenode};
                     } else if (closest_node.pos.z() < node.pos.z() &&
                                (closest_node.left == Node::ID_NONE ||
                                 closest_node.right == Node::ID_NONE)) {
                         closest_node.weight = w;
-                        if ((routed = builder.add_bridge(node, closest_node))) {
-                            if (closest_node.left == Node::ID_NONE)
-                                closest_node.left = node_id;
-                            else if (closest_node.right == Node::ID_NONE)
-                                closest_node.right = node_id;
-
-                            nodes.get(closest_node_id) = closest_node;
-                        }
+                        conn = Connection{Connection::Bridge, node, closest_node};
                     }
                 }
 
@@ -165,7 +146,86 @@ void build_tree(PointCloud &nodes, Builder &builder)
             case NONE:;
             }
 
-            ++closest_it;
+            if (conn) {
+                cand.conn_idx = connections.size();
+                connections.emplace_back(*conn);
+            }
+
+            if (conn || cand.avoid)
+                candidates.emplace_back(cand);
+        }
+
+        std::vector<bool> feasible = builder.check_connections(connections);
+
+        auto cand_it = candidates.begin();
+        routed = false;
+        while (cand_it != candidates.end() && !routed && builder.is_valid()) {
+            size_t closest_node_id = cand_it->closest_node_id;
+            Node closest_node = cand_it->closest_node;
+
+            if (cand_it->avoid) {
+                double max_br_len = properties.max_branch_length();
+                std::optional<Vec3f> avo = builder.suggest_avoidance(node, max_br_len);
+                if (avo) {
+                    Node new_node {*avo, node.Rmin};
+                    new_node.weight = nodes.get(node_id).weight + (node.pos - *avo).norm();
+                    new_node.left   = node.id;
+                    if ((routed = builder.add_bridge(node, new_node))) {
+                        size_t new_idx = nodes.insert_junction(new_node);
+                        ptsqueue.push(new_idx);
+                    }
+                }
+            } else if (feasible[cand_it->conn_idx]) {
+                const Connection &conn = connections[cand_it->conn_idx];
+
+                switch (conn.type) {
+                case Connection::GroundBridge:
+                case Connection::MeshBridge: {
+                    routed = conn.type == Connection::GroundBridge ?
+                                 builder.add_ground_bridge(node, closest_node) :
+                                 builder.add_mesh_bridge(node, closest_node);
+
+                    if (routed) {
+                        closest_node.left = closest_node.right = node_id;
+                        nodes.get(closest_node_id) = closest_node;
+                        nodes.mark_unreachable(closest_node_id);
+                    }
+
+                    break;
+                }
+                case Connection::Merger: {
+                    Node mergenode = conn.merge_node;
+                    if ((routed = builder.add_merger(node, closest_node, mergenode))) {
+                        mergenode.left = node_id;
+                        mergenode.right = closest_node_id;
+                        size_t new_idx = nodes.insert_junction(mergenode);
+                        ptsqueue.push(new_idx);
+                        size_t qid = nodes.get_queue_idx(closest_node_id);
+
+                        if (qid != PointCloud::Unqueued)
+                            ptsqueue.remove(nodes.get_queue_idx(closest_node_id));
+
+                        nodes.mark_unreachable(closest_node_id);
+                    }
+
+                    break;
+                }
+                case Connection::Bridge: {
+                    if ((routed = builder.add_bridge(node, closest_node))) {
+                        if (closest_node.left == Node::ID_NONE)
+                            closest_node.left = node_id;
+                        else if (closest_node.right == Node::ID_NONE)
+                            closest_node.right = node_id;
+
+                        nodes.get(closest_node_id) = closest_node;
+                    }
+
+                    break;
+                }
+                }
+            }
+
+            ++cand_it;
         }
 
         if (routed) {
@@ -93,6 +93,19 @@ inline bool is_occupied(const Node &n)
     return n.left != Node::ID_NONE && n.right != Node::ID_NONE;
 }
 
+// A candidate connection of a node to be tried by the tree building algorithm,
+// corresponding to one of the add_* methods of the Builder below.
+struct Connection
+{
+    enum Type { Bridge, Merger, GroundBridge, MeshBridge };
+
+    Type type;
+    Node from, to;
+
+    // The junction where 'from' and 'to' meet, used only by Merger
+    Node merge_node{Vec3f::Zero()};
+};
+
 // An output interface for the branching tree generator function. Consider each
 // method as a callback and implement the actions that need to be done.
 class Builder
@@ -100,6 +113,17 @@ class Builder
 public:
     virtual ~Builder() = default;
 
+    // Called with the candidate connections of a node before they are tried
+    // one by one with the add_* methods, in the given order, until one of
+    // them succeeds. Returns false for each connection that would surely be
+    // refused, these are not tried at all. An implementation can check the
+    // candidates concurrently and keep the results for the add_* calls that
+    // follow. By default, every candidate is tried.
+    virtual std::vector<bool> check_connections(const std::vector<Connection> &conns)
+    {
+        return std::vector<bool>(conns.size(), true);
+    }
+
     // A simple bridge from junction to junction.
     virtual bool add_bridge(const Node &from, const Node &to) = 0;
 
@@ -206,13 +206,19 @@ public:
     const std::vector<Node> &get_leafs() const noexcept      { return m_leafs; }
     const Properties & properties() const noexcept { return m_props; }
 
+    // Unreachable nodes are also removed from the spatial index, so that the
+    // queries don't need to wade through the already connected nodes.
     void mark_unreachable(size_t node_id)
     {
         assert(node_id < m_searchable_indices.size());
 
-        m_searchable_indices[node_id] = false;
         m_queue_indices[node_id] = Unqueued;
-        --m_reachable_cnt;
+
+        if (m_searchable_indices[node_id]) {
+            m_searchable_indices[node_id] = false;
+            m_ktree.remove(PointIndexEl{get(node_id).pos, unsigned(node_id)});
+            --m_reachable_cnt;
+        }
     }
 
     size_t reachable_count() const { return m_reachable_cnt; }
@@ -7,6 +7,10 @@
 
 #include <functional>
 #include <stack>
+#include <vector>
+#include <algorithm>
+
+#include <boost/functional/hash.hpp>
 
 #include "CSGMesh.hpp"
 #include "libslic3r/OpenVDBUtils.hpp"
@@ -58,37 +62,142 @@ inline void perform_csg(CSGType op, VoxelGridPtr &dst, VoxelGridPtr &src)
 
 } // namespace detail
 
-// Convert the input csgrange to a voxel grid performing the boolean operations in the voxel realm.
-template<class It>
-VoxelGridPtr voxelize_csgmesh(const Range<It>      &csgrange,
-                              const VoxelizeParams &params = {})
-{
-    using namespace detail;
+// Cache of the voxel grids of csg parts, to be kept between successive
+// voxelize_csgmesh() calls. A part is voxelized again only if its mesh, its
+// transformation or the voxelization parameters have changed. One partial
+// result of the csg operations is kept as well: at the first part that
+// changed in the previous call, as the next edit is likely to be there too
+// (e.g. when a drain hole is moved or added).
+class VoxelGridCache {
+public:
+    struct PartKey {
+        size_t      mesh_hash = 0;
+        Transform3f trafo     = Transform3f::Identity();
+        float       voxel_scale = 0.f;
+        float       exterior_bandwidth = 0.f;
+        float       interior_bandwidth = 0.f;
 
-    VoxelGridPtr ret;
+        bool operator==(const PartKey &other) const
+        {
+            return mesh_hash == other.mesh_hash &&
+                   trafo.matrix() == other.trafo.matrix() &&
+                   voxel_scale == other.voxel_scale &&
+                   exterior_bandwidth == other.exterior_bandwidth &&
+                   interior_bandwidth == other.interior_bandwidth;
+        }
+    };
 
-    std::vector<VoxelGridPtr> grids (csgrange.size());
+    struct SequenceKey {
+        PartKey    part;
+        CSGType    op      = CSGType::Union;
+        CSGStackOp stackop = CSGStackOp::Continue;
 
-    execution::for_each(ex_tbb, size_t(0), csgrange.size(), [&](size_t csgidx) {
-        if (params.statusfn() && params.statusfn()(-1))
-            return;
+        bool operator==(const SequenceKey &other) const
+        {
+            return part == other.part && op == other.op && stackop == other.stackop;
+        }
+    };
 
-        auto it = csgrange.begin();
-        std::advance(it, csgidx);
-        auto &csgpart = *it;
-        grids[csgidx] = get_voxelgrid(csgpart, params);
-    }, execution::max_concurrency(ex_tbb));
+    template<class CSGPartT>
+    static SequenceKey make_key(const CSGPartT &csgpart, const VoxelizeParams &params)
+    {
+        SequenceKey ret;
+        if (const indexed_triangle_set *its = csg::get_mesh(csgpart))
+            ret.part.mesh_hash = mesh_hash(*its);
+
+        ret.part.trafo              = params.trafo() * csg::get_transform(csgpart);
+        ret.part.voxel_scale        = params.voxel_scale();
+        ret.part.exterior_bandwidth = params.exterior_bandwidth();
+        ret.part.interior_bandwidth = params.interior_bandwidth();
+        ret.op                      = csg::get_operation(csgpart);
+        ret.stackop                 = csg::get_stack_operation(csgpart);
+
+        return ret;
+    }
+
+    static size_t mesh_hash(const indexed_triangle_set &its)
+    {
+        size_t seed = 0;
+        boost::hash_combine(seed, its.vertices.size());
+        for (const Vec3f &v : its.vertices)
+            for (int c = 0; c < 3; ++c)
+                boost::hash_combine(seed, v(c));
+
+        for (const stl_triangle_vertex_indices &f : its.indices)
+            for (int c = 0; c < 3; ++c)
+                boost::hash_combine(seed, f(c));
 
-    size_t csgidx = 0;
+        return seed;
+    }
+
+    // The cached grid of a part or nullptr if the part was not voxelized yet.
+    const VoxelGrid *find(const PartKey &key) const
+    {
+        auto it = std::find_if(m_grids.begin(), m_grids.end(),
+                               [&key](const Entry &e) { return e.key == key; });
+
+        return it != m_grids.end() ? it->grid.get() : nullptr;
+    }
+
+    void clear()
+    {
+        m_grids.clear();
+        m_sequence.clear();
+        m_partial.reset();
+        m_partial_pos = 0;
+    }
+
+private:
+    template<class It>
+    friend VoxelGridPtr voxelize_csgmesh(const Range<It> &,
+                                         const VoxelizeParams &,
+                                         VoxelGridCache &);
+
+    struct Entry {
+        PartKey      key;
+        VoxelGridPtr grid;
+    };
+
+    std::vector<Entry>       m_grids;
+    std::vector<SequenceKey> m_sequence;
+
+    // The result of the csg operations of the first m_partial_pos parts.
+    VoxelGridPtr m_partial;
+    size_t       m_partial_pos = 0;
+};
+
+namespace detail {
+
+// Perform the csg operations of the parts from startidx to the end of
+// csgrange. The grids of the parts are consumed. The result of the parts
+// preceding startidx can be given in startgrid. The partialfn is called with
+// the index of a part and the current result before the part is processed,
+// if the part is not inside a pushed sub-expression.
+template<class It, class PartialFn>
+VoxelGridPtr perform_csg_sequence(const Range<It>           &csgrange,
+                                  std::vector<VoxelGridPtr> &grids,
+                                  const VoxelizeParams      &params,
+                                  size_t                     startidx,
+                                  VoxelGridPtr               startgrid,
+                                  PartialFn                &&partialfn)
+{
+    size_t csgidx = startidx;
     struct Frame { CSGType op = CSGType::Union; VoxelGridPtr grid; };
     std::stack opstack{std::vector<Frame>{}};
 
-    opstack.push({CSGType::Union, mesh_to_grid({}, params)});
+    opstack.push({CSGType::Union,
+                  startgrid ? std::move(startgrid) : mesh_to_grid({}, params)});
+
+    auto from = csgrange.begin();
+    std::advance(from, startidx);
 
-    for (auto &csgpart : csgrange) {
+    for (auto &csgpart : Range<It>{from, csgrange.end()}) {
         if (params.statusfn() && params.statusfn()(-1))
             break;
 
+        if (opstack.size() == 1)
+            partialfn(csgidx, *opstack.top().grid);
+
         auto &partgrid = grids[csgidx++];
 
         auto op = get_operation(csgpart);
@@ -111,7 +220,132 @@ VoxelGridPtr voxelize_csgmesh(const Range<It>      &csgrange,
         }
     }
 
-    ret = std::move(opstack.top().grid);
+    return std::move(opstack.top().grid);
+}
+
+} // namespace detail
+
+// Convert the input csgrange to a voxel grid performing the boolean operations in the voxel realm.
+template<class It>
+VoxelGridPtr voxelize_csgmesh(const Range<It>      &csgrange,
+                              const VoxelizeParams &params = {})
+{
+    using namespace detail;
+
+    std::vector<VoxelGridPtr> grids (csgrange.size());
+
+    execution::for_each(ex_tbb, size_t(0), csgrange.size(), [&](size_t csgidx) {
+        if (params.statusfn() && params.statusfn()(-1))
+            return;
+
+        auto it = csgrange.begin();
+        std::advance(it, csgidx);
+        auto &csgpart = *it;
+        grids[csgidx] = get_voxelgrid(csgpart, params);
+    }, execution::max_concurrency(ex_tbb));
+
+    return perform_csg_sequence(csgrange, grids, params, 0, {},
+                                [](size_t, const VoxelGrid &) {});
+}
+
+// The same as above, but only the parts missing from the cache are voxelized
+// and the csg operations preceding the first changed part may be skipped.
+// The cache is updated with the grids of the current parts.
+template<class It>
+VoxelGridPtr voxelize_csgmesh(const Range<It>      &csgrange,
+                              const VoxelizeParams &params,
+                              VoxelGridCache       &cache)
+{
+    using namespace detail;
+    using SequenceKey = VoxelGridCache::SequenceKey;
+
+    size_t partcount = csgrange.size();
+    std::vector<SequenceKey> keys(partcount);
+
+    execution::for_each(ex_tbb, size_t(0), partcount, [&](size_t csgidx) {
+        auto it = csgrange.begin();
+        std::advance(it, csgidx);
+        keys[csgidx] = VoxelGridCache::make_key(*it, params);
+    }, execution::max_concurrency(ex_tbb));
+
+    size_t first_changed = std::distance(
+        keys.begin(), std::mismatch(keys.begin(), keys.end(),
+                                    cache.m_sequence.begin(),
+                                    cache.m_sequence.end()).first);
+
+    // A partial result covering a changed part is stale. It has to be
+    // dropped even if no new one is stored below, e.g. when the first
+    // changed part is inside a pushed sub-expression.
+    if (cache.m_partial_pos > first_changed) {
+        cache.m_partial.reset();
+        cache.m_partial_pos = 0;
+    }
+
+    // The csg operations preceding the stored partial result can be skipped
+    // if none of those parts has changed.
+    size_t       startidx = 0;
+    VoxelGridPtr startgrid;
+    if (cache.m_partial && cache.m_partial_pos <= first_changed) {
+        startidx  = cache.m_partial_pos;
+        startgrid = clone(*cache.m_partial);
+    }
+
+    // Grids of the parts are consumed by the csg operations, so the cached
+    // ones are cloned and the new ones are stored as copies.
+    std::vector<VoxelGridPtr> grids(partcount);
+    std::vector<VoxelGridCache::Entry> entries(partcount);
+    std::vector<char> cached(partcount, false);
+
+    execution::for_each(ex_tbb, startidx, partcount, [&](size_t csgidx) {
+        if (params.statusfn() && params.statusfn()(-1))
+            return;
+
+        if (const VoxelGrid *grid = cache.find(keys[csgidx].part)) {
+            grids[csgidx]  = clone(*grid);
+            cached[csgidx] = true;
+        } else {
+            auto it = csgrange.begin();
+            std::advance(it, csgidx);
+            grids[csgidx] = get_voxelgrid(*it, params);
+
+            entries[csgidx].key = keys[csgidx].part;
+            if (grids[csgidx])
+                entries[csgidx].grid = clone(*grids[csgidx]);
+        }
+    }, execution::max_concurrency(ex_tbb));
+
+    // The grids of the unchanged parts are moved over to the new entries,
+    // including the ones skipped thanks to the partial result.
+    for (size_t i = 0; i < partcount; ++i) {
+        if (i >= startidx && !cached[i])
+            continue;
+
+        auto it = std::find_if(cache.m_grids.begin(), cache.m_grids.end(),
+                               [&keys, i](const VoxelGridCache::Entry &e) {
+                                   return e.grid && e.key == keys[i].part;
+                               });
+
+        if (it != cache.m_grids.end())
+            entries[i] = std::move(*it);
+    }
+
+    auto partialfn = [&cache, first_changed, startidx](size_t csgidx,
+                                                       const VoxelGrid &grid) {
+        if (csgidx == first_changed && csgidx != startidx) {
+            cache.m_partial     = clone(grid);
+            cache.m_partial_pos = csgidx;
+        }
+    };
+
+    VoxelGridPtr ret = perform_csg_sequence(csgrange, grids, params, startidx,
+                                            std::move(startgrid), partialfn);
+
+    if (params.statusfn() && params.statusfn()(-1)) {
+        cache.clear();
+    } else {
+        cache.m_grids    = std::move(entries);
+        cache.m_sequence = std::move(keys);
+    }
 
     return ret;
 }
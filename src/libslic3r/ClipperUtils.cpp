@@ -81,6 +81,73 @@ namespace ClipperUtils {
     Points EmptyPathsProvider::s_empty_points;
     Points SinglePathProvider::s_end;
 
+    // Buffers retained by the thread engine over this size are released at the end of a lease,
+    // so that a single huge boolean operation does not pin its memory in a worker thread forever.
+    static constexpr const size_t ClipperEngineMaxRetainedBytes = 16 * 1024 * 1024;
+
+    struct ThreadClipperEngine {
+        ClipperLib::Clipper clipper;
+        bool                leased { false };
+    };
+    static thread_local ThreadClipperEngine s_thread_clipper_engine;
+
+    ClipperEngine::ClipperEngine()
+    {
+        ThreadClipperEngine &engine = s_thread_clipper_engine;
+        if (engine.leased) {
+            m_clipper = &m_private.emplace();
+        } else {
+            engine.leased = true;
+            m_clipper     = &engine.clipper;
+        }
+    }
+
+    ClipperEngine::~ClipperEngine()
+    {
+        if (! m_private) {
+            ClipperLib::Clipper &clipper = *m_clipper;
+            clipper.Clear();
+            clipper.ReverseSolution(false);
+            clipper.StrictlySimple(false);
+            clipper.PreserveCollinear(false);
+            if (clipper.BuffersSize() > ClipperEngineMaxRetainedBytes)
+                clipper.ReleaseBuffers();
+            s_thread_clipper_engine.leased = false;
+        }
+    }
+
+    struct ThreadClipperOffsetEngine {
+        ClipperLib::ClipperOffset offsetter;
+        bool                      leased { false };
+    };
+    static thread_local ThreadClipperOffsetEngine s_thread_clipper_offset_engine;
+
+    ClipperOffsetEngine::ClipperOffsetEngine()
+    {
+        ThreadClipperOffsetEngine &engine = s_thread_clipper_offset_engine;
+        if (engine.leased) {
+            m_offsetter = &m_private.emplace();
+        } else {
+            engine.leased = true;
+            m_offsetter   = &engine.offsetter;
+        }
+    }
+
+    ClipperOffsetEngine::~ClipperOffsetEngine()
+    {
+        if (! m_private) {
+            ClipperLib::ClipperOffset &co = *m_offsetter;
+            co.Clear();
+            // Reset the parameters to the ClipperLib::ClipperOffset defaults.
+            co.MiterLimit         = 2.;
+            co.ArcTolerance       = 0.25;
+            co.ShortestEdgeLength = 0.;
+            if (co.BuffersSize() > ClipperEngineMaxRetainedBytes)
+                co.ReleaseBuffers();
+            s_thread_clipper_offset_engine.leased = false;
+        }
+    }
+
     // Clip source polygon to be used as a clipping polygon with a bouding box around the source (to be clipped) polygon.
     // Useful as an optimization for expensive ClipperLib operations, for example when clipping source polygons one by one
     // with a set of polygons covering the whole layer below.
@@ -307,23 +374,23 @@ static ClipperLib::Paths raw_offset(PathsProvider &&paths, float offset, Clipper
 {
     CLIPPER_UTILS_TIME_LIMIT_MILLIS(CLIPPER_UTILS_TIME_LIMIT_DEFAULT);
 
-    ClipperLib::ClipperOffset co;
+    ClipperUtils::ClipperOffsetEngine co;
     ClipperLib::Paths out;
     out.reserve(paths.size());
     ClipperLib::Paths out_this;
     if (joinType == jtRound)
-        co.ArcTolerance = miterLimit;
+        co->ArcTolerance = miterLimit;
     else
-        co.MiterLimit = miterLimit;
-    co.ShortestEdgeLength = std::abs(offset * ClipperOffsetShortestEdgeFactor);
+        co->MiterLimit = miterLimit;
+    co->ShortestEdgeLength = std::abs(offset * ClipperOffsetShortestEdgeFactor);
     for (const ClipperLib::Path &path : paths) {
-        co.Clear();
+        co->Clear();
         // Execute reorients the contours so that the outer most contour has a positive area. Thus the output
         // contours will be CCW oriented even though the input paths are CW oriented.
         // Offset is applied after contour reorientation, thus the signum of the offset value is reversed.
-        co.AddPath(path, joinType, endType);
+        co->AddPath(path, joinType, endType);
         bool ccw = endType == ClipperLib::etClosedPolygon ? ClipperLib::Orientation(path) : true;
-        co.Execute(out_this, ccw ? offset : - offset);
+        co->Execute(out_this, ccw ? offset : - offset);
         if (! ccw) {
             // Reverse the resulting contours.
             for (ClipperLib::Path &path : out_this)
@@ -350,11 +417,11 @@ TResult clipper_do(
 {
     CLIPPER_UTILS_TIME_LIMIT_MILLIS(CLIPPER_UTILS_TIME_LIMIT_DEFAULT);
 
-    ClipperLib::Clipper clipper;
-    clipper.AddPaths(std::forward<TSubj>(subject), ClipperLib::ptSubject, true);
-    clipper.AddPaths(std::forward<TClip>(clip),    ClipperLib::ptClip,    true);
+    ClipperUtils::ClipperEngine clipper;
+    clipper->AddPaths(std::forward<TSubj>(subject), ClipperLib::ptSubject, true);
+    clipper->AddPaths(std::forward<TClip>(clip),    ClipperLib::ptClip,    true);
     TResult retval;
-    clipper.Execute(clipType, retval, fillType, fillType);
+    clipper->Execute(clipType, retval, fillType, fillType);
     return retval;
 }
 
@@ -381,10 +448,10 @@ TResult clipper_union(
 {
     CLIPPER_UTILS_TIME_LIMIT_MILLIS(CLIPPER_UTILS_TIME_LIMIT_DEFAULT);
 
-    ClipperLib::Clipper clipper;
-    clipper.AddPaths(std::forward<TSubj>(subject), ClipperLib::ptSubject, true);
+    ClipperUtils::ClipperEngine clipper;
+    clipper->AddPaths(std::forward<TSubj>(subject), ClipperLib::ptSubject, true);
     TResult retval;
-    clipper.Execute(ClipperLib::ctUnion, retval, fillType, fillType);
+    clipper->Execute(ClipperLib::ctUnion, retval, fillType, fillType);
     return retval;
 }
 
@@ -424,12 +491,12 @@ static TResult shrink_paths(PathsProvider &&paths, float offset, ClipperLib::Joi
     assert(offset > 0);
     TResult out;
     if (auto raw = raw_offset(std::forward<PathsProvider>(paths), - offset, joinType, miterLimit); ! raw.empty()) {
-        ClipperLib::Clipper clipper;
-        clipper.AddPaths(raw, ClipperLib::ptSubject, true);
-        ClipperLib::IntRect r = clipper.GetBounds();
-        clipper.AddPath({ { r.left - 10, r.bottom + 10 }, { r.right + 10, r.bottom + 10 }, { r.right + 10, r.top - 10 }, { r.left - 10, r.top - 10 } }, ClipperLib::ptSubject, true);
-        clipper.ReverseSolution(true);
-        clipper.Execute(ClipperLib::ctUnion, out, ClipperLib::pftNegative, ClipperLib::pftNegative);
+        ClipperUtils::ClipperEngine clipper;
+        clipper->AddPaths(raw, ClipperLib::ptSubject, true);
+        ClipperLib::IntRect r = clipper->GetBounds();
+        clipper->AddPath({ { r.left - 10, r.bottom + 10 }, { r.right + 10, r.bottom + 10 }, { r.right + 10, r.top - 10 }, { r.left - 10, r.top - 10 } }, ClipperLib::ptSubject, true);
+        clipper->ReverseSolution(true);
+        clipper->Execute(ClipperLib::ctUnion, out, ClipperLib::pftNegative, ClipperLib::pftNegative);
         remove_outermost_polygon(out);
     }
     return out;
@@ -472,14 +539,14 @@ static int offset_expolygon_inner(const Slic3r::ExPolygon &expoly, const float d
     // 1) Offset the outer contour.
     ClipperLib::Paths contours;
     {
-        ClipperLib::ClipperOffset co;
+        ClipperUtils::ClipperOffsetEngine co;
         if (joinType == jtRound)
-            co.ArcTolerance = miterLimit;
+            co->ArcTolerance = miterLimit;
         else
-            co.MiterLimit = miterLimit;
-        co.ShortestEdgeLength = std::abs(delta * ClipperOffsetShortestEdgeFactor);
-        co.AddPath(expoly.contour.points, joinType, ClipperLib::etClosedPolygon);
-        co.Execute(contours, delta);
+            co->MiterLimit = miterLimit;
+        co->ShortestEdgeLength = std::abs(delta * ClipperOffsetShortestEdgeFactor);
+        co->AddPath(expoly.contour.points, joinType, ClipperLib::etClosedPolygon);
+        co->Execute(contours, delta);
     }
     if (contours.empty())
         // No need to try to offset the holes.
@@ -493,18 +560,18 @@ static int offset_expolygon_inner(const Slic3r::ExPolygon &expoly, const float d
         ClipperLib::Paths holes;
         {
             for (const Polygon &hole : expoly.holes) {
-                ClipperLib::ClipperOffset co;
+                ClipperUtils::ClipperOffsetEngine co;
                 if (joinType == jtRound)
-                    co.ArcTolerance = miterLimit;
+                    co->ArcTolerance = miterLimit;
                 else
-                    co.MiterLimit = miterLimit;
-                co.ShortestEdgeLength = std::abs(delta * ClipperOffsetShortestEdgeFactor);
-                co.AddPath(hole.points, joinType, ClipperLib::etClosedPolygon);
+                    co->MiterLimit = miterLimit;
+                co->ShortestEdgeLength = std::abs(delta * ClipperOffsetShortestEdgeFactor);
+                co->AddPath(hole.points, joinType, ClipperLib::etClosedPolygon);
                 ClipperLib::Paths out2;
                 // Execute reorients the contours so that the outer most contour has a positive area. Thus the output
                 // contours will be CCW oriented even though the input paths are CW oriented.
                 // Offset is applied after contour reorientation, thus the signum of the offset value is reversed.
-                co.Execute(out2, - delta);
+                co->Execute(out2, - delta);
                 append(holes, std::move(out2));
             }
         }
@@ -824,16 +891,62 @@ Slic3r::ExPolygons union_ex(const Slic3r::ExPolygons &subject, const Slic3r::Pol
 Slic3r::ExPolygons union_ex(const Slic3r::Surfaces &subject)
     { return PolyTreeToExPolygons(clipper_do_polytree(ClipperLib::ctUnion, ClipperUtils::SurfacesProvider(subject), ClipperUtils::EmptyPathsProvider(), ClipperLib::pftNonZero)); }
 
+template<typename TResult, typename ClipOperation>
+static std::vector<TResult> clipper_batch(const std::vector<const Polygons*> &subjects, const std::vector<const Polygons*> &clips, ClipOperation &&clip_operation)
+{
+    assert(subjects.size() == clips.size());
+    static const Polygons empty;
+    std::vector<TResult> out(subjects.size());
+    for (size_t i = 0; i < subjects.size(); ++ i)
+        if (const Polygons *subject = subjects[i]; subject && ! subject->empty())
+            // Each operation leases the engine of this thread, reusing its buffers.
+            out[i] = clip_operation(*subject, clips[i] ? *clips[i] : empty);
+    return out;
+}
+
+template<typename TResult, typename ClipOperation>
+static std::vector<TResult> clipper_batch(const std::vector<const Polygons*> &subjects, const Polygons &clip, ApplySafetyOffset do_safety_offset, ClipOperation &&clip_operation)
+{
+    // The safety offset is applied to the shared clipping polygons just once for the whole batch.
+    Polygons        clip_offsetted;
+    if (do_safety_offset == ApplySafetyOffset::Yes)
+        clip_offsetted = to_polygons(safety_offset(ClipperUtils::PolygonsProvider(clip)));
+    const Polygons &clip_final = do_safety_offset == ApplySafetyOffset::Yes ? clip_offsetted : clip;
+    std::vector<TResult> out(subjects.size());
+    for (size_t i = 0; i < subjects.size(); ++ i)
+        if (const Polygons *subject = subjects[i]; subject && ! subject->empty())
+            out[i] = clip_operation(*subject, clip_final);
+    return out;
+}
+
+std::vector<Slic3r::Polygons> diff_batch(const std::vector<const Slic3r::Polygons*> &subjects, const std::vector<const Slic3r::Polygons*> &clips, ApplySafetyOffset do_safety_offset)
+    { return clipper_batch<Polygons>(subjects, clips, [do_safety_offset](const Polygons &subject, const Polygons &clip) { return diff(subject, clip, do_safety_offset); }); }
+std::vector<Slic3r::ExPolygons> diff_ex_batch(const std::vector<const Slic3r::Polygons*> &subjects, const std::vector<const Slic3r::Polygons*> &clips, ApplySafetyOffset do_safety_offset)
+    { return clipper_batch<ExPolygons>(subjects, clips, [do_safety_offset](const Polygons &subject, const Polygons &clip) { return diff_ex(subject, clip, do_safety_offset); }); }
+std::vector<Slic3r::Polygons> intersection_batch(const std::vector<const Slic3r::Polygons*> &subjects, const std::vector<const Slic3r::Polygons*> &clips, ApplySafetyOffset do_safety_offset)
+    { return clipper_batch<Polygons>(subjects, clips, [do_safety_offset](const Polygons &subject, const Polygons &clip) { return intersection(subject, clip, do_safety_offset); }); }
+std::vector<Slic3r::ExPolygons> intersection_ex_batch(const std::vector<const Slic3r::Polygons*> &subjects, const std::vector<const Slic3r::Polygons*> &clips, ApplySafetyOffset do_safety_offset)
+    { return clipper_batch<ExPolygons>(subjects, clips, [do_safety_offset](const Polygons &subject, const Polygons &clip) { return intersection_ex(subject, clip, do_safety_offset); }); }
+
+std::vector<Slic3r::Polygons> diff_batch(const std::vector<const Slic3r::Polygons*> &subjects, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset)
+    { return clipper_batch<Polygons>(subjects, clip, do_safety_offset, [](const Polygons &subject, const Polygons &clip) { return diff(subject, clip); }); }
+std::vector<Slic3r::ExPolygons> diff_ex_batch(const std::vector<const Slic3r::Polygons*> &subjects, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset)
+    { return clipper_batch<ExPolygons>(subjects, clip, do_safety_offset, [](const Polygons &subject, const Polygons &clip) { return diff_ex(subject, clip); }); }
+std::vector<Slic3r::Polygons> intersection_batch(const std::vector<const Slic3r::Polygons*> &subjects, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset)
+    { return clipper_batch<Polygons>(subjects, clip, do_safety_offset, [](const Polygons &subject, const Polygons &clip) { return intersection(subject, clip); }); }
+std::vector<Slic3r::ExPolygons> intersection_ex_batch(const std::vector<const Slic3r::Polygons*> &subjects, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset)
+    { return clipper_batch<ExPolygons>(subjects, clip, do_safety_offset, [](const Polygons &subject, const Polygons &clip) { return intersection_ex(subject, clip); }); }
+
 template<typename PathsProvider1, typename PathsProvider2>
 Polylines _clipper_pl_open(ClipperLib::ClipType clipType, PathsProvider1 &&subject, PathsProvider2 &&clip)
 {
     CLIPPER_UTILS_TIME_LIMIT_MILLIS(CLIPPER_UTILS_TIME_LIMIT_DEFAULT);
 
-    ClipperLib::Clipper clipper;
-    clipper.AddPaths(std::forward<PathsProvider1>(subject), ClipperLib::ptSubject, false);
-    clipper.AddPaths(std::forward<PathsProvider2>(clip), ClipperLib::ptClip, true);
+    ClipperUtils::ClipperEngine clipper;
+    clipper->AddPaths(std::forward<PathsProvider1>(subject), ClipperLib::ptSubject, false);
+    clipper->AddPaths(std::forward<PathsProvider2>(clip), ClipperLib::ptClip, true);
     ClipperLib::PolyTree retval;
-    clipper.Execute(clipType, retval, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+    clipper->Execute(clipType, retval, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
     return PolyTreeToPolylines(std::move(retval));
 }
 
@@ -1075,10 +1188,10 @@ ClipperLib::Paths fix_after_outer_offset(
 
   	ClipperLib::Paths solution;
   	if (! input.empty()) {
-		ClipperLib::Clipper clipper;
-	  	clipper.AddPath(input, ClipperLib::ptSubject, true);
-		clipper.ReverseSolution(reverse_result);
-		clipper.Execute(ClipperLib::ctUnion, solution, filltype, filltype);
+		ClipperUtils::ClipperEngine clipper;
+	  	clipper->AddPath(input, ClipperLib::ptSubject, true);
+		clipper->ReverseSolution(reverse_result);
+		clipper->Execute(ClipperLib::ctUnion, solution, filltype, filltype);
 	}
     return solution;
 }
@@ -1095,16 +1208,16 @@ ClipperLib::Paths fix_after_inner_offset(
 
   	ClipperLib::Paths solution;
   	if (! input.empty()) {
-		ClipperLib::Clipper clipper;
-		clipper.AddPath(input, ClipperLib::ptSubject, true);
-		ClipperLib::IntRect r = clipper.GetBounds();
+		ClipperUtils::ClipperEngine clipper;
+		clipper->AddPath(input, ClipperLib::ptSubject, true);
+		ClipperLib::IntRect r = clipper->GetBounds();
 		r.left -= 10; r.top -= 10; r.right += 10; r.bottom += 10;
 		if (filltype == ClipperLib::pftPositive)
-			clipper.AddPath({ ClipperLib::IntPoint(r.left, r.bottom), ClipperLib::IntPoint(r.left, r.top), ClipperLib::IntPoint(r.right, r.top), ClipperLib::IntPoint(r.right, r.bottom) }, ClipperLib::ptSubject, true);
+			clipper->AddPath({ ClipperLib::IntPoint(r.left, r.bottom), ClipperLib::IntPoint(r.left, r.top), ClipperLib::IntPoint(r.right, r.top), ClipperLib::IntPoint(r.right, r.bottom) }, ClipperLib::ptSubject, true);
 		else
-			clipper.AddPath({ ClipperLib::IntPoint(r.left, r.bottom), ClipperLib::IntPoint(r.right, r.bottom), ClipperLib::IntPoint(r.right, r.top), ClipperLib::IntPoint(r.left, r.top) }, ClipperLib::ptSubject, true);
-		clipper.ReverseSolution(reverse_result);
-		clipper.Execute(ClipperLib::ctUnion, solution, filltype, filltype);
+			clipper->AddPath({ ClipperLib::IntPoint(r.left, r.bottom), ClipperLib::IntPoint(r.right, r.bottom), ClipperLib::IntPoint(r.right, r.top), ClipperLib::IntPoint(r.left, r.top) }, ClipperLib::ptSubject, true);
+		clipper->ReverseSolution(reverse_result);
+		clipper->Execute(ClipperLib::ctUnion, solution, filltype, filltype);
 		if (! solution.empty())
 			solution.erase(solution.begin());
 	}
@@ -11,6 +11,7 @@
 #include <assert.h>
 #include <cstddef>
 #include <iterator>
+#include <optional>
 #include <utility>
 #include <vector>
 #include <cassert>
@@ -333,6 +334,45 @@ namespace ClipperUtils {
         size_t             m_size;
     };
 
+    // Lease of a reusable ClipperLib engine. Each thread owns a single ClipperLib::Clipper, which retains its buffers
+    // (edges, local minima, output points) between the boolean operations, thus a long sequence of small boolean
+    // operations executed by a thread does not allocate the engine state again and again.
+    // If the thread engine is already leased (nested use), a private engine is created instead.
+    // The engine is cleared and its options are reset when the lease ends.
+    class ClipperEngine {
+    public:
+        ClipperEngine();
+        ~ClipperEngine();
+        ClipperEngine(const ClipperEngine &) = delete;
+        ClipperEngine& operator=(const ClipperEngine &) = delete;
+
+        ClipperLib::Clipper& operator*()  { return *m_clipper; }
+        ClipperLib::Clipper* operator->() { return m_clipper; }
+
+    private:
+        ClipperLib::Clipper                 *m_clipper;
+        // Engine created if the engine of this thread is already leased.
+        std::optional<ClipperLib::Clipper>   m_private;
+    };
+
+    // Lease of a reusable ClipperLib offsetter, see ClipperEngine.
+    // The offsetter retains its buffers including its internal union engine, its parameters are reset when the lease ends.
+    class ClipperOffsetEngine {
+    public:
+        ClipperOffsetEngine();
+        ~ClipperOffsetEngine();
+        ClipperOffsetEngine(const ClipperOffsetEngine &) = delete;
+        ClipperOffsetEngine& operator=(const ClipperOffsetEngine &) = delete;
+
+        ClipperLib::ClipperOffset& operator*()  { return *m_offsetter; }
+        ClipperLib::ClipperOffset* operator->() { return m_offsetter; }
+
+    private:
+        ClipperLib::ClipperOffset                *m_offsetter;
+        // Offsetter created if the offsetter of this thread is already leased.
+        std::optional<ClipperLib::ClipperOffset>  m_private;
+    };
+
     // For ClipperLib with Z coordinates.
     using ZPoint = Vec3i32;
     using ZPoints = std::vector<Vec3i32>;
@@ -517,6 +557,20 @@ inline Slic3r::Lines intersection_ln(const Slic3r::Line &subject, const Slic3r::
     return _clipper_ln(ClipperLib::ctIntersection, lines, clip);
 }
 
+// Batched boolean operations: the i-th subject is clipped with the i-th clipping polygons, nullptr clip stands for no clipping polygons.
+// The input polygons are referenced, not copied. All the operations of a batch are executed one after another
+// by the reusable engine of the calling thread (see ClipperUtils::ClipperEngine).
+// Safety offset is applied to the clipping polygons only.
+std::vector<Slic3r::Polygons>   diff_batch(const std::vector<const Slic3r::Polygons*> &subjects, const std::vector<const Slic3r::Polygons*> &clips, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
+std::vector<Slic3r::ExPolygons> diff_ex_batch(const std::vector<const Slic3r::Polygons*> &subjects, const std::vector<const Slic3r::Polygons*> &clips, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
+std::vector<Slic3r::Polygons>   intersection_batch(const std::vector<const Slic3r::Polygons*> &subjects, const std::vector<const Slic3r::Polygons*> &clips, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
+std::vector<Slic3r::ExPolygons> intersection_ex_batch(const std::vector<const Slic3r::Polygons*> &subjects, const std::vector<const Slic3r::Polygons*> &clips, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
+// Batched variants, all the subjects are clipped with the same clipping polygons.
+std::vector<Slic3r::Polygons>   diff_batch(const std::vector<const Slic3r::Polygons*> &subjects, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
+std::vector<Slic3r::ExPolygons> diff_ex_batch(const std::vector<const Slic3r::Polygons*> &subjects, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
+std::vector<Slic3r::Polygons>   intersection_batch(const std::vector<const Slic3r::Polygons*> &subjects, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
+std::vector<Slic3r::ExPolygons> intersection_ex_batch(const std::vector<const Slic3r::Polygons*> &subjects, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
+
 Slic3r::Polygons union_(const Slic3r::Polygons &subject);
 Slic3r::Polygons union_(const Slic3r::ExPolygons &subject);
 Slic3r::Polygons union_(const Slic3r::Polygons &subject, const ClipperLib::PolyFillType fillType);
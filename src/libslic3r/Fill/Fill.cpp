@@ -8,9 +8,12 @@
 ///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
 ///|/
 #include <oneapi/tbb/scalable_allocator.h>
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
 #include <boost/container/vector.hpp>
 #include <memory>
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <limits>
 #include <set>
@@ -457,6 +460,50 @@ static void insert_fills_into_islands(Layer &layer, uint32_t fill_region_id, uin
     }
 }
 
+// Pool of filler objects per worker thread and infill pattern. Some of the fillers keep their own caches (FillHoneycomb),
+// all of them are reused by the layers and surface groups filled by the same thread instead of being created for each of them.
+struct ThreadFillers
+{
+    std::array<std::vector<std::unique_ptr<Fill>>, size_t(ipCount)> free;
+};
+
+// Filler taken out of the pool of the current thread for the duration of a fill.
+// A nested TBB task executed by the same thread while the filler is leased is given another filler instance.
+class FillerLease
+{
+public:
+    explicit FillerLease(InfillPattern pattern) : m_pattern(pattern) {
+        std::vector<std::unique_ptr<Fill>> &free = thread_fillers().free[size_t(pattern)];
+        if (free.empty()) {
+            m_filler.reset(Fill::new_from_type(pattern));
+        } else {
+            m_filler = std::move(free.back());
+            free.pop_back();
+            // Reset the state of a recycled filler to the state of a newly created one.
+            m_filler->spacing = 0.;
+            m_filler->overlap = 0.;
+        }
+    }
+    ~FillerLease() {
+        std::vector<std::unique_ptr<Fill>> &free = thread_fillers().free[size_t(m_pattern)];
+        if (free.size() < 4)
+            free.emplace_back(std::move(m_filler));
+    }
+    FillerLease(const FillerLease &) = delete;
+    FillerLease& operator=(const FillerLease &) = delete;
+
+    Fill* get() const { return m_filler.get(); }
+
+private:
+    static ThreadFillers& thread_fillers() {
+        static thread_local ThreadFillers s_thread_fillers;
+        return s_thread_fillers;
+    }
+
+    InfillPattern         m_pattern;
+    std::unique_ptr<Fill> m_filler;
+};
+
 void Layer::clear_fills()
 {
     for (LayerRegion *layerm : m_regions)
@@ -483,9 +530,26 @@ void Layer::make_fills(FillAdaptive::Octree* adaptive_fill_octree, FillAdaptive:
 #endif /* SLIC3R_DEBUG_SLICE_PROCESSING */
 
 	size_t first_object_layer_id = this->object()->get_layer(0)->id();
-    for (SurfaceFill &surface_fill : surface_fills) {
-        // Create the filler object.
-        std::unique_ptr<Fill> f = std::unique_ptr<Fill>(Fill::new_from_type(surface_fill.params.pattern));
+
+    // Each SurfaceFill group is filled expolygon by expolygon. The fills of the expolygons are independent of each other,
+    // thus they are generated in parallel. This helps the layers with a lot of infill, where the parallelization over layers
+    // done by PrintObject::infill() is too coarse. The extrusions are then saved into the layer serially in the original order,
+    // therefore the result does not depend on the scheduling.
+    struct FillTask {
+        size_t                                     surface_fill_id;
+        size_t                                     expolygon_id;
+        std::unique_ptr<ExtrusionEntityCollection> eec;
+    };
+    std::vector<FillTask> fill_tasks;
+    for (size_t surface_fill_id = 0; surface_fill_id < surface_fills.size(); ++ surface_fill_id)
+        for (size_t expolygon_id = 0; expolygon_id < surface_fills[surface_fill_id].expolygons.size(); ++ expolygon_id)
+            fill_tasks.push_back({ surface_fill_id, expolygon_id, {} });
+
+    auto fill_expolygon = [this, &surface_fills, &bbox, resolution, perimeter_generator, first_object_layer_id, adaptive_fill_octree, support_fill_octree, lightning_generator](FillTask &task) {
+        SurfaceFill &surface_fill = surface_fills[task.surface_fill_id];
+        // Take the filler object from the pool of this thread.
+        FillerLease  filler(surface_fill.params.pattern);
+        Fill        *f = filler.get();
         f->set_bounding_box(bbox);
 		// Layer ID is used for orienting the infill in alternating directions.
 		// Layer::id() returns layer ID including raft layers, subtract them to make the infill direction independent
@@ -498,10 +562,10 @@ void Layer::make_fills(FillAdaptive::Octree* adaptive_fill_octree, FillAdaptive:
         f->print_object_config = &this->object()->config();
 
         if (surface_fill.params.pattern == ipLightning)
-            dynamic_cast<FillLightning::Filler*>(f.get())->generator = lightning_generator;
+            dynamic_cast<FillLightning::Filler*>(f)->generator = lightning_generator;
 
         if (surface_fill.params.pattern == ipEnsuring) {
-            auto *fill_ensuring = dynamic_cast<FillEnsuring *>(f.get());
+            auto *fill_ensuring = dynamic_cast<FillEnsuring *>(f);
             assert(fill_ensuring != nullptr);
             fill_ensuring->print_region_config = &m_regions[surface_fill.region_id]->region().config();
         }
@@ -524,7 +588,7 @@ void Layer::make_fills(FillAdaptive::Octree* adaptive_fill_octree, FillAdaptive:
         // Used by the concentric infill pattern to clip the loops to create extrusion paths.
         f->loop_clipping = coord_t(scale_(surface_fill.params.flow.nozzle_diameter()) * LOOP_CLIPPING_LENGTH_OVER_NOZZLE_DIAMETER);
 
-        LayerRegion &layerm = *m_regions[surface_fill.region_id];
+        const LayerRegion &layerm = *m_regions[surface_fill.region_id];
 
         // apply half spacing using this flow's own spacing and generate infill
         FillParams params;
@@ -537,73 +601,83 @@ void Layer::make_fills(FillAdaptive::Octree* adaptive_fill_octree, FillAdaptive:
         params.layer_height               = layerm.layer()->height;
         params.prefer_clockwise_movements = this->object()->print()->config().prefer_clockwise_movements;
 
-        for (ExPolygon &expoly : surface_fill.expolygons) {
-			// Spacing is modified by the filler to indicate adjustments. Reset it for each expolygon.
-			f->spacing = surface_fill.params.spacing;
-			surface_fill.surface.expolygon = std::move(expoly);
-            Polylines      polylines;
-            ThickPolylines thick_polylines;
-			try {
-                if (params.use_arachne)
-                    thick_polylines = f->fill_surface_arachne(&surface_fill.surface, params);
-                else
-				    polylines = f->fill_surface(&surface_fill.surface, params);
-			} catch (InfillFailedException &) {
-			}
-            if (!polylines.empty() || !thick_polylines.empty()) {
-                // calculate actual flow from spacing (which might have been adjusted by the infill
-		        // pattern generator)
-		        double flow_mm3_per_mm = surface_fill.params.flow.mm3_per_mm();
-		        double flow_width      = surface_fill.params.flow.width();
-		        if (using_internal_flow) {
-		            // if we used the internal flow we're not doing a solid infill
-		            // so we can safely ignore the slight variation that might have
-		            // been applied to f->spacing
-		        } else {
-		            Flow new_flow   = surface_fill.params.flow.with_spacing(float(f->spacing));
-		        	flow_mm3_per_mm = new_flow.mm3_per_mm();
-		        	flow_width      = new_flow.width();
-		        }
-                // Save into layer.
-                ExtrusionEntityCollection *eec        = new ExtrusionEntityCollection();
-                auto                       fill_begin = uint32_t(layerm.fills().size());
-                // Only concentric fills are not sorted.
-                eec->no_sort = f->no_sort();
-                if (params.use_arachne) {
-                    for (const ThickPolyline &thick_polyline : thick_polylines) {
-                        Flow new_flow = surface_fill.params.flow.with_spacing(float(f->spacing));
-
-                        ExtrusionMultiPath multi_path = PerimeterGenerator::thick_polyline_to_multi_path(thick_polyline, surface_fill.params.extrusion_role, new_flow, scaled<float>(0.05), float(SCALED_EPSILON));
-                        // Append paths to collection.
-                        if (!multi_path.empty()) {
-                            if (multi_path.paths.front().first_point() == multi_path.paths.back().last_point())
-                                eec->entities.emplace_back(new ExtrusionLoop(std::move(multi_path.paths)));
-                            else
-                                eec->entities.emplace_back(new ExtrusionMultiPath(std::move(multi_path)));
-                        }
+		// Spacing is modified by the filler to indicate adjustments. Reset it for each expolygon.
+		f->spacing = surface_fill.params.spacing;
+		Surface        surface(surface_fill.surface, std::move(surface_fill.expolygons[task.expolygon_id]));
+        Polylines      polylines;
+        ThickPolylines thick_polylines;
+		try {
+            if (params.use_arachne)
+                thick_polylines = f->fill_surface_arachne(&surface, params);
+            else
+			    polylines = f->fill_surface(&surface, params);
+		} catch (InfillFailedException &) {
+		}
+        if (!polylines.empty() || !thick_polylines.empty()) {
+            // calculate actual flow from spacing (which might have been adjusted by the infill
+	        // pattern generator)
+	        double flow_mm3_per_mm = surface_fill.params.flow.mm3_per_mm();
+	        double flow_width      = surface_fill.params.flow.width();
+	        if (using_internal_flow) {
+	            // if we used the internal flow we're not doing a solid infill
+	            // so we can safely ignore the slight variation that might have
+	            // been applied to f->spacing
+	        } else {
+	            Flow new_flow   = surface_fill.params.flow.with_spacing(float(f->spacing));
+	        	flow_mm3_per_mm = new_flow.mm3_per_mm();
+	        	flow_width      = new_flow.width();
+	        }
+            auto eec = std::make_unique<ExtrusionEntityCollection>();
+            // Only concentric fills are not sorted.
+            eec->no_sort = f->no_sort();
+            if (params.use_arachne) {
+                for (const ThickPolyline &thick_polyline : thick_polylines) {
+                    Flow new_flow = surface_fill.params.flow.with_spacing(float(f->spacing));
+
+                    ExtrusionMultiPath multi_path = PerimeterGenerator::thick_polyline_to_multi_path(thick_polyline, surface_fill.params.extrusion_role, new_flow, scaled<float>(0.05), float(SCALED_EPSILON));
+                    // Append paths to collection.
+                    if (!multi_path.empty()) {
+                        if (multi_path.paths.front().first_point() == multi_path.paths.back().last_point())
+                            eec->entities.emplace_back(new ExtrusionLoop(std::move(multi_path.paths)));
+                        else
+                            eec->entities.emplace_back(new ExtrusionMultiPath(std::move(multi_path)));
                     }
-
-                    if (!eec->empty())
-                        layerm.m_fills.entities.push_back(eec);
-                    else
-                        delete eec;
-
-                    thick_polylines.clear();
-                } else {
-                    // When prefer_clockwise_movements is true, we have to ensure that extrusion paths will not be reversed during path planning.
-                    extrusion_entities_append_paths(
-                        eec->entities, std::move(polylines),
-						ExtrusionAttributes{
-                            surface_fill.params.extrusion_role,
-							ExtrusionFlow{ flow_mm3_per_mm, float(flow_width), surface_fill.params.flow.height() },
-                            f->is_self_crossing()
-						}, !params.prefer_clockwise_movements);
-                    layerm.m_fills.entities.push_back(eec);
                 }
-                insert_fills_into_islands(*this, uint32_t(surface_fill.region_id), fill_begin, uint32_t(layerm.fills().size()));
-		    }
-		}
-    }
+
+                if (!eec->empty())
+                    task.eec = std::move(eec);
+            } else {
+                // When prefer_clockwise_movements is true, we have to ensure that extrusion paths will not be reversed during path planning.
+                extrusion_entities_append_paths(
+                    eec->entities, std::move(polylines),
+					ExtrusionAttributes{
+                        surface_fill.params.extrusion_role,
+						ExtrusionFlow{ flow_mm3_per_mm, float(flow_width), surface_fill.params.flow.height() },
+                        f->is_self_crossing()
+					}, !params.prefer_clockwise_movements);
+                task.eec = std::move(eec);
+            }
+	    }
+    };
+
+    if (fill_tasks.size() > 1)
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, fill_tasks.size(), 1), [&fill_tasks, &fill_expolygon](const tbb::blocked_range<size_t> &range) {
+            for (size_t task_id = range.begin(); task_id < range.end(); ++ task_id)
+                fill_expolygon(fill_tasks[task_id]);
+        });
+    else
+        for (FillTask &task : fill_tasks)
+            fill_expolygon(task);
+
+    // Save into layer.
+    for (FillTask &task : fill_tasks)
+        if (task.eec) {
+            const SurfaceFill &surface_fill = surface_fills[task.surface_fill_id];
+            LayerRegion       &layerm       = *m_regions[surface_fill.region_id];
+            auto               fill_begin   = uint32_t(layerm.fills().size());
+            layerm.m_fills.entities.push_back(task.eec.release());
+            insert_fills_into_islands(*this, uint32_t(surface_fill.region_id), fill_begin, uint32_t(layerm.fills().size()));
+        }
 
 	for (LayerSlice &lslice : this->lslices_ex)
 		for (LayerIsland &island : lslice.islands) {
@@ -7,6 +7,10 @@
 #include <algorithm>
 #include <vector>
 #include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
 
 #include "../ClipperUtils.hpp"
 #include "../ShortestPath.hpp"
@@ -41,7 +45,7 @@ static inline double f(double x, double z_sin, double z_cos, bool vertical, bool
 
 static inline Polyline make_wave(
     const std::vector<Vec2d>& one_period, double width, double height, double offset, double scaleFactor,
-    double z_cos, double z_sin, bool vertical, bool flip)
+    double z_cos, double z_sin, bool vertical, bool flip, const Point &shift)
 {
     std::vector<Vec2d> points = one_period;
     double period = points.back()(0);
@@ -58,7 +62,7 @@ static inline Polyline make_wave(
         points.emplace_back(Vec2d(width, f(width, z_sin, z_cos, vertical, flip)));
     }
 
-    // and construct the final polyline to return:
+    // and construct the final polyline to return, shifted to the grid origin:
     Polyline polyline;
     polyline.points.reserve(points.size());
     for (auto& point : points) {
@@ -66,7 +70,7 @@ static inline Polyline make_wave(
         point(1) = std::clamp(double(point.y()), 0., height);
         if (vertical)
             std::swap(point(0), point(1));
-        polyline.points.emplace_back((point * scaleFactor).cast<coord_t>());
+        polyline.points.emplace_back((point * scaleFactor).cast<coord_t>() + shift);
     }
 
     return polyline;
@@ -112,7 +116,80 @@ static std::vector<Vec2d> make_one_period(double width, double scaleFactor, doub
     return points;
 }
 
-static Polylines make_gyroid_waves(double gridZ, double density_adjusted, double line_spacing, double width, double height)
+// One period of the odd and of the even gyroid waves. The waves depend on the layer Z only through the phase
+// of Z modulo the gyroid period, thus a template is valid for all layers (and all objects) sharing
+// the same quantized phase, tolerance (derived from the density and spacing) and truncated width.
+struct GyroidWaveTemplate
+{
+    double              z_sin;
+    double              z_cos;
+    bool                vertical;
+    std::vector<Vec2d>  one_period_odd;
+    std::vector<Vec2d>  one_period_even;
+};
+
+// Thread safe cache of gyroid wave templates shared by all FillGyroid instances.
+class GyroidWaveCache
+{
+public:
+    // Number of phase steps per gyroid period. With the usual gyroid scale of ~1mm per radian,
+    // the phase quantization error is well below 0.1um.
+    static constexpr int PhaseSteps = 65536;
+    // Maximum number of templates cached, the cache is flushed once it grows over this limit.
+    static constexpr size_t MaxEntries = 4096;
+
+    static std::shared_ptr<const GyroidWaveTemplate> get(double z, double width, double height, double tolerance)
+    {
+        // Quantize the phase. The waves are always calculated from the quantized phase, so that the result
+        // does not depend on the layer, which happened to populate the cache first.
+        double phase     = std::fmod(z, 2. * M_PI);
+        if (phase < 0.)
+            phase += 2. * M_PI;
+        int    phase_idx = int(std::lround(phase * (PhaseSteps / (2. * M_PI)))) % PhaseSteps;
+        double z_q       = double(phase_idx) * (2. * M_PI / PhaseSteps);
+        double z_sin     = sin(z_q);
+        double z_cos     = cos(z_q);
+        bool   vertical  = std::abs(z_sin) <= std::abs(z_cos);
+        // Only the width of a truncated period (less than 2 PI) influences the template.
+        double limit     = std::min(2. * M_PI, vertical ? height : width);
+
+        Key key { phase_idx, tolerance, limit };
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (auto it = m_cache.find(key); it != m_cache.end())
+                return it->second;
+        }
+
+        auto out = std::make_shared<GyroidWaveTemplate>();
+        out->z_sin    = z_sin;
+        out->z_cos    = z_cos;
+        out->vertical = vertical;
+        // creates one period of the waves, so it doesn't have to be recalculated all the time
+        // even polylines are a bit shifted
+        out->one_period_odd  = make_one_period(limit, 0., z_cos, z_sin, vertical, ! vertical, tolerance);
+        out->one_period_even = make_one_period(limit, 0., z_cos, z_sin, vertical, vertical, tolerance);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_cache.size() >= MaxEntries)
+            m_cache.clear();
+        // Another thread may have been faster, return the template already stored.
+        return m_cache.emplace(key, std::move(out)).first->second;
+    }
+
+private:
+    struct Key {
+        int     phase_idx;
+        double  tolerance;
+        double  limit;
+        bool operator<(const Key &rhs) const
+            { return std::tie(phase_idx, tolerance, limit) < std::tie(rhs.phase_idx, rhs.tolerance, rhs.limit); }
+    };
+
+    static inline std::mutex                                             m_mutex;
+    static inline std::map<Key, std::shared_ptr<const GyroidWaveTemplate>> m_cache;
+};
+
+static Polylines make_gyroid_waves(double gridZ, double density_adjusted, double line_spacing, double width, double height, const Point &shift)
 {
     const double scaleFactor = scale_(line_spacing) / density_adjusted;
 
@@ -123,10 +200,11 @@ static Polylines make_gyroid_waves(double gridZ, double density_adjusted, double
     //scale factor for 5% : 8 712 388
     // 1z = 10^-6 mm ?
     const double z     = gridZ / scaleFactor;
-    const double z_sin = sin(z);
-    const double z_cos = cos(z);
+    std::shared_ptr<const GyroidWaveTemplate> waves = GyroidWaveCache::get(z, width, height, tolerance);
+    const double z_sin = waves->z_sin;
+    const double z_cos = waves->z_cos;
 
-    bool vertical = (std::abs(z_sin) <= std::abs(z_cos));
+    bool vertical = waves->vertical;
     double lower_bound = 0.;
     double upper_bound = height;
     bool flip = true;
@@ -137,18 +215,19 @@ static Polylines make_gyroid_waves(double gridZ, double density_adjusted, double
         std::swap(width,height);
     }
 
-    std::vector<Vec2d> one_period_odd = make_one_period(width, scaleFactor, z_cos, z_sin, vertical, flip, tolerance); // creates one period of the waves, so it doesn't have to be recalculated all the time
-    flip = !flip;                                                                   // even polylines are a bit shifted
-    std::vector<Vec2d> one_period_even = make_one_period(width, scaleFactor, z_cos, z_sin, vertical, flip, tolerance);
+    const std::vector<Vec2d> &one_period_odd  = waves->one_period_odd;
+    flip = !flip;
+    const std::vector<Vec2d> &one_period_even = waves->one_period_even;
     Polylines result;
+    result.reserve(size_t((upper_bound - lower_bound) / M_PI) + 2);
 
     for (double y0 = lower_bound; y0 < upper_bound + EPSILON; y0 += M_PI) {
         // creates odd polylines
-        result.emplace_back(make_wave(one_period_odd, width, height, y0, scaleFactor, z_cos, z_sin, vertical, flip));
+        result.emplace_back(make_wave(one_period_odd, width, height, y0, scaleFactor, z_cos, z_sin, vertical, flip, shift));
         // creates even polylines
         y0 += M_PI;
         if (y0 < upper_bound + EPSILON) {
-            result.emplace_back(make_wave(one_period_even, width, height, y0, scaleFactor, z_cos, z_sin, vertical, flip));
+            result.emplace_back(make_wave(one_period_even, width, height, y0, scaleFactor, z_cos, z_sin, vertical, flip, shift));
         }
     }
 
@@ -184,11 +263,9 @@ void FillGyroid::_fill_surface_single(
         density_adjusted,
         this->spacing,
         ceil(bb.size()(0) / distance) + 1.,
-        ceil(bb.size()(1) / distance) + 1.);
-
-	// shift the polyline to the grid origin
-	for (Polyline &pl : polylines)
-		pl.translate(bb.min);
+        ceil(bb.size()(1) / distance) + 1.,
+        // shift the polyline to the grid origin
+        bb.min);
 
 	polylines = intersection_pl(polylines, expolygon);
 
@@ -50,6 +50,12 @@
 
 namespace Slic3r {
 
+static size_t anycubicsla_max_span_len(std::uint8_t pixel)
+{
+    // the maximum length of the span depends on the pixel color
+    return (pixel == 0 || pixel == 0xF0) ? 0xFFF : 0xF;
+}
+
 static void anycubicsla_get_pixel_span(const std::uint8_t* ptr, const std::uint8_t* end,
                                std::uint8_t& pixel, size_t& span_len)
 {
@@ -57,14 +63,26 @@ static void anycubicsla_get_pixel_span(const std::uint8_t* ptr, const std::uint8
 
     span_len = 0;
     pixel = (*ptr) & 0xF0;
-    // the maximum length of the span depends on the pixel color
-    max_len = (pixel == 0 || pixel == 0xF0) ? 0xFFF : 0xF;
+    max_len = anycubicsla_max_span_len(pixel);
     while (ptr < end && span_len < max_len && ((*ptr) & 0xF0) == pixel) {
         span_len++;
         ptr++;
     }
 }
 
+static void anycubicsla_write_span(std::vector<uint8_t> &dst, std::uint8_t pixel, size_t span_len)
+{
+    // fully transparent of fully opaque pixel
+    if (pixel == 0 || pixel == 0xF0) {
+        dst.push_back(std::uint8_t(pixel | (span_len >> 8)));
+        dst.push_back(std::uint8_t(span_len & 0xFF));
+    }
+    // antialiased pixel
+    else {
+        dst.push_back(std::uint8_t(pixel | span_len));
+    }
+}
+
 struct AnycubicSLARasterEncoder
 {
     sla::EncodedRaster operator()(const void *ptr,
@@ -83,19 +101,49 @@ struct AnycubicSLARasterEncoder
         while (src < src_end) {
             anycubicsla_get_pixel_span(src, src_end, pixel, span_len);
             src += span_len;
-            // fully transparent of fully opaque pixel
-            if (pixel == 0 || pixel == 0xF0) {
-                pixel = pixel | (span_len >> 8);
-                std::copy(&pixel, (&pixel) + 1, std::back_inserter(dst));
-                pixel = span_len & 0xFF;
-                std::copy(&pixel, (&pixel) + 1, std::back_inserter(dst));
+            anycubicsla_write_span(dst, pixel, span_len);
+        }
+
+        return sla::EncodedRaster(std::move(dst), "pwimg");
+    }
+
+    // Same output as above, the spans run over the row ends. The black gaps
+    // between the pixel runs and the empty rows become long black spans
+    // without visiting their pixels.
+    sla::EncodedRaster operator()(const sla::RasterRuns &runs)
+    {
+        std::vector<uint8_t> dst;
+        std::uint8_t         pixel    = 0;
+        size_t               span_len = 0;
+
+        auto flush = [&]() {
+            for (size_t max_len = anycubicsla_max_span_len(pixel); span_len > 0;) {
+                size_t len = std::min(span_len, max_len);
+                anycubicsla_write_span(dst, pixel, len);
+                span_len -= len;
             }
-            // antialiased pixel
-            else {
-                pixel = pixel | span_len;
-                std::copy(&pixel, (&pixel) + 1, std::back_inserter(dst));
+        };
+        auto add_pixels = [&](std::uint8_t value, size_t len) {
+            value &= 0xF0;
+            if (len == 0)
+                return;
+            if (value != pixel)
+                flush();
+            pixel     = value;
+            span_len += len;
+        };
+
+        const size_t w = runs.resolution.width_px;
+        for (const std::vector<sla::PixelRun> &row : runs.rows) {
+            size_t x = 0;
+            for (const sla::PixelRun &run : row) {
+                add_pixels(0, run.x - x);
+                add_pixels(run.value, run.len);
+                x = run.x + run.len;
             }
+            add_pixels(0, w - x);
         }
+        flush();
 
         return sla::EncodedRaster(std::move(dst), "pwimg");
     }
@@ -412,7 +460,7 @@ std::unique_ptr<sla::RasterBase> AnycubicSLAArchive::create_raster() const
 
     double gamma = m_cfg.gamma_correction.getFloat();
 
-    return sla::create_raster_grayscale_aa(res, pxdim, gamma, tr);
+    return sla::create_raster_grayscale_aa_runs(res, pxdim, gamma, tr);
 }
 
 sla::RasterEncoder AnycubicSLAArchive::get_encoder() const
@@ -420,6 +468,11 @@ sla::RasterEncoder AnycubicSLAArchive::get_encoder() const
     return AnycubicSLARasterEncoder{};
 }
 
+sla::RasterRunsEncoder AnycubicSLAArchive::get_runs_encoder() const
+{
+    return AnycubicSLARasterEncoder{};
+}
+
 // Endian safe write of little endian 32bit ints
 static void anycubicsla_write_int32(std::ofstream &out, std::uint32_t val)
 {
@@ -511,9 +564,10 @@ static void anycubicsla_write_layer(std::ofstream &out, anycubicsla_format_layer
 void AnycubicSLAArchive::export_print(const std::string     fname,
                                const SLAPrint       &print,
                                const ThumbnailsList &thumbnails,
-                               const std::string    &/*projectname*/)
+                               const std::string    &/*projectname*/,
+                               const ExportCallbacks &callbacks)
 {
-    std::uint32_t layer_count = m_layers.size();
+    std::uint32_t layer_count = this->layer_count();
 
     anycubicsla_format_intro         intro = {};
     anycubicsla_format_header        header = {};
@@ -553,8 +607,9 @@ void AnycubicSLAArchive::export_print(const std::string     fname,
         //layers
         layer_images.reserve(layer_count * LAYER_SIZE_ESTIMATE);
         image_offset = intro.image_data_offset;
-        size_t i = 0;
-        for (const sla::EncodedRaster &rst : m_layers) {
+        // The layer table precedes the images, thus the (compressed) images
+        // are collected while writing the table.
+        write_layers([&](size_t i, const sla::EncodedRaster &rst) {
             anycubicsla_format_layer l;
             std::memset(&l, 0, sizeof(l));
             l.image_offset = image_offset;
@@ -576,8 +631,7 @@ void AnycubicSLAArchive::export_print(const std::string     fname,
             const char* img_start = reinterpret_cast<const char*>(rst.data());
             const char* img_end = img_start + rst.size();
             std::copy(img_start, img_end, std::back_inserter(layer_images));
-            i++;
-        }
+        }, callbacks);
         const char* img_buffer = reinterpret_cast<const char*>(layer_images.data());
         out.write(img_buffer, layer_images.size());
         out.close();
@@ -36,6 +36,7 @@ class AnycubicSLAArchive: public SLAArchiveWriter {
 protected:
     std::unique_ptr<sla::RasterBase> create_raster() const override;
     sla::RasterEncoder get_encoder() const override;
+    sla::RasterRunsEncoder get_runs_encoder() const override;
 
     SLAPrinterConfig & cfg() { return m_cfg; }
     const SLAPrinterConfig & cfg() const { return m_cfg; }
@@ -56,7 +57,8 @@ public:
     void export_print(const std::string     fname,
                       const SLAPrint       &print,
                       const ThumbnailsList &thumbnails,
-                      const std::string    &projectname = "") override;
+                      const std::string    &projectname,
+                      const ExportCallbacks &callbacks) override;
 };
 
 inline Slic3r::ArchiveEntry anycubic_sla_format_versioned(const char *fileformat, const char *desc, uint16_t version)
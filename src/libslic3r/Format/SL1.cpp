@@ -274,7 +274,7 @@ std::unique_ptr<sla::RasterBase> SL1Archive::create_raster() const
 
     double gamma = m_cfg.gamma_correction.getFloat();
 
-    return sla::create_raster_grayscale_aa(res, pxdim, gamma, tr);
+    return sla::create_raster_grayscale_aa_runs(res, pxdim, gamma, tr);
 }
 
 sla::RasterEncoder SL1Archive::get_encoder() const
@@ -282,6 +282,11 @@ sla::RasterEncoder SL1Archive::get_encoder() const
     return sla::PNGRasterEncoder{};
 }
 
+sla::RasterRunsEncoder SL1Archive::get_runs_encoder() const
+{
+    return sla::PNGRasterEncoder{};
+}
+
 static void write_thumbnail(Zipper &zipper, const ThumbnailData &data)
 {
     size_t png_size = 0;
@@ -303,7 +308,8 @@ static void write_thumbnail(Zipper &zipper, const ThumbnailData &data)
 void SL1Archive::export_print(Zipper               &zipper,
                               const SLAPrint       &print,
                               const ThumbnailsList &thumbnails,
-                              const std::string    &prjname)
+                              const std::string    &prjname,
+                              const ExportCallbacks &callbacks)
 {
     std::string project =
         prjname.empty() ?
@@ -326,14 +332,12 @@ void SL1Archive::export_print(Zipper               &zipper,
         zipper.add_entry("config.json");
         zipper << to_json(print, iniconf);
 
-        size_t i = 0;
-        for (const sla::EncodedRaster &rst : m_layers) {
-
-            std::string imgname = project + string_printf("%.5d", i++) + "." +
+        write_layers([&zipper, &project](size_t i, const sla::EncodedRaster &rst) {
+            std::string imgname = project + string_printf("%.5d", int(i)) + "." +
                                   rst.extension();
 
             zipper.add_entry(imgname.c_str(), rst.data(), rst.size());
-        }
+        }, callbacks);
 
         for (const ThumbnailData& data : thumbnails)
             if (data.is_valid())
@@ -350,11 +354,12 @@ void SL1Archive::export_print(Zipper               &zipper,
 void SL1Archive::export_print(const std::string     fname,
                               const SLAPrint       &print,
                               const ThumbnailsList &thumbnails,
-                              const std::string    &prjname)
+                              const std::string    &prjname,
+                              const ExportCallbacks &callbacks)
 {
     Zipper zipper{fname, Zipper::FAST_COMPRESSION};
 
-    export_print(zipper, print, thumbnails, prjname);
+    export_print(zipper, print, thumbnails, prjname, callbacks);
 }
 
 } // namespace Slic3r
@@ -377,6 +382,12 @@ template<> struct _RasterTraits<Slic3r::png::ImageGreyscale> {
         return rst.get(row, col);
     }
 
+       // First pixel of a row, the image is stored row after row
+    static const uint8_t *row(const Rst &rst, size_t r)
+    {
+        return rst.buf.data() + r * rst.cols;
+    }
+
        // Number of rows and cols of the raster
     static size_t rows(const Rst &rst) { return rst.rows; }
     static size_t cols(const Rst &rst) { return rst.cols; }
@@ -21,6 +21,7 @@ class SL1Archive: public SLAArchiveWriter {
 protected:
     std::unique_ptr<sla::RasterBase> create_raster() const override;
     sla::RasterEncoder get_encoder() const override;
+    sla::RasterRunsEncoder get_runs_encoder() const override;
 
     SLAPrinterConfig & cfg() { return m_cfg; }
     const SLAPrinterConfig & cfg() const { return m_cfg; }
@@ -28,7 +29,8 @@ protected:
     void export_print(Zipper &,
                       const SLAPrint       &print,
                       const ThumbnailsList &thumbnails,
-                      const std::string    &projectname);
+                      const std::string    &projectname,
+                      const ExportCallbacks &callbacks);
 
 public:
 
@@ -39,7 +41,8 @@ public:
     void export_print(const std::string     fname,
                       const SLAPrint       &print,
                       const ThumbnailsList &thumbnails,
-                      const std::string    &projectname = "") override;
+                      const std::string    &projectname,
+                      const ExportCallbacks &callbacks) override;
 };
 
 class SL1Reader: public SLAArchiveReader {
@@ -33,7 +33,8 @@ public:
     void export_print(const std::string     fname,
                       const SLAPrint       &print,
                       const ThumbnailsList &thumbnails,
-                      const std::string    &projectname = "") override;
+                      const std::string    &projectname,
+                      const ExportCallbacks &callbacks) override;
 
     using SL1Archive::SL1Archive;
 };
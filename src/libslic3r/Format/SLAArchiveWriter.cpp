@@ -5,11 +5,56 @@
 ///|/
 #include "SLAArchiveWriter.hpp"
 
+#include <tbb/parallel_pipeline.h>
+#include <tbb/task_arena.h>
+#include <algorithm>
+#include <utility>
+
 #include "SLAArchiveFormatRegistry.hpp"
+#include "libslic3r/PrintBase.hpp"
 #include "libslic3r/PrintConfig.hpp"
 
 namespace Slic3r {
 
+void SLAArchiveWriter::write_layers(const WriteLayerFn &writefn, const ExportCallbacks &callbacks) const
+{
+    if (! m_drawfn)
+        return;
+
+    using EncodedLayer = std::pair<size_t, sla::EncodedRaster>;
+
+    // Number of layers in flight: enough to keep all the workers busy while
+    // the writer is compressing / writing, but not more.
+    const size_t window = 2 * size_t(std::max(tbb::this_task_arena::max_concurrency(), 1));
+
+    size_t next_layer = 0;
+    size_t layers_written = 0;
+    bool   canceled = false;
+    tbb::parallel_pipeline(window,
+        tbb::make_filter<void, size_t>(tbb::filter_mode::serial_in_order,
+            [this, &next_layer, &canceled, &callbacks](tbb::flow_control &fc) -> size_t {
+                if (next_layer == m_layer_num || (canceled = callbacks.cancelfn())) {
+                    fc.stop();
+                    return 0;
+                }
+                return next_layer ++;
+            }) &
+        tbb::make_filter<size_t, EncodedLayer>(tbb::filter_mode::parallel,
+            [this](size_t idx) -> EncodedLayer {
+                auto rst = create_raster();
+                m_drawfn(*rst, idx);
+                return { idx, rst->encode(get_encoder(), get_runs_encoder()) };
+            }) &
+        tbb::make_filter<EncodedLayer, void>(tbb::filter_mode::serial_in_order,
+            [this, &writefn, &layers_written, &callbacks](const EncodedLayer &layer) {
+                writefn(layer.first, layer.second);
+                callbacks.progressfn(++ layers_written, m_layer_num);
+            }));
+
+    if (canceled)
+        throw CanceledException();
+}
+
 std::unique_ptr<SLAArchiveWriter>
 SLAArchiveWriter::create(const std::string &archtype, const SLAPrinterConfig &cfg)
 {
@@ -10,6 +10,7 @@
 #include <memory>
 #include <string>
 #include <cstddef>
+#include <functional>
 
 #include "libslic3r/SLA/RasterBase.hpp"
 #include "libslic3r/Execution/ExecutionTBB.hpp"
@@ -22,42 +23,58 @@ class SLAPrint;
 class SLAPrinterConfig;
 
 class SLAArchiveWriter {
+public:
+    using DrawLayerFn = std::function<void(sla::RasterBase &raster, size_t lyrid)>;
+    using WriteLayerFn = std::function<void(size_t lyrid, const sla::EncodedRaster &rst)>;
+
+    // Callbacks of a running export, see write_layers().
+    struct ExportCallbacks {
+        // Returns true if the export shall be stopped.
+        std::function<bool()> cancelfn = []() { return false; };
+        // Called with the number of layers written into the archive so far.
+        std::function<void(size_t layers_written, size_t layer_count)> progressfn = [](size_t, size_t) {};
+    };
+
 protected:
-    std::vector<sla::EncodedRaster> m_layers;
+    // Layers to be rasterized while exporting, see draw_layers_on_export().
+    size_t      m_layer_num = 0;
+    DrawLayerFn m_drawfn;
 
     virtual std::unique_ptr<sla::RasterBase> create_raster() const = 0;
     virtual sla::RasterEncoder get_encoder() const = 0;
 
+    // Encoder of the rasters keeping pixel runs, see
+    // sla::create_raster_grayscale_aa_runs(). Empty if not supported.
+    virtual sla::RasterRunsEncoder get_runs_encoder() const { return {}; }
+
+    // Pass the encoded layers to writefn in the order of layers, serially.
+    // The layers are rasterized and encoded in parallel here, only a small
+    // window of layers ahead of writefn, so that the encoding overlaps with
+    // writing the archive and the raster memory stays bounded no matter
+    // the number of layers.
+    // Throws CanceledException if callbacks.cancelfn() returns true.
+    void write_layers(const WriteLayerFn &writefn, const ExportCallbacks &callbacks) const;
+
+    size_t layer_count() const { return m_layer_num; }
+
 public:
     virtual ~SLAArchiveWriter() = default;
 
-    // Fn have to be thread safe: void(sla::RasterBase& raster, size_t lyrid);
-    template<class Fn, class CancelFn, class EP = ExecutionTBB>
-    void draw_layers(
-        size_t     layer_num,
-        Fn &&      drawfn,
-        CancelFn cancelfn = []() { return false; },
-        const EP & ep       = {})
+    // Register the layers to be drawn by drawfn when exported, drawfn has
+    // to be thread safe. The layers are not kept in memory, see write_layers().
+    // drawfn has to stay valid until the next export.
+    void draw_layers_on_export(size_t layer_num, DrawLayerFn drawfn)
     {
-        m_layers.resize(layer_num);
-        execution::for_each(
-            ep, size_t(0), m_layers.size(),
-            [this, &drawfn, &cancelfn](size_t idx) {
-                if (cancelfn()) return;
-
-                sla::EncodedRaster &enc = m_layers[idx];
-                auto                rst = create_raster();
-                drawfn(*rst, idx);
-                enc = rst->encode(get_encoder());
-            },
-            execution::max_concurrency(ep));
+        m_layer_num = layer_num;
+        m_drawfn    = std::move(drawfn);
     }
 
     // Export the print into an archive using the provided filename.
     virtual void export_print(const std::string     fname,
                               const SLAPrint       &print,
                               const ThumbnailsList &thumbnails,
-                              const std::string    &projectname = "") = 0;
+                              const std::string    &projectname,
+                              const ExportCallbacks &callbacks) = 0;
 
     // Factory method to create an archiver instance
     static std::unique_ptr<SLAArchiveWriter> create(
@@ -1236,7 +1236,10 @@ void GCodeGenerator::_do_export(Print& print, GCodeOutputStream &file, Thumbnail
     std::function<void(void)> throw_if_canceled_func = [&print]() { print.throw_if_canceled();};
 
     const Seams::Params params{Seams::Placer::get_params(print.full_print_config())};
-    m_seam_placer.init(print.objects(), params, throw_if_canceled_func);
+    ModelInfo::VisibilityCachePtr &visibility_cache = print.seam_visibility_cache();
+    if (! visibility_cache)
+        visibility_cache.reset(new ModelInfo::VisibilityCache());
+    m_seam_placer.init(print.objects(), params, throw_if_canceled_func, visibility_cache.get());
 
     if (! (has_wipe_tower && print.config().single_extruder_multi_material_priming)) {
         // Set initial extruder only after custom start G-code.
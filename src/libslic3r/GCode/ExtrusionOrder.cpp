@@ -361,7 +361,8 @@ std::vector<SupportPath> get_support_extrusions(
                         entities_cache.emplace_back(ee);
             }
             std::vector<SupportPath> paths;
-            for (const ExtrusionEntityReference &entity_reference : chain_extrusion_references(entities)) {
+            // Support layers may consist of huge numbers of short extrusions, shorten the travels by a bounded 2-opt pass.
+            for (const ExtrusionEntityReference &entity_reference : chain_extrusion_references(entities, nullptr, false, true)) {
                 auto collection{dynamic_cast<const ExtrusionEntityCollection *>(&entity_reference.extrusion_entity())};
                 const bool is_interface{entity_reference.extrusion_entity().role() != ExtrusionRole::SupportMaterial};
                 if (collection != nullptr) {
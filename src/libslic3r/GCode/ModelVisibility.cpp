@@ -1,12 +1,16 @@
+#include <boost/functional/hash.hpp>
 #include <boost/log/trivial.hpp>
 #include <igl/Hit.h>
 #include <oneapi/tbb/blocked_range.h>
 #include <oneapi/tbb/parallel_for.h>
+#include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstdlib>
 
 #include "libslic3r/ShortEdgeCollapse.hpp"
 #include "libslic3r/GCode/ModelVisibility.hpp"
+#include "libslic3r/Print.hpp"
 #include "libslic3r/AABBTreeIndirect.hpp"
 #include "admesh/stl.h"
 #include "libslic3r/TriangleMesh.hpp"
@@ -137,20 +141,29 @@ std::vector<float> raycast_visibility(
                     Frame f;
                     f.set_from_z(normal);
 
-                    for (const auto &dir : precomputed_sample_directions) {
-                        Vec3f final_ray_dir = (f.to_world(dir));
-                        if (!model_contains_negative_parts) {
-                            igl::Hit hitpoint;
-                            // FIXME: This AABBTTreeIndirect query will not compile for float ray origin and
-                            // direction.
-                            Vec3d final_ray_dir_d = final_ray_dir.cast<double>();
-                            Vec3d ray_origin_d = (center + normal * 0.01f).cast<double>(); // start above surface.
-                            bool hit = AABBTreeIndirect::intersect_ray_first_hit(triangles.vertices,
-                                    triangles.indices, raycasting_tree, ray_origin_d, final_ray_dir_d, hitpoint);
-                            if (hit && its_face_normal(triangles, hitpoint.id).dot(final_ray_dir) <= 0) {
-                                result[s_idx] -= decrease_step;
-                            }
-                        } else { //TODO improve logic for order based boolean operations - consider order of volumes
+                    if (!model_contains_negative_parts) {
+                        // Rays of a sample share the origin and they cover a hemisphere, trace them in packets.
+                        constexpr size_t PacketSize = AABBTreeIndirect::RayPacketSize;
+                        std::array<Vec3d, PacketSize> ray_origins;
+                        std::array<Vec3d, PacketSize> ray_dirs;
+                        std::array<igl::Hit, PacketSize> hitpoints;
+                        // FIXME: This AABBTTreeIndirect query will not compile for float ray origin and
+                        // direction.
+                        ray_origins.fill((center + normal * 0.01f).cast<double>()); // start above surface.
+                        for (size_t dir_begin = 0; dir_begin < precomputed_sample_directions.size(); dir_begin += PacketSize) {
+                            const size_t num_rays = std::min(PacketSize, precomputed_sample_directions.size() - dir_begin);
+                            for (size_t i = 0; i < num_rays; ++i)
+                                ray_dirs[i] = f.to_world(precomputed_sample_directions[dir_begin + i]).cast<double>();
+                            if (AABBTreeIndirect::intersect_ray_packet_first_hit(triangles.vertices, triangles.indices,
+                                    raycasting_tree, ray_origins, ray_dirs, num_rays, hitpoints))
+                                for (size_t i = 0; i < num_rays; ++i)
+                                    if (hitpoints[i].id != -1 && its_face_normal(triangles, hitpoints[i].id).dot(ray_dirs[i].cast<float>()) <= 0) {
+                                        result[s_idx] -= decrease_step;
+                                    }
+                        }
+                    } else { //TODO improve logic for order based boolean operations - consider order of volumes
+                        for (const auto &dir : precomputed_sample_directions) {
+                            Vec3f final_ray_dir = (f.to_world(dir));
                             bool casting_from_negative_volume = samples.triangle_indices[s_idx]
                                     >= negative_volumes_start_index;
 
@@ -306,4 +319,85 @@ float Visibility::calculate_point_visibility(const Vec3f &position) const {
     return total_visibility / total_weight;
 }
 
+static bool same_params(const Visibility::Params &lhs, const Visibility::Params &rhs)
+{
+    return lhs.raycasting_visibility_samples_count == rhs.raycasting_visibility_samples_count &&
+        lhs.fast_decimation_triangle_count_target == rhs.fast_decimation_triangle_count_target &&
+        lhs.sqr_rays_per_sample_point == rhs.sqr_rays_per_sample_point;
+}
+
+static size_t mesh_hash(const TriangleMesh &mesh)
+{
+    size_t seed = 0;
+    boost::hash_combine(seed, mesh.its.vertices.size());
+    boost::hash_combine(seed, mesh.its.indices.size());
+    for (const Vec3f &v : mesh.its.vertices)
+        for (int c = 0; c < 3; ++c)
+            boost::hash_combine(seed, v(c));
+    for (const stl_triangle_vertex_indices &f : mesh.its.indices)
+        for (int c = 0; c < 3; ++c)
+            boost::hash_combine(seed, f(c));
+    return seed;
+}
+
+static bool same_mesh(const TriangleMesh &lhs, const TriangleMesh &rhs)
+{
+    return &lhs == &rhs || (lhs.its.vertices == rhs.its.vertices && lhs.its.indices == rhs.its.indices);
+}
+
+std::shared_ptr<const Visibility> VisibilityCache::get(
+    const Transform3d &obj_transform,
+    const ModelVolumePtrs &volumes,
+    const Visibility::Params &params,
+    const std::function<void(void)> &throw_if_canceled
+) {
+    std::vector<VolumeKey> volume_keys;
+    for (const ModelVolume *model_volume : volumes)
+        if (model_volume->type() == ModelVolumeType::MODEL_PART || model_volume->type() == ModelVolumeType::NEGATIVE_VOLUME)
+            volume_keys.push_back({model_volume->mesh_ptr(), mesh_hash(model_volume->mesh()), model_volume->get_matrix(), model_volume->type()});
+
+    auto matches = [&obj_transform, &params, &volume_keys](const Entry &entry) {
+        if (entry.obj_transform.matrix() != obj_transform.matrix() || ! same_params(entry.params, params) ||
+            entry.volumes.size() != volume_keys.size())
+            return false;
+        for (size_t i = 0; i < volume_keys.size(); ++i) {
+            const VolumeKey &lhs = entry.volumes[i];
+            const VolumeKey &rhs = volume_keys[i];
+            // The hashes differ for most of the changed meshes, the meshes are compared only if the hashes match.
+            if (lhs.type != rhs.type || lhs.matrix.matrix() != rhs.matrix.matrix() || lhs.mesh_hash != rhs.mesh_hash ||
+                ! same_mesh(*lhs.mesh, *rhs.mesh))
+                return false;
+        }
+        return true;
+    };
+
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    if (auto it = std::find_if(m_entries.begin(), m_entries.end(), matches); it != m_entries.end()) {
+        BOOST_LOG_TRIVIAL(debug) << "SeamPlacer: reusing cached visibility";
+        it->used = true;
+        return it->visibility;
+    }
+    auto visibility = std::make_shared<const Visibility>(obj_transform, volumes, params, throw_if_canceled);
+    m_entries.push_back({std::move(volume_keys), obj_transform, params, visibility});
+    return visibility;
+}
+
+void VisibilityCache::release_unused()
+{
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    m_entries.erase(std::remove_if(m_entries.begin(), m_entries.end(), [](const Entry &entry) { return ! entry.used; }), m_entries.end());
+    for (Entry &entry : m_entries)
+        entry.used = false;
+}
+
+void VisibilityCache::clear()
+{
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    m_entries.clear();
+}
+
+void VisibilityCacheDeleter::operator()(VisibilityCache *p) {
+    delete p;
+}
+
 }
@@ -3,6 +3,8 @@
 
 #include <stddef.h>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <vector>
 #include <cstddef>
 
@@ -52,5 +54,46 @@ struct Visibility
     float calculate_point_visibility(const Vec3f &position) const;
 };
 
+// Visibility of objects shared between the copies of an object and between the G-code exports.
+// The visibility only depends on the meshes and transformations of the model parts and negative volumes,
+// on the object transformation and on the visibility parameters, thus it survives re-slicing
+// if only the print settings change. The meshes are compared by content, not just by their pointers.
+class VisibilityCache
+{
+public:
+    std::shared_ptr<const Visibility> get(
+        const Transform3d &obj_transform,
+        const ModelVolumePtrs &volumes,
+        const Visibility::Params &params,
+        const std::function<void(void)> &throw_if_canceled
+    );
+
+    // Release the visibilities not requested by get() since the last call of release_unused().
+    void release_unused();
+    void clear();
+
+private:
+    struct VolumeKey
+    {
+        std::shared_ptr<const TriangleMesh> mesh;
+        // Hash of the mesh content, compared before the meshes themselves.
+        size_t mesh_hash;
+        Transform3d matrix;
+        ModelVolumeType type;
+    };
+    struct Entry
+    {
+        std::vector<VolumeKey> volumes;
+        Transform3d obj_transform;
+        Visibility::Params params;
+        std::shared_ptr<const Visibility> visibility;
+        bool used{true};
+    };
+
+    std::vector<Entry> m_entries;
+    std::mutex m_mutex;
+};
+
+
 } // namespace Slic3r::ModelInfo
 #endif // libslic3r_ModelVisibility_hpp_
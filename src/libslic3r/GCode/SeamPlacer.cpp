@@ -69,7 +69,8 @@ Perimeters::LayerPerimeters sort_to_layers(Shells::Shells<> &&shells) {
 ObjectSeams precalculate_seams(
     const Params &params,
     ObjectLayerPerimeters &&seam_data,
-    const std::function<void(void)> &throw_if_canceled
+    const std::function<void(void)> &throw_if_canceled,
+    Slic3r::ModelInfo::VisibilityCache *visibility_cache
 ) {
     ObjectSeams result;
 
@@ -79,11 +80,12 @@ ObjectSeams precalculate_seams(
             const Transform3d transformation{print_object->trafo_centered()};
             const ModelVolumePtrs &volumes{print_object->model_object()->volumes};
 
-            Slic3r::ModelInfo::Visibility
-                points_visibility{transformation, volumes, params.visibility, throw_if_canceled};
+            const std::shared_ptr<const Slic3r::ModelInfo::Visibility> points_visibility{visibility_cache ?
+                visibility_cache->get(transformation, volumes, params.visibility, throw_if_canceled) :
+                std::make_shared<const Slic3r::ModelInfo::Visibility>(transformation, volumes, params.visibility, throw_if_canceled)};
             throw_if_canceled();
             const Aligned::VisibilityCalculator visibility_calculator{
-                points_visibility, params.convex_visibility_modifier,
+                *points_visibility, params.convex_visibility_modifier,
                 params.concave_visibility_modifier};
 
             Shells::Shells<> shells{Shells::create_shells(std::move(layer_perimeters), params.max_distance)};
@@ -151,7 +153,8 @@ Params Placer::get_params(const DynamicPrintConfig &config) {
 void Placer::init(
     SpanOfConstPtrs<PrintObject> objects,
     const Params &params,
-    const std::function<void(void)> &throw_if_canceled
+    const std::function<void(void)> &throw_if_canceled,
+    Slic3r::ModelInfo::VisibilityCache *visibility_cache
 ) {
     BOOST_LOG_TRIVIAL(debug) << "SeamPlacer: init: start";
 
@@ -174,7 +177,10 @@ void Placer::init(
     }
 
     this->params = params;
-    this->seams_per_object = precalculate_seams(params, std::move(perimeters_for_precalculation), throw_if_canceled);
+    this->seams_per_object = precalculate_seams(params, std::move(perimeters_for_precalculation), throw_if_canceled, visibility_cache);
+    if (visibility_cache)
+        // Keep only the visibility of the objects of this print.
+        visibility_cache->release_unused();
 
     BOOST_LOG_TRIVIAL(debug) << "SeamPlacer: init: end";
 }
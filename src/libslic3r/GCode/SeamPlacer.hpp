@@ -47,10 +47,12 @@ class Placer
 public:
     static Params get_params(const DynamicPrintConfig &config);
 
+    // If visibility_cache is provided, the visibility of objects is reused from and stored into it.
     void init(
         SpanOfConstPtrs<PrintObject> objects,
         const Params &params,
-        const std::function<void(void)> &throw_if_canceled
+        const std::function<void(void)> &throw_if_canceled,
+        Slic3r::ModelInfo::VisibilityCache *visibility_cache = nullptr
     );
 
     Point place_seam(const Layer *layer, const ExtrusionLoop &loop, const Point &last_pos) const;
@@ -37,9 +37,12 @@ public:
     KDTreeIndirect(CoordinateFn coordinate) : coordinate(coordinate) {}
     KDTreeIndirect(CoordinateFn coordinate, std::vector<size_t> indices) : coordinate(coordinate) { this->build(indices); }
     KDTreeIndirect(CoordinateFn coordinate, size_t num_indices) : coordinate(coordinate) { this->build(num_indices); }
-    KDTreeIndirect(KDTreeIndirect &&rhs) : m_nodes(std::move(rhs.m_nodes)), coordinate(std::move(rhs.coordinate)) {}
-    KDTreeIndirect& operator=(KDTreeIndirect &&rhs) { m_nodes = std::move(rhs.m_nodes); coordinate = std::move(rhs.coordinate); return *this; }
-    void clear() { m_nodes.clear(); }
+    KDTreeIndirect(KDTreeIndirect &&rhs) : 
+        m_nodes(std::move(rhs.m_nodes)), m_live(std::move(rhs.m_live)), m_node_of_index(std::move(rhs.m_node_of_index)), coordinate(std::move(rhs.coordinate)) {}
+    KDTreeIndirect& operator=(KDTreeIndirect &&rhs) { 
+        m_nodes = std::move(rhs.m_nodes); m_live = std::move(rhs.m_live); m_node_of_index = std::move(rhs.m_node_of_index); coordinate = std::move(rhs.coordinate); return *this;
+    }
+    void clear() { m_nodes.clear(); m_live.clear(); m_node_of_index.clear(); }
 
     void build(size_t num_indices)
     {
@@ -58,10 +61,37 @@ public:
             // Allocate enough memory for a full binary tree.
             m_nodes.assign(next_highest_power_of_2(indices.size() + 1), npos);
             build_recursive(indices, 0, 0, 0, indices.size() - 1);
+            m_live.clear();
+            m_node_of_index.clear();
         }
         indices.clear();
     }
 
+    // Remove a point from the tree, so that it is no more passed to the visitors.
+    // The tree is not rebalanced: Subtrees with all their points removed are skipped during the traversal,
+    // a removed point with live points below it still splits the space, only its own visit is skipped.
+    // The first call allocates the bookkeeping in O(n), each call then costs O(log n).
+    void remove(size_t idx)
+    {
+        if (m_live.empty())
+            this->init_removal();
+        assert(idx < m_node_of_index.size());
+        size_t node = m_node_of_index[idx];
+        if (node == npos)
+            // Not in the tree or already removed.
+            return;
+        m_node_of_index[idx] = npos;
+        m_live[node] &= ~AliveBit;
+        for (;;) {
+            assert((m_live[node] & ~AliveBit) > 0);
+            -- m_live[node];
+            if (node == 0)
+                break;
+            node = (node - 1) / 2;
+        }
+    }
+    bool removed(size_t idx) const { return ! m_live.empty() && (idx >= m_node_of_index.size() || m_node_of_index[idx] == npos); }
+
     template<typename CoordType>
     unsigned int descent_mask(const CoordType &point_coord, const CoordType &search_radius, size_t idx, size_t dimension) const
     {
@@ -83,6 +113,30 @@ public:
     CoordinateFn coordinate;
 
 private:
+    // Set for a node, which point was not removed yet.
+    static constexpr size_t AliveBit = size_t(1) << (sizeof(size_t) * 8 - 1);
+
+    void init_removal()
+    {
+        m_live.assign(m_nodes.size(), 0);
+        size_t max_idx = 0;
+        for (size_t idx : m_nodes)
+            if (idx != npos)
+                max_idx = std::max(max_idx, idx);
+        m_node_of_index.assign(max_idx + 1, npos);
+        // Children are stored after their parents, accumulate the counts of live points bottom up.
+        for (size_t node = m_nodes.size(); node -- > 0;)
+            if (size_t idx = m_nodes[node]; idx != npos) {
+                m_node_of_index[idx] = node;
+                m_live[node] += 1;
+                if (node > 0)
+                    m_live[(node - 1) / 2] += m_live[node];
+            }
+        for (size_t node = 0; node < m_nodes.size(); ++ node)
+            if (m_nodes[node] != npos)
+                m_live[node] |= AliveBit;
+    }
+
     // Build a balanced tree by splitting the input sequence by an axis aligned plane at a dimension.
     void build_recursive(std::vector<size_t> &input, size_t node, const size_t dimension, const size_t left, const size_t right)
     {
@@ -180,7 +234,17 @@ private:
            // Left / right child node index.
         size_t left  = node * 2 + 1;
         size_t right = left + 1;
-        unsigned int mask = visitor(m_nodes[node], dimension);
+        unsigned int mask;
+        if (m_live.empty())
+            mask = visitor(m_nodes[node], dimension);
+        else if ((m_live[node] & ~AliveBit) == 0)
+            // All points of this subtree were removed.
+            return;
+        else if (m_live[node] & AliveBit)
+            mask = visitor(m_nodes[node], dimension);
+        else
+            // Point of this node was removed, continue with its subtrees.
+            mask = (unsigned int)VisitorReturnMask::CONTINUE_LEFT | (unsigned int)VisitorReturnMask::CONTINUE_RIGHT;
         if ((mask & (unsigned int)VisitorReturnMask::STOP) == 0) {
             size_t next_dimension = (++ dimension == NumDimensions) ? 0 : dimension;
             if (mask & (unsigned int)VisitorReturnMask::CONTINUE_LEFT)
@@ -191,6 +255,11 @@ private:
     }
 
     std::vector<size_t> m_nodes;
+    // Allocated by the first remove() call: Number of points not removed yet in the subtree of each node
+    // combined with AliveBit telling whether the point of the node itself is still alive.
+    std::vector<size_t> m_live;
+    // Allocated by the first remove() call: Node of a point index, npos if removed.
+    std::vector<size_t> m_node_of_index;
 };
 
 // Find a closest point using Euclidian metrics.
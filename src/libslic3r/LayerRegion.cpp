@@ -73,16 +73,19 @@ Flow LayerRegion::bridging_flow(FlowRole role, bool force_thick_bridges) const
 void LayerRegion::slices_to_fill_surfaces_clipped()
 {
     // Collect polygons per surface type.
-    std::array<std::vector<const Surface*>, size_t(stCount)> by_surface;
+    std::array<Polygons, size_t(stCount)> by_surface;
     for (const Surface &surface : this->slices())
-        by_surface[size_t(surface.surface_type)].emplace_back(&surface);
-    // Trim surfaces by the fill_boundaries.
+        polygons_append(by_surface[size_t(surface.surface_type)], surface.expolygon);
+    // Trim surfaces by the fill_boundaries, all the surface types in a single batch.
+    std::vector<const Polygons*> subjects;
+    subjects.reserve(by_surface.size());
+    for (const Polygons &polygons : by_surface)
+        subjects.emplace_back(&polygons);
+    std::vector<ExPolygons> trimmed = intersection_ex_batch(subjects, to_polygons(this->fill_expolygons()));
     m_fill_surfaces.surfaces.clear();
-    for (size_t surface_type = 0; surface_type < size_t(stCount); ++ surface_type) {
-        const std::vector<const Surface*> &this_surfaces = by_surface[surface_type];
-        if (! this_surfaces.empty())
-            m_fill_surfaces.append(intersection_ex(this_surfaces, this->fill_expolygons()), SurfaceType(surface_type));
-    }
+    for (size_t surface_type = 0; surface_type < size_t(stCount); ++ surface_type)
+        if (! trimmed[surface_type].empty())
+            m_fill_surfaces.append(std::move(trimmed[surface_type]), SurfaceType(surface_type));
 }
 
 // Produce perimeter extrusions, gap fill extrusions and fill polygons for input slices.
@@ -25,6 +25,7 @@ namespace Slic3r {
 
 class Layer;
 class PrintObject;
+class MMSegmentationCache;
 
 using LayerPtrs = std::vector<Layer*>;
 class PrintRegion;
@@ -154,7 +155,7 @@ private:
     // Modifying m_slices
     friend std::string fix_slicing_errors(LayerPtrs&, const std::function<void()>&);
     template<typename ThrowOnCancel>
-    friend void apply_mm_segmentation(PrintObject& print_object, ThrowOnCancel throw_on_cancel);
+    friend void apply_mm_segmentation(PrintObject& print_object, MMSegmentationCache *cache, ThrowOnCancel throw_on_cancel);
 
     Layer                      *m_layer;
     const PrintRegion          *m_region;
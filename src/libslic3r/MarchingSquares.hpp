@@ -9,6 +9,8 @@
 #include <cstdint>
 #include <vector>
 #include <algorithm>
+#include <numeric>
+#include <utility>
 #include <cassert>
 
 namespace marchsq {
@@ -41,6 +43,10 @@ template<class T, class Enable = void> struct _RasterTraits {
     // Number of rows and cols of the raster
     static size_t rows(const T &raster);
     static size_t cols(const T &raster);
+
+    // Optional: pointer to the first pixel of a continuously stored row.
+    // If present, the grid is tagged by reading whole rows at once.
+    // static const ValueType *row(const T &raster, size_t row);
 };
 
 // Specialize this to use parellel loops within the algorithm
@@ -71,10 +77,35 @@ template<class T> TRasterValue<T> isoval(const T &rst, const Coord &crd)
     return RasterTraits<T>::get(rst, crd.r, crd.c);
 }
 
+template<class T, class Enable = void>
+struct HasRowAccess : std::false_type {};
+
+template<class T>
+struct HasRowAccess<T, std::void_t<decltype(RasterTraits<T>::row(
+                           std::declval<const T &>(), size_t(0)))>>
+    : std::true_type {};
+
+// Threshold every stride-th pixel of a raster row into out[0..n), one byte
+// (0 or 1) per sample. Rasters with row access get a tight loop over the row
+// buffer. The samples are at least two pixels apart, so the loop is a
+// strided gather and is not vectorized.
+template<class T>
+void threshold_row(const T &rst, size_t row, size_t stride,
+                   TRasterValue<T> v, uint8_t *out, size_t n)
+{
+    if constexpr (HasRowAccess<T>::value) {
+        const TRasterValue<T> *px = RasterTraits<T>::row(rst, row);
+        for (size_t i = 0; i < n; ++i) out[i] = px[i * stride] >= v;
+    } else {
+        for (size_t i = 0; i < n; ++i)
+            out[i] = RasterTraits<T>::get(rst, row, i * stride) >= v;
+    }
+}
+
 template<class ExecutionPolicy, class It, class Fn>
 void for_each(ExecutionPolicy&& policy, It from, It to, Fn &&fn)
 {
-    _Loop<ExecutionPolicy>::for_each(from, to, fn);
+    _Loop<std::decay_t<ExecutionPolicy>>::for_each(from, to, fn);
 }
 
 // Type of squares (tiles) depending on which vertices are inside an ROI
@@ -342,17 +373,61 @@ public:
         , m_tags(m_gridsize.r * m_gridsize.c, 0)
     {}
     
-    // Go through the cells and mark them with the appropriate tag.
+    // Tags of the cells in row-major order, the low four bits hold the
+    // SquareTag of a cell.
+    const std::vector<uint8_t> &tags() const { return m_tags; }
+
+    // Mark every cell with its tag, reading the four corners of each cell.
     template<class ExecutionPolicy>
-    void tag_grid(ExecutionPolicy &&policy, TRasterValue<Rst> isoval)
-    {        
-        // parallel for r
-        for_each (std::forward<ExecutionPolicy>(policy),
-                 m_tags.begin(), m_tags.end(),
+    void tag_cells(ExecutionPolicy &&policy, TRasterValue<Rst> isoval)
+    {
+        for_each (policy, m_tags.begin(), m_tags.end(),
                  [this, isoval](uint8_t& tag, size_t idx) {
             tag = get_tag_for_cell(coord(idx), isoval);
         });
     }
+
+    // Go through the cells and mark them with the appropriate tag.
+    template<class ExecutionPolicy>
+    void tag_grid(ExecutionPolicy &&policy, TRasterValue<Rst> isoval)
+    {
+        // The corners of the cells only form a shared lattice if neighboring
+        // cells overlap in exactly one pixel. Otherwise tag cell by cell.
+        if (m_res_1.r != m_window.r || m_res_1.c != m_window.c) {
+            tag_cells(policy, isoval);
+            return;
+        }
+
+        const long R = rows(*m_rst), C = cols(*m_rst);
+        const long LC = m_gridsize.c + 1;
+        const long nsamples = std::min(LC - 1, (C - 1) / m_window.c + 1);
+
+        // Thresholded raster samples at the cell corners, row by row. The
+        // first row and column stand for the corners before the raster and
+        // stay zero, as do the samples past its end.
+        std::vector<uint8_t> lattice((m_gridsize.r + 1) * LC, 0);
+        std::vector<long> gridrows(m_gridsize.r);
+        std::iota(gridrows.begin(), gridrows.end(), 0l);
+
+        for_each (policy, gridrows.begin(), gridrows.end(),
+                 [this, isoval, R, LC, nsamples, &lattice](long i, size_t) {
+            long r = i * m_window.r;
+            if (r < R)
+                threshold_row(*m_rst, r, m_window.c, isoval,
+                              &lattice[(i + 1) * LC + 1], nsamples);
+        });
+
+        // Cell (r, c) has its top corners in lattice row r and its bottom
+        // corners in row r + 1, left corners in column c, right ones in c + 1
+        for_each (policy, gridrows.begin(), gridrows.end(),
+                 [this, LC, &lattice](long r, size_t) {
+            const uint8_t *top = &lattice[r * LC], *bottom = top + LC;
+            uint8_t *tags = &m_tags[r * m_gridsize.c];
+            for (long c = 0; c < m_gridsize.c; ++c)
+                tags[c] = bottom[c] | (bottom[c + 1] << 1) |
+                          (top[c + 1] << 2) | (top[c] << 3);
+        });
+    }
     
     // Scan for the rings on the tagged grid. Each ring vertex stores the
     // sequential index of the cell and the next direction (Dir).
@@ -382,7 +457,7 @@ public:
             
             if (ring.size() > 1) {
                 ring.pop_back();
-                rings.emplace_back(ring);
+                rings.emplace_back(std::move(ring));
             }
         }
         
@@ -16,6 +16,7 @@
 #include <functional>
 #include <limits>
 #include <queue>
+#include <tuple>
 #include <vector>
 #include <cassert>
 #include <cstdlib>
@@ -883,29 +884,35 @@ static bool is_volume_sinking(const indexed_triangle_set &its, const Transform3d
     return false;
 }
 
-// Returns MM segmentation of top and bottom layers based on painting in MM segmentation gizmo
-static inline std::vector<std::vector<ExPolygons>> mm_segmentation_top_and_bottom_layers(const PrintObject             &print_object,
-                                                                                         const std::vector<ExPolygons> &input_expolygons,
-                                                                                         const std::function<void()>   &throw_on_cancel_callback)
+// Painted triangles projected over top / bottom surfaces, indexed by color and layer.
+// The vector of a color is empty if no triangle of that color was projected.
+struct TopAndBottomProjection
+{
+    std::vector<std::vector<Polygons>> top;
+    std::vector<std::vector<Polygons>> bottom;
+};
+
+// Project upwards pointing painted triangles over top surfaces,
+// project downards pointing painted triangles over bottom surfaces.
+static TopAndBottomProjection mm_segmentation_project_top_and_bottom(const PrintObject &print_object, const std::function<void()> &throw_on_cancel_callback)
 {
     const size_t num_extruders = print_object.print()->config().nozzle_diameter.size() + 1;
-    const size_t num_layers    = input_expolygons.size();
+    const size_t num_layers    = print_object.layers().size();
     const SpanOfConstPtrs<Layer> layers = print_object.layers();
 
-    // Maximum number of top / bottom layers accounts for maximum overlap of one thread group into a neighbor thread group.
     int max_top_layers = 0;
     int max_bottom_layers = 0;
-    int granularity = 1;
     for (size_t i = 0; i < print_object.num_printing_regions(); ++ i) {
         const PrintRegionConfig &config = print_object.printing_region(i).config();
         max_top_layers    = std::max(max_top_layers, config.top_solid_layers.value);
         max_bottom_layers = std::max(max_bottom_layers, config.bottom_solid_layers.value);
-        granularity       = std::max(granularity, std::max(config.top_solid_layers.value, config.bottom_solid_layers.value) - 1);
     }
 
-    // Project upwards pointing painted triangles over top surfaces,
-    // project downards pointing painted triangles over bottom surfaces.
-    std::vector<std::vector<Polygons>> top_raw(num_extruders), bottom_raw(num_extruders);
+    TopAndBottomProjection projection;
+    std::vector<std::vector<Polygons>> &top_raw    = projection.top;
+    std::vector<std::vector<Polygons>> &bottom_raw = projection.bottom;
+    top_raw.assign(num_extruders, {});
+    bottom_raw.assign(num_extruders, {});
     std::vector<float> zs = zs_from_layers(layers);
     Transform3d        object_trafo = print_object.trafo_centered();
 
@@ -1003,56 +1010,122 @@ static inline std::vector<std::vector<ExPolygons>> mm_segmentation_top_and_botto
     }
 #endif // MM_SEGMENTATION_DEBUG_TOP_BOTTOM
 
+    return projection;
+}
+
+struct LayerColorStat {
+    // Number of regions for a queried color.
+    int     num_regions             { 0 };
+    // Maximum perimeter extrusion width for a queried color.
+    float   extrusion_width         { 0.f };
+    // Minimum radius of a region to be printable. Used to filter regions by morphological opening.
+    float   small_region_threshold  { 0.f };
+    // Maximum number of top layers for a queried color.
+    int     top_solid_layers        { 0 };
+    // Maximum number of bottom layers for a queried color.
+    int     bottom_solid_layers     { 0 };
+
+    bool operator==(const LayerColorStat &rhs) const {
+        return num_regions == rhs.num_regions && extrusion_width == rhs.extrusion_width && small_region_threshold == rhs.small_region_threshold &&
+               top_solid_layers == rhs.top_solid_layers && bottom_solid_layers == rhs.bottom_solid_layers;
+    }
+};
+
+static LayerColorStat layer_color_stat(const Layer &layer, const size_t color_idx)
+{
+    LayerColorStat out;
+    for (const LayerRegion *region : layer.regions())
+        if (const PrintRegionConfig &config = region->region().config();
+            // color_idx == 0 means "don't know" extruder aka the underlying extruder.
+            // As this region may split existing regions, we collect statistics over all regions for color_idx == 0.
+            color_idx == 0 || config.perimeter_extruder == int(color_idx)) {
+            out.extrusion_width     = std::max<float>(out.extrusion_width, float(config.perimeter_extrusion_width));
+            out.top_solid_layers    = std::max<int>(out.top_solid_layers, config.top_solid_layers);
+            out.bottom_solid_layers = std::max<int>(out.bottom_solid_layers, config.bottom_solid_layers);
+            out.small_region_threshold = config.gap_fill_enabled.value && config.gap_fill_speed.value > 0 ?
+                                         // Gap fill enabled. Enable a single line of 1/2 extrusion width.
+                                         0.5f * float(config.perimeter_extrusion_width) :
+                                         // Gap fill disabled. Enable two lines slightly overlapping.
+                                         float(config.perimeter_extrusion_width) + 0.7f * Flow::rounded_rectangle_extrusion_spacing(float(config.perimeter_extrusion_width), float(layer.height));
+            out.small_region_threshold = scaled<float>(out.small_region_threshold * 0.5f);
+            ++ out.num_regions;
+        }
+    assert(out.num_regions > 0);
+    out.extrusion_width = scaled<float>(out.extrusion_width);
+    return out;
+}
+
+// Statistics of all layers and colors, indexed by layer_idx * num_colors + color_idx.
+static std::vector<LayerColorStat> layer_color_stats(const SpanOfConstPtrs<Layer> layers, const size_t num_colors, const std::function<void()> &throw_on_cancel_callback)
+{
+    std::vector<LayerColorStat> out(layers.size() * num_colors);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, layers.size()), [&layers, &num_colors, &out, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+        for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx) {
+            throw_on_cancel_callback();
+            for (size_t color_idx = 0; color_idx < num_colors; ++ color_idx)
+                out[layer_idx * num_colors + color_idx] = layer_color_stat(*layers[layer_idx], color_idx);
+        }
+    });
+    return out;
+}
+
+// Returns MM segmentation of top and bottom layers based on painting in MM segmentation gizmo.
+// Only layers marked in layers_to_update are filled in.
+static inline std::vector<std::vector<ExPolygons>> mm_segmentation_top_and_bottom_layers(const PrintObject                 &print_object,
+                                                                                         const std::vector<ExPolygons>     &input_expolygons,
+                                                                                         const TopAndBottomProjection      &projection,
+                                                                                         const std::vector<LayerColorStat> &color_stats,
+                                                                                         const std::vector<uint8_t>        &layers_to_update,
+                                                                                         const std::function<void()>       &throw_on_cancel_callback)
+{
+    const size_t num_extruders = print_object.print()->config().nozzle_diameter.size() + 1;
+    const size_t num_layers    = input_expolygons.size();
+    const std::vector<std::vector<Polygons>> &top_raw    = projection.top;
+    const std::vector<std::vector<Polygons>> &bottom_raw = projection.bottom;
+    assert(color_stats.size() == num_layers * num_extruders);
+    assert(layers_to_update.size() == num_layers);
+
+    // Maximum number of top / bottom layers accounts for maximum overlap of one thread group into a neighbor thread group.
+    int max_top_layers = 0;
+    int max_bottom_layers = 0;
+    int granularity = 1;
+    for (size_t i = 0; i < print_object.num_printing_regions(); ++ i) {
+        const PrintRegionConfig &config = print_object.printing_region(i).config();
+        max_top_layers    = std::max(max_top_layers, config.top_solid_layers.value);
+        max_bottom_layers = std::max(max_bottom_layers, config.bottom_solid_layers.value);
+        granularity       = std::max(granularity, std::max(config.top_solid_layers.value, config.bottom_solid_layers.value) - 1);
+    }
+
+    // A layer projects its top surfaces up to max_top_layers below and its bottom surfaces up to max_bottom_layers above,
+    // thus only the layers, which could reach any of the layers to be updated, are processed.
+    std::vector<uint8_t> source_layers(num_layers, false);
+    {
+        std::vector<int> num_updated(num_layers + 1, 0);
+        for (size_t layer_idx = 0; layer_idx < num_layers; ++ layer_idx)
+            num_updated[layer_idx + 1] = num_updated[layer_idx] + int(layers_to_update[layer_idx] != 0);
+        for (size_t layer_idx = 0; layer_idx < num_layers; ++ layer_idx) {
+            size_t first = size_t(std::max(int(layer_idx) - max_top_layers, 0));
+            size_t last  = std::min(layer_idx + size_t(std::max(max_bottom_layers, 0)), num_layers - 1);
+            source_layers[layer_idx] = num_updated[last + 1] > num_updated[first];
+        }
+    }
+
     std::vector<std::vector<ExPolygons>> triangles_by_color_bottom(num_extruders);
     std::vector<std::vector<ExPolygons>> triangles_by_color_top(num_extruders);
     triangles_by_color_bottom.assign(num_extruders, std::vector<ExPolygons>(num_layers * 2));
     triangles_by_color_top.assign(num_extruders, std::vector<ExPolygons>(num_layers * 2));
 
-    struct LayerColorStat {
-        // Number of regions for a queried color.
-        int     num_regions             { 0 };
-        // Maximum perimeter extrusion width for a queried color.
-        float   extrusion_width         { 0.f };
-        // Minimum radius of a region to be printable. Used to filter regions by morphological opening.
-        float   small_region_threshold  { 0.f };
-        // Maximum number of top layers for a queried color.
-        int     top_solid_layers        { 0 };
-        // Maximum number of bottom layers for a queried color.
-        int     bottom_solid_layers     { 0 };
-    };
-    auto layer_color_stat = [&layers = std::as_const(layers)](const size_t layer_idx, const size_t color_idx) -> LayerColorStat {
-        LayerColorStat out;
-        const Layer &layer = *layers[layer_idx];
-        for (const LayerRegion *region : layer.regions())
-            if (const PrintRegionConfig &config = region->region().config();
-                // color_idx == 0 means "don't know" extruder aka the underlying extruder.
-                // As this region may split existing regions, we collect statistics over all regions for color_idx == 0.
-                color_idx == 0 || config.perimeter_extruder == int(color_idx)) {
-                out.extrusion_width     = std::max<float>(out.extrusion_width, float(config.perimeter_extrusion_width));
-                out.top_solid_layers    = std::max<int>(out.top_solid_layers, config.top_solid_layers);
-                out.bottom_solid_layers = std::max<int>(out.bottom_solid_layers, config.bottom_solid_layers);
-                out.small_region_threshold = config.gap_fill_enabled.value && config.gap_fill_speed.value > 0 ?
-                                             // Gap fill enabled. Enable a single line of 1/2 extrusion width.
-                                             0.5f * float(config.perimeter_extrusion_width) :
-                                             // Gap fill disabled. Enable two lines slightly overlapping.
-                                             float(config.perimeter_extrusion_width) + 0.7f * Flow::rounded_rectangle_extrusion_spacing(float(config.perimeter_extrusion_width), float(layer.height));
-                out.small_region_threshold = scaled<float>(out.small_region_threshold * 0.5f);
-                ++ out.num_regions;
-            }
-        assert(out.num_regions > 0);
-        out.extrusion_width = scaled<float>(out.extrusion_width);
-        return out;
-    };
-
-    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_layers, granularity), [&granularity, &num_layers, &num_extruders, &layer_color_stat, &top_raw, &triangles_by_color_top,
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_layers, granularity), [&granularity, &num_layers, &num_extruders, &color_stats, &source_layers, &top_raw, &triangles_by_color_top,
                                                                                &throw_on_cancel_callback, &input_expolygons, &bottom_raw, &triangles_by_color_bottom](const tbb::blocked_range<size_t> &range) {
         size_t group_idx   = range.begin() / granularity;
         size_t layer_idx_offset = (group_idx & 1) * num_layers;
         for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx) {
+            if (! source_layers[layer_idx])
+                continue;
             for (size_t color_idx = 0; color_idx < num_extruders; ++ color_idx) {
                 throw_on_cancel_callback();
-                LayerColorStat stat = layer_color_stat(layer_idx, color_idx);
-                if (std::vector<Polygons> &top = top_raw[color_idx]; ! top.empty() && ! top[layer_idx].empty())
+                const LayerColorStat &stat = color_stats[layer_idx * num_extruders + color_idx];
+                if (const std::vector<Polygons> &top = top_raw[color_idx]; ! top.empty() && ! top[layer_idx].empty())
                     if (ExPolygons top_ex = union_ex(top[layer_idx]); ! top_ex.empty()) {
                         // Clean up thin projections. They are not printable anyways.
                         if (stat.small_region_threshold > 0)
@@ -1073,7 +1146,7 @@ static inline std::vector<std::vector<ExPolygons>> mm_segmentation_top_and_botto
                             }
                         }
                     }
-                if (std::vector<Polygons> &bottom = bottom_raw[color_idx]; ! bottom.empty() && ! bottom[layer_idx].empty())
+                if (const std::vector<Polygons> &bottom = bottom_raw[color_idx]; ! bottom.empty() && ! bottom[layer_idx].empty())
                     if (ExPolygons bottom_ex = union_ex(bottom[layer_idx]); ! bottom_ex.empty()) {
                         // Clean up thin projections. They are not printable anyways.
                         if (stat.small_region_threshold > 0)
@@ -1100,9 +1173,11 @@ static inline std::vector<std::vector<ExPolygons>> mm_segmentation_top_and_botto
 
     std::vector<std::vector<ExPolygons>> triangles_by_color_merged(num_extruders);
     triangles_by_color_merged.assign(num_extruders, std::vector<ExPolygons>(num_layers));
-    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_layers), [&triangles_by_color_merged, &triangles_by_color_bottom, &triangles_by_color_top, &num_layers, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_layers), [&triangles_by_color_merged, &triangles_by_color_bottom, &triangles_by_color_top, &layers_to_update, &num_layers, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
         for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx) {
             throw_on_cancel_callback();
+            if (! layers_to_update[layer_idx])
+                continue;
             for (size_t color_idx = 0; color_idx < triangles_by_color_merged.size(); ++color_idx) {
                 auto &self = triangles_by_color_merged[color_idx][layer_idx];
                 append(self, std::move(triangles_by_color_bottom[color_idx][layer_idx]));
@@ -1121,20 +1196,25 @@ static inline std::vector<std::vector<ExPolygons>> mm_segmentation_top_and_botto
     return triangles_by_color_merged;
 }
 
+// Only layers marked in layers_to_update are merged, the other layers are left empty.
 static std::vector<std::vector<ExPolygons>> merge_segmented_layers(
     const std::vector<std::vector<ExPolygons>> &segmented_regions,
     std::vector<std::vector<ExPolygons>>     &&top_and_bottom_layers,
     const size_t                               num_extruders,
+    const std::vector<uint8_t>                &layers_to_update,
     const std::function<void()>               &throw_on_cancel_callback)
 {
     const size_t                         num_layers = segmented_regions.size();
     std::vector<std::vector<ExPolygons>> segmented_regions_merged(num_layers);
     segmented_regions_merged.assign(num_layers, std::vector<ExPolygons>(num_extruders));
     assert(num_extruders + 1 == top_and_bottom_layers.size());
+    assert(layers_to_update.size() == num_layers);
 
     BOOST_LOG_TRIVIAL(debug) << "MM segmentation - merging segmented layers in parallel - begin";
-    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_layers), [&segmented_regions, &top_and_bottom_layers, &segmented_regions_merged, &num_extruders, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_layers), [&segmented_regions, &top_and_bottom_layers, &segmented_regions_merged, &num_extruders, &layers_to_update, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
         for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++layer_idx) {
+            if (! layers_to_update[layer_idx])
+                continue;
             assert(segmented_regions[layer_idx].size() == num_extruders + 1);
             // Zero is skipped because it is the default color of the volume
             for (size_t extruder_id = 1; extruder_id < num_extruders + 1; ++extruder_id) {
@@ -1248,7 +1328,135 @@ static bool has_layer_only_one_color(const std::vector<ColoredLines> &colored_po
     return true;
 }
 
-std::vector<std::vector<ExPolygons>> multi_material_segmentation_by_painting(const PrintObject &print_object, const std::function<void()> &throw_on_cancel_callback)
+struct MMSegmentationCache::Entry
+{
+    // Key of the entry.
+    ObjectID                                model_object_id;
+    Transform3d                             trafo;
+    // Inputs, which are shared by all layers. If any of them changes, all the layers are segmented again.
+    bool                                    valid { false };
+    size_t                                  num_extruders { 0 };
+    float                                   cut_width { 0.f };
+    float                                   interlocking_depth { 0.f };
+    std::vector<LayerColorStat>             color_stats;
+    std::vector<ExPolygons>                 input_expolygons;
+    // Painted lines projected to contours of each layer, sorted by painted_line_lower().
+    std::vector<std::vector<PaintedLine>>   painted_lines;
+    // Painted triangles projected over top / bottom surfaces, normalized by normalize_projected_polygons().
+    TopAndBottomProjection                  top_and_bottom;
+    // Segmentation of the sides (after cutting), indexed by layer and color.
+    std::vector<std::vector<ExPolygons>>    segmented_regions;
+    // The resulting segmentation, indexed by layer and extruder.
+    std::vector<std::vector<ExPolygons>>    segmented_regions_merged;
+    // Layers segmented again by the last segmentation, the other layers were taken over from the cache.
+    std::vector<uint8_t>                    layers_updated;
+};
+
+MMSegmentationCache::MMSegmentationCache() = default;
+MMSegmentationCache::~MMSegmentationCache() = default;
+
+MMSegmentationCache::Entry& MMSegmentationCache::entry(const PrintObject &print_object)
+{
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    const ObjectID     model_object_id = print_object.model_object()->id();
+    const Transform3d &trafo           = print_object.trafo_centered();
+    for (std::unique_ptr<Entry> &entry : m_entries)
+        if (entry->model_object_id == model_object_id && entry->trafo.matrix() == trafo.matrix())
+            return *entry;
+    m_entries.emplace_back(std::make_unique<Entry>());
+    m_entries.back()->model_object_id = model_object_id;
+    m_entries.back()->trafo           = trafo;
+    return *m_entries.back();
+}
+
+void MMSegmentationCache::release_unused(const std::vector<PrintObject*> &print_objects)
+{
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    m_entries.erase(std::remove_if(m_entries.begin(), m_entries.end(), [&print_objects](const std::unique_ptr<Entry> &entry) {
+        return std::none_of(print_objects.begin(), print_objects.end(), [&entry](const PrintObject *print_object) {
+            return print_object->model_object()->id() == entry->model_object_id && print_object->trafo_centered().matrix() == entry->trafo.matrix();
+        });
+    }), m_entries.end());
+}
+
+void MMSegmentationCache::clear()
+{
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    m_entries.clear();
+}
+
+std::vector<size_t> MMSegmentationCache::updated_layers(const PrintObject &print_object)
+{
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    std::vector<size_t> out;
+    for (const std::unique_ptr<Entry> &entry : m_entries)
+        if (entry->model_object_id == print_object.model_object()->id() && entry->trafo.matrix() == print_object.trafo_centered().matrix()) {
+            for (size_t layer_idx = 0; layer_idx < entry->layers_updated.size(); ++layer_idx)
+                if (entry->layers_updated[layer_idx])
+                    out.emplace_back(layer_idx);
+            break;
+        }
+    return out;
+}
+
+// Total order of painted lines, so that painted lines of a layer could be compared between two segmentation runs.
+static bool painted_line_lower(const PaintedLine &l, const PaintedLine &r)
+{
+    return std::make_tuple(l.contour_idx, l.line_idx, l.projected_line.a.x(), l.projected_line.a.y(), l.projected_line.b.x(), l.projected_line.b.y(), l.color) <
+           std::make_tuple(r.contour_idx, r.line_idx, r.projected_line.a.x(), r.projected_line.a.y(), r.projected_line.b.x(), r.projected_line.b.y(), r.color);
+}
+
+static bool painted_lines_equal(const std::vector<PaintedLine> &l, const std::vector<PaintedLine> &r)
+{
+    return std::equal(l.begin(), l.end(), r.begin(), r.end(), [](const PaintedLine &pl, const PaintedLine &pr) {
+        return pl.contour_idx == pr.contour_idx && pl.line_idx == pr.line_idx && pl.projected_line == pr.projected_line && pl.color == pr.color;
+    });
+}
+
+// Polygons projected from the same painted triangles may differ in order and in their starting points after an unrelated
+// part of the painting was modified. Rotate each polygon to start at its lowest point and sort them, so they could be compared.
+static void normalize_projected_polygons(std::vector<std::vector<Polygons>> &projected, const std::function<void()> &throw_on_cancel_callback)
+{
+    auto point_lower = [](const Point &l, const Point &r) { return l.x() < r.x() || (l.x() == r.x() && l.y() < r.y()); };
+    for (std::vector<Polygons> &by_layer : projected)
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, by_layer.size()), [&by_layer, &point_lower, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+            throw_on_cancel_callback();
+            for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx) {
+                Polygons &polygons = by_layer[layer_idx];
+                for (Polygon &polygon : polygons)
+                    std::rotate(polygon.points.begin(), std::min_element(polygon.points.begin(), polygon.points.end(), point_lower), polygon.points.end());
+                std::sort(polygons.begin(), polygons.end(), [&point_lower](const Polygon &l, const Polygon &r) {
+                    return std::lexicographical_compare(l.points.begin(), l.points.end(), r.points.begin(), r.points.end(), point_lower);
+                });
+            }
+        });
+}
+
+// Marks layers, from which differently painted top or bottom surfaces are projected.
+static std::vector<uint8_t> top_and_bottom_projection_changed(const TopAndBottomProjection &projection, const TopAndBottomProjection &cached, const size_t num_layers)
+{
+    std::vector<uint8_t> out(num_layers, false);
+    auto mark = [&out, num_layers](const std::vector<std::vector<Polygons>> &by_color, const std::vector<std::vector<Polygons>> &by_color_cached) {
+        assert(by_color.size() == by_color_cached.size());
+        for (size_t color_idx = 0; color_idx < by_color.size(); ++ color_idx) {
+            const std::vector<Polygons> &now = by_color[color_idx];
+            const std::vector<Polygons> &old = by_color_cached[color_idx];
+            if (now.empty() && old.empty())
+                continue;
+            for (size_t layer_idx = 0; layer_idx < num_layers; ++ layer_idx) {
+                bool now_empty = now.empty() || now[layer_idx].empty();
+                bool old_empty = old.empty() || old[layer_idx].empty();
+                if (now_empty != old_empty || (! now_empty && now[layer_idx] != old[layer_idx]))
+                    out[layer_idx] = true;
+            }
+        }
+    };
+    mark(projection.top,    cached.top);
+    mark(projection.bottom, cached.bottom);
+    return out;
+}
+
+std::vector<std::vector<ExPolygons>> multi_material_segmentation_by_painting(const PrintObject &print_object, const std::function<void()> &throw_on_cancel_callback, MMSegmentationCache *cache)
 {
     const size_t                          num_extruders = print_object.print()->config().nozzle_diameter.size();
     const size_t                          num_layers    = print_object.layers().size();
@@ -1402,11 +1610,35 @@ std::vector<std::vector<ExPolygons>> multi_material_segmentation_by_painting(con
     BOOST_LOG_TRIVIAL(debug) << "MM segmentation - painted layers count: "
                              << std::count_if(painted_lines.begin(), painted_lines.end(), [](const std::vector<PaintedLine> &pl) { return !pl.empty(); });
 
+    const float                 cut_width          = std::max(float(scale_(print_object.config().mmu_segmented_region_max_width)), 0.f);
+    const float                 interlocking_depth = float(scale_(print_object.config().mmu_segmented_region_interlocking_depth));
+    std::vector<LayerColorStat> color_stats        = layer_color_stats(layers, num_extruders + 1, throw_on_cancel_callback);
+
+    // Only the layers, which are painted differently than during the last segmentation of this object, are segmented again.
+    MMSegmentationCache::Entry *cached = cache ? &cache->entry(print_object) : nullptr;
+    const bool cache_valid = cached && cached->valid && cached->num_extruders == num_extruders && cached->cut_width == cut_width &&
+        cached->interlocking_depth == interlocking_depth && cached->color_stats == color_stats && cached->input_expolygons == input_expolygons;
+    std::vector<uint8_t> side_to_update(num_layers, true);
+    std::vector<std::vector<PaintedLine>> painted_lines_sorted;
+    if (cached) {
+        painted_lines_sorted.assign(num_layers, {});
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, num_layers), [&painted_lines, &painted_lines_sorted, &side_to_update, cached, cache_valid, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+            for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++layer_idx) {
+                throw_on_cancel_callback();
+                // The order of painted lines depends on scheduling of the projection, make it deterministic.
+                std::sort(painted_lines[layer_idx].begin(), painted_lines[layer_idx].end(), painted_line_lower);
+                painted_lines_sorted[layer_idx] = painted_lines[layer_idx];
+                side_to_update[layer_idx] = ! cache_valid || ! painted_lines_equal(painted_lines[layer_idx], cached->painted_lines[layer_idx]);
+            }
+        });
+        BOOST_LOG_TRIVIAL(debug) << "MM segmentation - side layers to update: " << std::count(side_to_update.begin(), side_to_update.end(), true);
+    }
+
     BOOST_LOG_TRIVIAL(debug) << "MM segmentation - layers segmentation in parallel - begin";
-    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_layers), [&edge_grids, &input_expolygons, &painted_lines, &segmented_regions, &num_extruders, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_layers), [&edge_grids, &input_expolygons, &painted_lines, &side_to_update, &segmented_regions, &num_extruders, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
         for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++layer_idx) {
             throw_on_cancel_callback();
-            if (!painted_lines[layer_idx].empty()) {
+            if (side_to_update[layer_idx] && !painted_lines[layer_idx].empty()) {
 #ifdef MM_SEGMENTATION_DEBUG_PAINTED_LINES
                 export_painted_lines_to_svg(debug_out_path("mm-painted-lines-%d-%d.svg", layer_idx, iRun), {painted_lines[layer_idx]}, input_expolygons[layer_idx]);
 #endif // MM_SEGMENTATION_DEBUG_PAINTED_LINES
@@ -1441,18 +1673,67 @@ std::vector<std::vector<ExPolygons>> multi_material_segmentation_by_painting(con
     BOOST_LOG_TRIVIAL(debug) << "MM segmentation - layers segmentation in parallel - end";
     throw_on_cancel_callback();
 
-    if (auto max_width = print_object.config().mmu_segmented_region_max_width, interlocking_depth = print_object.config().mmu_segmented_region_interlocking_depth; max_width > 0.f) {
-        cut_segmented_layers(input_expolygons, segmented_regions, float(scale_(max_width)), float(scale_(interlocking_depth)), throw_on_cancel_callback);
+    if (cut_width > 0.f) {
+        cut_segmented_layers(input_expolygons, segmented_regions, cut_width, interlocking_depth, throw_on_cancel_callback);
         throw_on_cancel_callback();
     }
 
+    if (cache_valid)
+        for (size_t layer_idx = 0; layer_idx < num_layers; ++layer_idx)
+            if (! side_to_update[layer_idx])
+                segmented_regions[layer_idx] = cached->segmented_regions[layer_idx];
+
+    TopAndBottomProjection top_and_bottom_projection = mm_segmentation_project_top_and_bottom(print_object, throw_on_cancel_callback);
+    throw_on_cancel_callback();
+
+    // A layer is segmented again if its sides were segmented again or if it is reached by a modified top or bottom projection.
+    std::vector<uint8_t> layers_to_update = side_to_update;
+    if (cached) {
+        normalize_projected_polygons(top_and_bottom_projection.top, throw_on_cancel_callback);
+        normalize_projected_polygons(top_and_bottom_projection.bottom, throw_on_cancel_callback);
+        if (cache_valid) {
+            int max_top_layers    = 0;
+            int max_bottom_layers = 0;
+            for (const LayerColorStat &stat : color_stats) {
+                max_top_layers    = std::max(max_top_layers, stat.top_solid_layers);
+                max_bottom_layers = std::max(max_bottom_layers, stat.bottom_solid_layers);
+            }
+            std::vector<uint8_t> projection_changed = top_and_bottom_projection_changed(top_and_bottom_projection, cached->top_and_bottom, num_layers);
+            for (size_t layer_idx = 0; layer_idx < num_layers; ++layer_idx)
+                if (projection_changed[layer_idx])
+                    std::fill(layers_to_update.begin() + std::max(int(layer_idx) - max_top_layers, 0),
+                              layers_to_update.begin() + std::min(layer_idx + size_t(max_bottom_layers) + 1, num_layers), true);
+        } else
+            layers_to_update.assign(num_layers, true);
+        BOOST_LOG_TRIVIAL(debug) << "MM segmentation - layers to update: " << std::count(layers_to_update.begin(), layers_to_update.end(), true);
+    }
+
     // The first index is extruder number (includes default extruder), and the second one is layer number
-    std::vector<std::vector<ExPolygons>> top_and_bottom_layers = mm_segmentation_top_and_bottom_layers(print_object, input_expolygons, throw_on_cancel_callback);
+    std::vector<std::vector<ExPolygons>> top_and_bottom_layers = mm_segmentation_top_and_bottom_layers(print_object, input_expolygons, top_and_bottom_projection, color_stats, layers_to_update, throw_on_cancel_callback);
     throw_on_cancel_callback();
 
-    std::vector<std::vector<ExPolygons>> segmented_regions_merged = merge_segmented_layers(segmented_regions, std::move(top_and_bottom_layers), num_extruders, throw_on_cancel_callback);
+    std::vector<std::vector<ExPolygons>> segmented_regions_merged = merge_segmented_layers(segmented_regions, std::move(top_and_bottom_layers), num_extruders, layers_to_update, throw_on_cancel_callback);
     throw_on_cancel_callback();
 
+    if (cached) {
+        if (cache_valid)
+            for (size_t layer_idx = 0; layer_idx < num_layers; ++layer_idx)
+                if (! layers_to_update[layer_idx])
+                    segmented_regions_merged[layer_idx] = cached->segmented_regions_merged[layer_idx];
+        // Only a finished segmentation is stored, a canceled one leaves the cache untouched.
+        cached->valid                    = true;
+        cached->num_extruders            = num_extruders;
+        cached->cut_width                = cut_width;
+        cached->interlocking_depth       = interlocking_depth;
+        cached->color_stats              = std::move(color_stats);
+        cached->input_expolygons         = input_expolygons;
+        cached->painted_lines            = std::move(painted_lines_sorted);
+        cached->top_and_bottom           = std::move(top_and_bottom_projection);
+        cached->segmented_regions        = std::move(segmented_regions);
+        cached->segmented_regions_merged = segmented_regions_merged;
+        cached->layers_updated           = std::move(layers_to_update);
+    }
+
 #ifdef MM_SEGMENTATION_DEBUG_REGIONS
     for (size_t layer_idx = 0; layer_idx < print_object.layers().size(); ++layer_idx)
         export_regions_to_svg(debug_out_path("mm-regions-merged-%d-%d.svg", layer_idx, iRun), segmented_regions_merged[layer_idx], input_expolygons[layer_idx]);
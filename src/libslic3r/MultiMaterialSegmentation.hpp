@@ -9,6 +9,8 @@
 #include <utility>
 #include <vector>
 #include <functional>
+#include <memory>
+#include <mutex>
 
 #include "libslic3r/ExPolygon.hpp"
 #include "libslic3r/Line.hpp"
@@ -32,8 +34,34 @@ struct ColoredLine
 
 using ColoredLines = std::vector<ColoredLine>;
 
-// Returns MMU segmentation based on painting in MMU segmentation gizmo
-std::vector<std::vector<ExPolygons>> multi_material_segmentation_by_painting(const PrintObject &print_object, const std::function<void()> &throw_on_cancel_callback);
+// MMU segmentation of PrintObjects kept by Print between the slicing runs.
+// Painting an object invalidates its slicing, however when only the painting changed, just the layers
+// influenced by the modified painting (including propagation of the painted top / bottom surfaces)
+// are segmented again, segmentation of the other layers is reused.
+class MMSegmentationCache
+{
+public:
+    MMSegmentationCache();
+    ~MMSegmentationCache();
+
+    struct Entry;
+    // Returns the entry of print_object, creates an empty one if not cached yet.
+    Entry& entry(const PrintObject &print_object);
+    // Drops entries of objects, which are not printed anymore.
+    void   release_unused(const std::vector<PrintObject*> &print_objects);
+    void   clear();
+    // Indices of the layers segmented again by the last segmentation of print_object, the other layers were reused.
+    // Empty if print_object was not segmented yet.
+    std::vector<size_t> updated_layers(const PrintObject &print_object);
+
+private:
+    std::vector<std::unique_ptr<Entry>> m_entries;
+    std::mutex                          m_mutex;
+};
+
+// Returns MMU segmentation based on painting in MMU segmentation gizmo.
+// If cache is provided, layers painted the same way as during the last segmentation of print_object are reused.
+std::vector<std::vector<ExPolygons>> multi_material_segmentation_by_painting(const PrintObject &print_object, const std::function<void()> &throw_on_cancel_callback, MMSegmentationCache *cache = nullptr);
 
 } // namespace Slic3r
 
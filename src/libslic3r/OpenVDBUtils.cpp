@@ -290,6 +290,33 @@ double get_distance_raw(const Vec3f &p, const VoxelGrid &vgrid)
     return vgrid.accessor->getValue(grididx) ;
 }
 
+struct VoxelGridAccessor::Impl
+{
+    const openvdb::FloatGrid &grid;
+    mutable openvdb::FloatGrid::ConstAccessor accessor;
+
+    explicit Impl(const openvdb::FloatGrid &g)
+        : grid{g}, accessor{g.getConstAccessor()}
+    {}
+};
+
+VoxelGridAccessor::VoxelGridAccessor(const VoxelGrid &vgrid)
+    : m_impl{std::make_unique<Impl>(vgrid.grid)}
+{}
+
+VoxelGridAccessor::~VoxelGridAccessor() = default;
+VoxelGridAccessor::VoxelGridAccessor(VoxelGridAccessor &&) noexcept = default;
+VoxelGridAccessor &VoxelGridAccessor::operator=(VoxelGridAccessor &&) noexcept = default;
+
+double VoxelGridAccessor::get_distance_raw(const Vec3f &p) const
+{
+    auto v       = p.cast<double>();
+    auto grididx = m_impl->grid.transform().worldToIndexCellCentered(
+        {v.x(), v.y(), v.z()});
+
+    return m_impl->accessor.getValue(grididx);
+}
+
 float get_voxel_scale(const VoxelGrid &vgrid)
 {
     float scale = 1.;
@@ -29,6 +29,24 @@ void reset_accessor(const VoxelGrid &vgrid);
 
 double get_distance_raw(const Vec3f &p, const VoxelGrid &interior);
 
+// Reads the values of a voxel grid through its own cache. Unlike the accessor
+// shared by get_distance_raw() above, each thread can use its own instance to
+// read the same grid concurrently.
+class VoxelGridAccessor
+{
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+
+public:
+    explicit VoxelGridAccessor(const VoxelGrid &grid);
+    ~VoxelGridAccessor();
+
+    VoxelGridAccessor(VoxelGridAccessor &&) noexcept;
+    VoxelGridAccessor &operator=(VoxelGridAccessor &&) noexcept;
+
+    double get_distance_raw(const Vec3f &p) const;
+};
+
 float get_voxel_scale(const VoxelGrid &grid);
 
 VoxelGridPtr clone(const VoxelGrid &grid);
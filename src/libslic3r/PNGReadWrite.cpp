@@ -97,9 +97,15 @@ bool decode_png(IStream &in_buf, ImageGreyscale &out_img)
     size_t color_type = png_get_color_type(dsc.png, dsc.info);
     size_t bit_depth  = png_get_bit_depth(dsc.png, dsc.info);
 
-    if (color_type != PNG_COLOR_TYPE_GRAY || bit_depth != 8)
+    if (color_type != PNG_COLOR_TYPE_GRAY || bit_depth > 8)
         return false;
 
+    if (bit_depth < 8) {
+        // Black and white masks may be stored with 1 bit per pixel, expanded to 0 and 255.
+        png_set_expand_gray_1_2_4_to_8(dsc.png);
+        png_read_update_info(dsc.png, dsc.info);
+    }
+
     out_img.buf.resize(out_img.rows * out_img.cols);
 
     auto readbuf = static_cast<png_bytep>(out_img.buf.data());
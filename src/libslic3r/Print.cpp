@@ -973,6 +973,8 @@ void Print::process()
 
     BOOST_LOG_TRIVIAL(info) << "Starting the slicing process." << log_memory_info();
 
+    m_mm_segmentation_cache.release_unused(m_objects);
+
     tbb::parallel_for(tbb::blocked_range<size_t>(0, m_objects.size(), 1), [this](const tbb::blocked_range<size_t> &range) {
         for (size_t idx = range.begin(); idx < range.end(); ++idx) {
             m_objects[idx]->make_perimeters();
@@ -981,9 +983,25 @@ void Print::process()
         }
     }, tbb::simple_partitioner());
 
-    // The following step writes to m_shared_regions, it should not run in parallel.
-    for (PrintObject *obj : m_objects)
-        obj->generate_support_spots();
+    {
+        // Support spots are stored into m_shared_regions, which are shared by PrintObjects of the same ModelObject.
+        // Search them just for the first PrintObject of these, then store the results sequentially.
+        std::vector<uint8_t>                   search(m_objects.size(), false);
+        std::vector<const PrintObjectRegions*> searched;
+        for (size_t idx = 0; idx < m_objects.size(); ++ idx)
+            if (const PrintObject &obj = *m_objects[idx];
+                ! obj.shared_regions()->generated_support_points.has_value() && ! obj.is_step_done(posSupportSpotsSearch) &&
+                std::find(searched.begin(), searched.end(), obj.shared_regions()) == searched.end()) {
+                search[idx] = true;
+                searched.emplace_back(obj.shared_regions());
+            }
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, m_objects.size(), 1), [this, &search](const tbb::blocked_range<size_t> &range) {
+            for (size_t idx = range.begin(); idx < range.end(); ++idx)
+                m_objects[idx]->generate_support_spots(search[idx]);
+        }, tbb::simple_partitioner());
+        for (PrintObject *obj : m_objects)
+            obj->finalize_support_spots();
+    }
     // check data from previous step, format the error message(s) and send alert to ui
     // this also has to be done sequentially.
     alert_when_supports_needed();
@@ -68,6 +68,24 @@ namespace FillLightning {
     using GeneratorPtr = std::unique_ptr<Generator, GeneratorDeleter>;
 }; // namespace FillLightning
 
+namespace FFFTreeSupport {
+    class TreeModelVolumes;
+    // TreeModelVolumes are kept by PrintObject between the support generator runs, see PrintObject::tree_model_volumes_cache().
+    struct TreeModelVolumesDeleter {
+        void operator()(TreeModelVolumes *p);
+    };
+    using TreeModelVolumesPtr = std::unique_ptr<TreeModelVolumes, TreeModelVolumesDeleter>;
+}; // namespace FFFTreeSupport
+
+namespace ModelInfo {
+    class VisibilityCache;
+    // Seam visibility is kept by Print between the G-code exports, see Print::seam_visibility_cache().
+    struct VisibilityCacheDeleter {
+        void operator()(VisibilityCache *p);
+    };
+    using VisibilityCachePtr = std::unique_ptr<VisibilityCache, VisibilityCacheDeleter>;
+}; // namespace ModelInfo
+
 // Print step IDs for keeping track of the print state.
 // The Print steps are applied in this order.
 enum PrintStep : unsigned int {
@@ -355,6 +373,13 @@ public:
     // Helpers to project custom facets on slices
     void project_and_append_custom_facets(bool seam, TriangleStateType type, std::vector<Polygons>& expolys) const;
 
+    // Collision and avoidance caches of the tree supports kept between the support generator runs.
+    // They are reused if the slices and the parameters the caches depend on did not change, see TreeModelVolumes::reuse_caches().
+    FFFTreeSupport::TreeModelVolumesPtr& tree_model_volumes_cache() { return m_tree_model_volumes_cache; }
+
+    // Layers, for which the last make_perimeters() generated the perimeters, indexed by layer. The other layers kept their perimeters.
+    const std::vector<uint8_t>&          perimeters_updated_layers() const { return m_perimeters_updated_layers; }
+
 private:
     // to be called from Print only.
     friend class Print;
@@ -377,8 +402,10 @@ private:
     bool                    invalidate_all_steps();
     // Invalidate steps based on a set of parameters changed.
     // It may be called for both the PrintObjectConfig and PrintRegionConfig.
+    // If the parameters belong to a PrintRegionConfig of region, perimeters are invalidated just for the layers containing region.
     bool                    invalidate_state_by_config_options(
-        const ConfigOptionResolver &old_config, const ConfigOptionResolver &new_config, const std::vector<t_config_option_key> &opt_keys);
+        const ConfigOptionResolver &old_config, const ConfigOptionResolver &new_config, const std::vector<t_config_option_key> &opt_keys,
+        const PrintRegion *region = nullptr);
     // If ! m_slicing_params.valid, recalculate.
     void                    update_slicing_parameters();
 
@@ -393,7 +420,10 @@ private:
     void clear_fills();
     void infill();
     void ironing();
-    void generate_support_spots();
+    // Searches support spots if search is set. Runs in parallel for all PrintObjects, thus the result is staged
+    // and stored into the m_shared_regions shared by PrintObjects of the same ModelObject by finalize_support_spots().
+    void generate_support_spots(bool search);
+    void finalize_support_spots();
     void generate_support_material();
     void estimate_curled_extrusions();
     void calculate_overhanging_perimeters();
@@ -434,9 +464,21 @@ private:
     // this is set to true when LayerRegion->slices is split in top/internal/bottom
     // so that next call to make_perimeters() performs a union() before computing loops
     bool                    				m_typed_slices = false;
+    // Set when posPerimeters finished. If posPerimeters was invalidated since then just by configuration changes of some regions,
+    // these regions are marked in m_perimeters_dirty_regions (indexed by print_object_region_id) and make_perimeters()
+    // regenerates just the layers containing them.
+    bool                                    m_perimeters_reusable = false;
+    std::vector<uint8_t>                    m_perimeters_dirty_regions;
+    // Layers processed by the last make_perimeters(), the other layers kept their perimeters.
+    std::vector<uint8_t>                    m_perimeters_updated_layers;
 
     std::pair<FillAdaptive::OctreePtr, FillAdaptive::OctreePtr> m_adaptive_fill_octrees;
     FillLightning::GeneratorPtr m_lightning_generator;
+    FFFTreeSupport::TreeModelVolumesPtr m_tree_model_volumes_cache;
+
+    // Set by generate_support_spots() when it started posSupportSpotsSearch, which is finished by finalize_support_spots().
+    bool                                                        m_support_spots_pending { false };
+    std::optional<PrintObjectRegions::GeneratedSupportPoints>   m_support_spots_staged;
 };
 
 
@@ -658,6 +700,11 @@ public:
     const PrintStatistics&      print_statistics() const { return m_print_statistics; }
     PrintStatistics&            print_statistics() { return m_print_statistics; }
 
+    // Seam visibility of the objects kept between the G-code exports, created by the G-code generator on demand.
+    ModelInfo::VisibilityCachePtr& seam_visibility_cache() { return m_seam_visibility_cache; }
+    // MMU segmentation of the painted objects kept between the slicing runs.
+    MMSegmentationCache&        mm_segmentation_cache() { return m_mm_segmentation_cache; }
+
     // Wipe tower support.
     bool                        has_wipe_tower() const;
     const WipeTowerData&        wipe_tower_data(size_t extruders_cnt = 0) const;
@@ -728,6 +775,11 @@ private:
     // Cache to store sequential print clearance contours
     Polygons m_sequential_print_clearance_contours;
 
+    // Seam visibility of the objects, kept between the G-code exports and shared between copies of objects.
+    ModelInfo::VisibilityCachePtr           m_seam_visibility_cache;
+    // MMU segmentation of the painted objects, kept between the slicing runs to segment again only the repainted layers.
+    MMSegmentationCache                     m_mm_segmentation_cache;
+
     // To allow GCode to set the Print's GCodeExport step status.
     friend class GCodeGenerator;
     // To allow GCodeProcessor to emit warnings.
@@ -683,7 +683,7 @@ bool verify_update_print_object_regions(
     size_t                              num_extruders,
     const std::vector<unsigned int>    &painting_extruders,
     PrintObjectRegions                 &print_object_regions,
-    const std::function<void(const PrintRegionConfig&, const PrintRegionConfig&, const t_config_option_keys&)> &callback_invalidate)
+    const std::function<void(const PrintRegion&, const PrintRegionConfig&, const PrintRegionConfig&, const t_config_option_keys&)> &callback_invalidate)
 {
     // Sort by ModelVolume ID.
     model_volumes_sort_by_id(model_volumes);
@@ -744,7 +744,7 @@ bool verify_update_print_object_regions(
                         // Region is referenced for the first time. Just change its parameters.
                         // Stop the background process before assigning new configuration to the regions.
                         t_config_option_keys diff = region.region->config().diff(cfg);
-                        callback_invalidate(region.region->config(), cfg, diff);
+                        callback_invalidate(*region.region, region.region->config(), cfg, diff);
                         region.region->config_apply_only(cfg, diff, false);
                     } else {
                         // Region is referenced multiple times, thus the region is being split. We need to reslice.
@@ -769,7 +769,7 @@ bool verify_update_print_object_regions(
                     // Region is referenced for the first time. Just change its parameters.
                     // Stop the background process before assigning new configuration to the regions.
                     t_config_option_keys diff = region.region->config().diff(cfg);
-                    callback_invalidate(region.region->config(), cfg, diff);
+                    callback_invalidate(*region.region, region.region->config(), cfg, diff);
                     region.region->config_apply_only(cfg, diff, false);
                 } else {
                     // Region is referenced multiple times, thus the region is being split. We need to reslice.
@@ -1435,10 +1435,10 @@ Print::ApplyStatus Print::apply(const Model &model, DynamicPrintConfig new_full_
                     num_extruders,
                     painting_extruders,
                     *print_object_regions,
-                    [it_print_object, it_print_object_end, &update_apply_status](const PrintRegionConfig &old_config, const PrintRegionConfig &new_config, const t_config_option_keys &diff_keys) {
+                    [it_print_object, it_print_object_end, &update_apply_status](const PrintRegion &region, const PrintRegionConfig &old_config, const PrintRegionConfig &new_config, const t_config_option_keys &diff_keys) {
                         for (auto it = it_print_object; it != it_print_object_end; ++it)
                             if ((*it)->m_shared_regions != nullptr)
-                                update_apply_status((*it)->invalidate_state_by_config_options(old_config, new_config, diff_keys));
+                                update_apply_status((*it)->invalidate_state_by_config_options(old_config, new_config, diff_keys, &region));
                     })) {
                 // Regions are valid, just keep them.
             } else {
@@ -45,6 +45,7 @@
 #include "PrintConfig.hpp"
 #include "Support/SupportMaterial.hpp"
 #include "Support/TreeSupport.hpp"
+#include "Support/TreeModelVolumes.hpp"
 #include "Surface.hpp"
 #include "Slicing.hpp"
 #include "SurfaceCollection.hpp"
@@ -260,20 +261,41 @@ void PrintObject::make_perimeters()
         BOOST_LOG_TRIVIAL(debug) << "Generating extra perimeters for region " << region_id << " in parallel - end";
     }
 
+    // If just some regions changed since the perimeters were generated the last time, only the layers containing these regions
+    // are processed. Layer::make_perimeters() processes all regions of a layer at once, as compatible regions share their perimeters.
+    std::vector<uint8_t> layers_to_update(m_layers.size(), true);
+    if (m_perimeters_reusable) {
+        assert(m_perimeters_dirty_regions.size() == this->num_printing_regions());
+        for (size_t layer_idx = 0; layer_idx < m_layers.size(); ++ layer_idx) {
+            const Layer &layer = *m_layers[layer_idx];
+            layers_to_update[layer_idx] = false;
+            for (size_t region_id = 0; region_id < layer.region_count(); ++ region_id)
+                if (m_perimeters_dirty_regions[region_id] && ! layer.get_region(int(region_id))->slices().empty()) {
+                    layers_to_update[layer_idx] = true;
+                    break;
+                }
+        }
+        BOOST_LOG_TRIVIAL(debug) << "Generating perimeters - layers to update: " << std::count(layers_to_update.begin(), layers_to_update.end(), true) << " of " << m_layers.size();
+    }
+
     BOOST_LOG_TRIVIAL(debug) << "Generating perimeters in parallel - start";
     tbb::parallel_for(
         tbb::blocked_range<size_t>(0, m_layers.size()),
-        [this](const tbb::blocked_range<size_t>& range) {
+        [this, &layers_to_update](const tbb::blocked_range<size_t>& range) {
             PRINT_OBJECT_TIME_LIMIT_MILLIS(PRINT_OBJECT_TIME_LIMIT_DEFAULT);
             for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx) {
                 m_print->throw_if_canceled();
-                m_layers[layer_idx]->make_perimeters();
+                if (layers_to_update[layer_idx])
+                    m_layers[layer_idx]->make_perimeters();
             }
         }
     );
     m_print->throw_if_canceled();
     BOOST_LOG_TRIVIAL(debug) << "Generating perimeters in parallel - end";
 
+    m_perimeters_reusable = true;
+    m_perimeters_dirty_regions.assign(this->num_printing_regions(), false);
+    m_perimeters_updated_layers = std::move(layers_to_update);
     this->set_done(posPerimeters);
 }
 
@@ -473,12 +495,14 @@ void PrintObject::ironing()
     }
 }
 
-void PrintObject::generate_support_spots()
+void PrintObject::generate_support_spots(bool search)
 {
     if (this->set_started(posSupportSpotsSearch)) {
-        BOOST_LOG_TRIVIAL(debug) << "Searching support spots - start";
-        m_print->set_status(65, _u8L("Searching support spots"));
-        if (!this->shared_regions()->generated_support_points.has_value()) {
+        m_support_spots_pending = true;
+        m_support_spots_staged.reset();
+        if (search) {
+            BOOST_LOG_TRIVIAL(debug) << "Searching support spots - start";
+            m_print->set_status(65, _u8L("Searching support spots"));
             PrintTryCancel                cancel_func = m_print->make_try_cancel();
             SupportSpotsGenerator::Params params{this->print()->m_config.filament_type.values,
                                                  float(this->print()->m_config.perimeter_acceleration.getFloat()),
@@ -489,10 +513,22 @@ void PrintObject::generate_support_spots()
             if (this->layer_count() > 0) {
                 po_transform = Geometry::translation_transform(Vec3d{0, 0, this->layers().front()->bottom_z()}) * po_transform;
             }
-            this->m_shared_regions->generated_support_points = {po_transform, supp_points, partial_objects};
+            m_support_spots_staged = PrintObjectRegions::GeneratedSupportPoints{po_transform, std::move(supp_points), std::move(partial_objects)};
             m_print->throw_if_canceled();
+            BOOST_LOG_TRIVIAL(debug) << "Searching support spots - end";
         }
-        BOOST_LOG_TRIVIAL(debug) << "Searching support spots - end";
+    }
+}
+
+// Not thread safe, it writes to m_shared_regions.
+void PrintObject::finalize_support_spots()
+{
+    if (m_support_spots_pending) {
+        if (m_support_spots_staged.has_value()) {
+            m_shared_regions->generated_support_points = std::move(m_support_spots_staged);
+            m_support_spots_staged.reset();
+        }
+        m_support_spots_pending = false;
         this->set_done(posSupportSpotsSearch);
     }
 }
@@ -563,6 +599,12 @@ void PrintObject::calculate_overhanging_perimeters()
         }
 
         if (!regions_with_dynamic_speeds.empty()) {
+            // Perimeters split here no more match the output of the perimeter generator,
+            // thus make_perimeters() will not reuse the layers containing these regions.
+            for (size_t region_id = 0; region_id < m_perimeters_dirty_regions.size(); ++ region_id)
+                if (regions_with_dynamic_speeds.find(&this->printing_region(region_id)) != regions_with_dynamic_speeds.end())
+                    m_perimeters_dirty_regions[region_id] = true;
+
             std::unordered_map<size_t, AABBTreeLines::LinesDistancer<CurledLine>> curled_lines;
             std::unordered_map<size_t, AABBTreeLines::LinesDistancer<Linef>>      unscaled_polygons_lines;
             for (const Layer *l : this->layers()) {
@@ -691,13 +733,17 @@ SupportLayerPtrs::iterator PrintObject::insert_support_layer(SupportLayerPtrs::i
 // Called by Print::apply().
 // This method only accepts PrintObjectConfig and PrintRegionConfig option keys.
 bool PrintObject::invalidate_state_by_config_options(
-    const ConfigOptionResolver &old_config, const ConfigOptionResolver &new_config, const std::vector<t_config_option_key> &opt_keys)
+    const ConfigOptionResolver &old_config, const ConfigOptionResolver &new_config, const std::vector<t_config_option_key> &opt_keys,
+    const PrintRegion *region)
 {
     if (opt_keys.empty())
         return false;
 
     std::vector<PrintObjectStep> steps;
     bool invalidated = false;
+    // Perimeters of layers not containing region stay valid, unless the change requires more than regenerating the perimeters.
+    const bool perimeters_reusable = m_perimeters_reusable;
+    bool       region_local        = region != nullptr;
     for (const t_config_option_key &opt_key : opt_keys) {
         if (   opt_key == "brim_width"
             || opt_key == "brim_separation"
@@ -903,12 +949,19 @@ bool PrintObject::invalidate_state_by_config_options(
             // for legacy, if we can't handle this option let's invalidate all steps
             this->invalidate_all_steps();
             invalidated = true;
+            region_local = false;
         }
     }
 
     sort_remove_duplicates(steps);
     for (PrintObjectStep step : steps)
         invalidated |= this->invalidate_step(step);
+    if (region_local && perimeters_reusable && size_t(region->print_object_region_id()) < m_perimeters_dirty_regions.size() &&
+        std::binary_search(steps.begin(), steps.end(), posPerimeters) && ! std::binary_search(steps.begin(), steps.end(), posSlice)) {
+        // invalidate_step(posPerimeters) dropped all the perimeters, keep those of layers without this region.
+        m_perimeters_reusable = true;
+        m_perimeters_dirty_regions[region->print_object_region_id()] = true;
+    }
     return invalidated;
 }
 
@@ -920,6 +973,7 @@ bool PrintObject::invalidate_step(PrintObjectStep step)
     if (step == posPerimeters) {
 		invalidated |= this->invalidate_steps({ posPrepareInfill, posInfill, posIroning,  posSupportSpotsSearch, posEstimateCurledExtrusions, posCalculateOverhangingPerimeters });
         invalidated |= m_print->invalidate_steps({ psSkirtBrim });
+        m_perimeters_reusable = false;
     } else if (step == posPrepareInfill) {
         invalidated |= this->invalidate_steps({ posInfill, posIroning, posSupportSpotsSearch});
     } else if (step == posInfill) {
@@ -930,6 +984,7 @@ bool PrintObject::invalidate_step(PrintObjectStep step)
                                                posSupportMaterial, posEstimateCurledExtrusions, posCalculateOverhangingPerimeters});
         invalidated |= m_print->invalidate_steps({ psSkirtBrim });
         m_slicing_params.valid = false;
+        m_perimeters_reusable = false;
     } else if (step == posSupportMaterial) {
         invalidated |= m_print->invalidate_steps({ psSkirtBrim,  });
         invalidated |= this->invalidate_steps({ posEstimateCurledExtrusions });
@@ -953,6 +1008,7 @@ bool PrintObject::invalidate_all_steps()
     bool result = Inherited::invalidate_all_steps() | m_print->invalidate_all_steps();
 	// Then reset some of the depending values.
 	m_slicing_params.valid = false;
+    m_perimeters_reusable = false;
 	return result;
 }
 
@@ -963,6 +1019,9 @@ void PrintObject::cleanup()
         this->clear_fills();
     if (this->query_reset_dirty_step_unguarded(posSupportMaterial))
         this->clear_support_layers();
+    if (! this->is_step_done_unguarded(posSlice))
+        // The tree support caches were calculated for the old slices.
+        m_tree_model_volumes_cache.reset();
 }
 
 // This function analyzes slices of a region (SurfaceCollection slices).
@@ -1631,17 +1690,37 @@ void PrintObject::discover_vertical_shells()
                         //      the in-model condition is there due to small sloping surfaces, e.g. top of the hull of the benchy
                         //   2. the area does not fully cover an internal polygon
                         //         This is there mainly for a very thin parts, where the solid layers would be missing if the part area is quite small
-                        regularized_shell.erase(std::remove_if(regularized_shell.begin(), regularized_shell.end(),
-                                                               [&internal_volume, &min_perimeter_infill_spacing,
-                                                                &object_volume](const ExPolygon &p) {
-                                                                   return (p.area() < min_perimeter_infill_spacing * scaled(1.5) ||
-                                                                           (p.area() < min_perimeter_infill_spacing * scaled(8.0) &&
-                                                                            diff(to_polygons(p), object_volume).empty())) &&
-                                                                          diff(internal_volume,
-                                                                               expand(to_polygons(p), min_perimeter_infill_spacing))
-                                                                                  .size() >= internal_volume.size();
-                                                               }),
-                                                regularized_shell.end());
+                        // The clipping operations of all the candidate regions are batched.
+                        const double    area_tiny  = min_perimeter_infill_spacing * scaled(1.5);
+                        const double    area_small = min_perimeter_infill_spacing * scaled(8.0);
+                        std::vector<Polygons>        shell_polygons;
+                        std::vector<const Polygons*> small_subjects;
+                        shell_polygons.reserve(regularized_shell.size());
+                        small_subjects.reserve(regularized_shell.size());
+                        for (const ExPolygon &p : regularized_shell) {
+                            shell_polygons.emplace_back(to_polygons(p));
+                            const double area = p.area();
+                            small_subjects.emplace_back(area >= area_tiny && area < area_small ? &shell_polygons.back() : nullptr);
+                        }
+                        std::vector<Polygons> outside_object = diff_batch(small_subjects, object_volume);
+                        std::vector<Polygons>        expanded_shell(regularized_shell.size());
+                        std::vector<const Polygons*> internal_subjects(regularized_shell.size(), nullptr);
+                        std::vector<const Polygons*> internal_clips(regularized_shell.size(), nullptr);
+                        for (size_t i = 0; i < regularized_shell.size(); ++ i)
+                            if (const double area = regularized_shell[i].area(); area < area_tiny || (area < area_small && outside_object[i].empty())) {
+                                expanded_shell[i]    = expand(shell_polygons[i], min_perimeter_infill_spacing);
+                                internal_subjects[i] = &internal_volume;
+                                internal_clips[i]    = &expanded_shell[i];
+                            }
+                        std::vector<Polygons> uncovered_internal = diff_batch(internal_subjects, internal_clips);
+                        size_t idx_kept = 0;
+                        for (size_t i = 0; i < regularized_shell.size(); ++ i)
+                            if (internal_subjects[i] == nullptr || uncovered_internal[i].size() < internal_volume.size()) {
+                                if (idx_kept != i)
+                                    regularized_shell[idx_kept] = std::move(regularized_shell[i]);
+                                ++ idx_kept;
+                            }
+                        regularized_shell.erase(regularized_shell.begin() + idx_kept, regularized_shell.end());
                     }
                     if (regularized_shell.empty())
                         continue;
@@ -2955,6 +3034,7 @@ void PrintObject::_generate_support_material()
     if (this->has_support() && (m_config.support_material_style == smsTree || m_config.support_material_style == smsOrganic)) {
         fff_tree_support_generate(*this, std::function<void()>([this](){ this->throw_if_canceled(); }));
     } else {
+        m_tree_model_volumes_cache.reset();
         // If support style is set to Organic however only raft will be built but no support,
         // build snug raft instead.
         PrintObjectSupportMaterial support_material(this, m_slicing_params);
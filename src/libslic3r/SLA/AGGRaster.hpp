@@ -8,6 +8,8 @@
 #include <libslic3r/SLA/RasterBase.hpp>
 #include "libslic3r/ExPolygon.hpp"
 
+#include <algorithm>
+
 // For rasterizing
 #include <agg/agg_basics.h>
 #include <agg/agg_rendering_buffer.h>
@@ -35,34 +37,14 @@ template<class Color> struct Colors {
 template<class Color> const Color Colors<Color>::White = Color{255};
 template<class Color> const Color Colors<Color>::Black = Color{0};
 
-template<class PixelRenderer,
-         template<class /*agg::renderer_base<PixelRenderer>*/> class Renderer,
-         class Rasterizer = agg::rasterizer_scanline_aa<>,
-         class Scanline   = agg::scanline_p8>
-class AGGRaster: public RasterBase {
-public:
-    using TColor = typename PixelRenderer::color_type;
-    using TValue = typename TColor::value_type;
-    using TPixel = typename PixelRenderer::pixel_type;
-    using TRawBuffer = agg::rendering_buffer;
-
+// Converts polygons in scaled coordinates into agg paths in the pixel space
+// of a raster with the given resolution, pixel size and transformation.
+class AGGPathTransform {
 protected:
-    
     Resolution m_resolution;
     PixelDim m_pxdim_scaled;    // used for scaled coordinate polygons
-    
-    std::vector<TPixel> m_buf;
-    agg::rendering_buffer m_rbuf;
-    
-    PixelRenderer m_pixrenderer;
-    
-    agg::renderer_base<PixelRenderer> m_raw_renderer;
-    Renderer<agg::renderer_base<PixelRenderer>> m_renderer;
-    
-    Trafo m_trafo;
-    Scanline m_scanlines;
-    Rasterizer m_rasterizer;
-    
+    RasterBase::Trafo m_trafo;
+
     void flipy(agg::path_storage &path) const
     {
         path.flip_y(0, double(m_resolution.height_px));
@@ -73,11 +55,10 @@ protected:
         path.flip_x(0, double(m_resolution.width_px));
     }
     
-    double getPx(const Point &p) { return p(0) * m_pxdim_scaled.w_mm; }
-    double getPy(const Point &p) { return p(1) * m_pxdim_scaled.h_mm; }
-    agg::path_storage to_path(const Polygon &poly) { return to_path(poly.points); }
-    
-    template<class PointVec> agg::path_storage _to_path(const PointVec& v)
+    double getPx(const Point &p) const { return p(0) * m_pxdim_scaled.w_mm; }
+    double getPy(const Point &p) const { return p(1) * m_pxdim_scaled.h_mm; }
+
+    template<class PointVec> agg::path_storage _to_path(const PointVec& v) const
     {
         agg::path_storage path;
         
@@ -89,7 +70,7 @@ protected:
         return path;
     }
     
-    template<class PointVec> agg::path_storage _to_path_flpxy(const PointVec& v)
+    template<class PointVec> agg::path_storage _to_path_flpxy(const PointVec& v) const
     {
         agg::path_storage path;
         
@@ -101,7 +82,33 @@ protected:
         return path;
     }
     
-    template<class PointVec> agg::path_storage to_path(const PointVec &v)
+public:
+    AGGPathTransform(const Resolution        &res,
+                     const PixelDim          &pd,
+                     const RasterBase::Trafo &trafo)
+        : m_resolution(res)
+        , m_pxdim_scaled(SCALING_FACTOR, SCALING_FACTOR)
+        , m_trafo(trafo)
+    {
+        // Visual Studio compiler gives warnings about possible division by zero.
+        assert(pd.w_mm != 0 && pd.h_mm != 0);
+        if (pd.w_mm != 0 && pd.h_mm != 0) {
+            m_pxdim_scaled.w_mm /= pd.w_mm;
+            m_pxdim_scaled.h_mm /= pd.h_mm;
+        }
+    }
+
+    const RasterBase::Trafo& trafo() const { return m_trafo; }
+    Resolution resolution() const { return m_resolution; }
+    PixelDim   pixel_dimensions() const
+    {
+        return {SCALING_FACTOR / m_pxdim_scaled.w_mm,
+                SCALING_FACTOR / m_pxdim_scaled.h_mm};
+    }
+
+    agg::path_storage to_path(const Polygon &poly) const { return to_path(poly.points); }
+
+    template<class PointVec> agg::path_storage to_path(const PointVec &v) const
     {
         auto path = m_trafo.flipXY ? _to_path_flpxy(v) : _to_path(v);
         
@@ -113,13 +120,46 @@ protected:
         
         return path;
     }
+
+    template<class Rasterizer, class P>
+    void add_paths(Rasterizer &rasterizer, const P &poly) const
+    {
+        rasterizer.add_path(to_path(contour(poly)));
+        for(auto& h : holes(poly)) rasterizer.add_path(to_path(h));
+    }
+};
+
+template<class PixelRenderer,
+         template<class /*agg::renderer_base<PixelRenderer>*/> class Renderer,
+         class Rasterizer = agg::rasterizer_scanline_aa<>,
+         class Scanline   = agg::scanline_p8>
+class AGGRaster: public RasterBase {
+public:
+    using TColor = typename PixelRenderer::color_type;
+    using TValue = typename TColor::value_type;
+    using TPixel = typename PixelRenderer::pixel_type;
+    using TRawBuffer = agg::rendering_buffer;
+
+protected:
+    
+    AGGPathTransform m_transform;
+    
+    std::vector<TPixel> m_buf;
+    agg::rendering_buffer m_rbuf;
+    
+    PixelRenderer m_pixrenderer;
+    
+    agg::renderer_base<PixelRenderer> m_raw_renderer;
+    Renderer<agg::renderer_base<PixelRenderer>> m_renderer;
+    
+    Scanline m_scanlines;
+    Rasterizer m_rasterizer;
     
     template<class P> void _draw(const P &poly)
     {
         m_rasterizer.reset();
         
-        m_rasterizer.add_path(to_path(contour(poly)));
-        for(auto& h : holes(poly)) m_rasterizer.add_path(to_path(h));
+        m_transform.add_paths(m_rasterizer, poly);
         
         agg::render_scanlines(m_rasterizer, m_scanlines, m_renderer);
     }
@@ -132,8 +172,7 @@ public:
               const TColor &    foreground,
               const TColor &    background,
               GammaFn &&        gammafn)
-        : m_resolution(res)
-        , m_pxdim_scaled(SCALING_FACTOR, SCALING_FACTOR)
+        : m_transform(res, pd, trafo)
         , m_buf(res.pixels())
         , m_rbuf(reinterpret_cast<TValue *>(m_buf.data()),
                  unsigned(res.width_px),
@@ -142,33 +181,23 @@ public:
         , m_pixrenderer(m_rbuf)
         , m_raw_renderer(m_pixrenderer)
         , m_renderer(m_raw_renderer)
-        , m_trafo(trafo)
     {
-        // Visual Studio compiler gives warnings about possible division by zero.
-        assert(pd.w_mm != 0 && pd.h_mm != 0);
-        if (pd.w_mm != 0 && pd.h_mm != 0) {
-            m_pxdim_scaled.w_mm /= pd.w_mm;
-            m_pxdim_scaled.h_mm /= pd.h_mm;
-        }
         m_renderer.color(foreground);
         clear(background);
         
         m_rasterizer.gamma(gammafn);
     }
     
-    Trafo trafo() const override { return m_trafo; }
-    Resolution resolution() const { return m_resolution; }
-    PixelDim   pixel_dimensions() const
-    {
-        return {SCALING_FACTOR / m_pxdim_scaled.w_mm,
-                SCALING_FACTOR / m_pxdim_scaled.h_mm};
-    }
+    Trafo trafo() const override { return m_transform.trafo(); }
+    Resolution resolution() const { return m_transform.resolution(); }
+    PixelDim   pixel_dimensions() const { return m_transform.pixel_dimensions(); }
     
     void draw(const ExPolygon &poly) override { _draw(poly); }
     
     EncodedRaster encode(RasterEncoder encoder) const override
     {
-        return encoder(m_buf.data(), m_resolution.width_px, m_resolution.height_px, 1);    
+        Resolution res = resolution();
+        return encoder(m_buf.data(), res.width_px, res.height_px, 1);    
     }
     
     void clear(const TColor color) { m_raw_renderer.clear(color); }
@@ -210,6 +239,16 @@ public:
         Base::m_buf[row * Base::resolution().width_px + col].get(px);
         return px;
     }
+
+    // Pixels of one row, stored continuously
+    const uint8_t *row_pixels(size_t row) const
+    {
+        static_assert(sizeof(typename Base::TPixel) == sizeof(uint8_t),
+                      "Not grayscale pix");
+
+        return reinterpret_cast<const uint8_t *>(
+            Base::m_buf.data() + row * Base::resolution().width_px);
+    }
     
     void clear() { Base::clear(Colors<TColor>::Black); }
 };
@@ -224,6 +263,126 @@ public:
     {}
 };
 
+/*
+ * Anti-aliased monochrome canvas producing the same image as
+ * RasterGrayscaleAA, without allocating the whole frame. The rendered
+ * scanlines are blended into runs of non-black pixels per row, thus memory
+ * and drawing time scale with the drawn area and empty rows cost nothing.
+ * That matters for the high resolution masked LCD printers, where most of the
+ * frame is black.
+ */
+class RasterGrayscaleAARuns : public RasterBase {
+    AGGPathTransform m_transform;
+    RasterRuns       m_runs;
+
+    agg::scanline_p8              m_scanlines;
+    agg::rasterizer_scanline_aa<> m_rasterizer;
+
+    // Pixel runs of the scanline being rendered, reused between the rows.
+    std::vector<PixelRun> m_scanline_runs;
+    std::vector<PixelRun> m_merged_runs;
+
+    // Blend the runs of a scanline with white into the row, the same way
+    // as agg::renderer_scanline_aa_solid blends into agg::pixfmt_gray8.
+    void blend_row(size_t row);
+
+    // Renderer interface required by agg::render_scanlines().
+    struct RunsRenderer {
+        RasterGrayscaleAARuns &self;
+
+        void prepare() {}
+        template<class Scanline> void render(const Scanline &sl);
+    };
+
+public:
+    template<class GammaFn>
+    RasterGrayscaleAARuns(const Resolution        &res,
+                          const PixelDim          &pd,
+                          const RasterBase::Trafo &trafo,
+                          GammaFn                &&fn)
+        : m_transform(res, pd, trafo)
+    {
+        m_runs.resolution = res;
+        m_runs.rows.resize(res.height_px);
+        m_rasterizer.gamma(std::forward<GammaFn>(fn));
+    }
+
+    Trafo trafo() const override { return m_transform.trafo(); }
+    Resolution resolution() const { return m_transform.resolution(); }
+    PixelDim   pixel_dimensions() const { return m_transform.pixel_dimensions(); }
+
+    const RasterRuns& runs() const { return m_runs; }
+
+    void draw(const ExPolygon &poly) override
+    {
+        m_rasterizer.reset();
+        m_transform.add_paths(m_rasterizer, poly);
+
+        RunsRenderer renderer{*this};
+        agg::render_scanlines(m_rasterizer, m_scanlines, renderer);
+    }
+
+    // Unpacks the runs into a full frame for the encoders of raw pixels.
+    EncodedRaster encode(RasterEncoder encoder) const override;
+
+    EncodedRaster encode(RasterEncoder encoder, RasterRunsEncoder runs_encoder) const override
+    {
+        return runs_encoder ? runs_encoder(m_runs) : encode(std::move(encoder));
+    }
+};
+
+template<class Scanline>
+void RasterGrayscaleAARuns::RunsRenderer::render(const Scanline &sl)
+{
+    const Resolution res = self.m_runs.resolution;
+    const int y = sl.y();
+    if (y < 0 || y >= int(res.height_px))
+        return;
+
+    // Clip the spans to the raster like agg::renderer_base does. Runs of
+    // anti-aliased spans are split where the cover changes.
+    std::vector<PixelRun> &runs = self.m_scanline_runs;
+    runs.clear();
+    auto add_pixels = [&runs](int x, int len, uint8_t cover) {
+        if (cover == 0)
+            return;
+        if (! runs.empty() && runs.back().value == cover && int(runs.back().x + runs.back().len) == x)
+            runs.back().len += uint32_t(len);
+        else
+            runs.push_back({ uint32_t(x), uint32_t(len), cover });
+    };
+
+    const int xmax = int(res.width_px);
+    unsigned num_spans = sl.num_spans();
+    typename Scanline::const_iterator span = sl.begin();
+    for (;;) {
+        int x = span->x;
+        if (span->len > 0) {
+            // Anti-aliased span, one cover per pixel.
+            const agg::int8u *covers = span->covers;
+            int x_end = std::min(x + int(span->len), xmax);
+            if (x < 0) {
+                covers -= x;
+                x = 0;
+            }
+            for (; x < x_end; ++ x, ++ covers)
+                add_pixels(x, 1, *covers);
+        } else {
+            // Solid span of a single cover.
+            int x_end = std::min(x - int(span->len), xmax);
+            x = std::max(x, 0);
+            if (x < x_end)
+                add_pixels(x, x_end - x, *span->covers);
+        }
+        if (-- num_spans == 0)
+            break;
+        ++ span;
+    }
+
+    if (! runs.empty())
+        self.blend_row(size_t(y));
+}
+
 }} // namespace Slic3r::sla
 
 #endif // AGGRASTER_HPP
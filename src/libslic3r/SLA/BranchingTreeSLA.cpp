@@ -39,6 +39,9 @@ class BranchingTreeBuilder: public branchingtree::Builder {
 
     std::vector<branchingtree::Node> m_pillars; // to put an index over them
 
+    // Check the candidate connections of a node concurrently
+    bool m_batch_checks = true;
+
     // cache succesfull ground connections
     mutable std::map<int, GroundConnection> m_gnd_connections;
     mutable execution::SpinningMutex<ExecutionTBB>  m_gnd_connections_mtx;
@@ -56,6 +59,53 @@ class BranchingTreeBuilder: public branchingtree::Builder {
 
     std::vector<size_t>  m_unroutable_pinheads;
 
+    // Results of the last check_connections() call, used by the add_* methods
+    // called with the same connection instead of repeating the mesh queries.
+    struct CheckedConnection
+    {
+        bool                  feasible = false;
+        std::optional<Anchor> anchor;     // of a mesh bridge
+    };
+
+    std::vector<branchingtree::Connection> m_checked_conns;
+    std::vector<CheckedConnection>         m_checked;
+
+    static bool is_same_node(const branchingtree::Node &a,
+                             const branchingtree::Node &b)
+    {
+        return a.id == b.id && a.pos == b.pos && a.Rmin == b.Rmin &&
+               a.weight == b.weight;
+    }
+
+    const CheckedConnection *find_checked(branchingtree::Connection::Type type,
+                                          const branchingtree::Node &from,
+                                          const branchingtree::Node &to,
+                                          const branchingtree::Node *merge_node = nullptr) const
+    {
+        for (size_t i = 0; i < m_checked_conns.size(); ++i) {
+            const branchingtree::Connection &c = m_checked_conns[i];
+            if (c.type == type && is_same_node(c.from, from) &&
+                is_same_node(c.to, to) &&
+                (!merge_node || is_same_node(c.merge_node, *merge_node)))
+                return &m_checked[i];
+        }
+
+        return nullptr;
+    }
+
+    bool check_bridge(const branchingtree::Node &from,
+                      const branchingtree::Node &to) const;
+
+    bool check_merger(const branchingtree::Node &node,
+                      const branchingtree::Node &closest,
+                      const branchingtree::Node &merge_node) const;
+
+    GroundConnection search_ground_connection(const branchingtree::Node &from,
+                                              const branchingtree::Node &to) const;
+
+    std::optional<Anchor> find_mesh_anchor(const branchingtree::Node &from,
+                                           const branchingtree::Node &to) const;
+
     void build_subtree(size_t root)
     {
         traverse(m_cloud, root, [this](const branchingtree::Node &node) {
@@ -144,10 +194,14 @@ class BranchingTreeBuilder: public branchingtree::Builder {
 public:
     BranchingTreeBuilder(SupportTreeBuilder          &builder,
                      const SupportableMesh       &sm,
-                     const branchingtree::PointCloud &cloud)
-        : m_builder{builder}, m_sm{sm}, m_cloud{cloud}
+                     const branchingtree::PointCloud &cloud,
+                     bool                         batch_checks = true)
+        : m_builder{builder}, m_sm{sm}, m_cloud{cloud}, m_batch_checks{batch_checks}
     {}
 
+    std::vector<bool> check_connections(
+        const std::vector<branchingtree::Connection> &conns) override;
+
     bool add_bridge(const branchingtree::Node &from,
                     const branchingtree::Node &to) override;
 
@@ -202,8 +256,8 @@ public:
     }
 };
 
-bool BranchingTreeBuilder::add_bridge(const branchingtree::Node &from,
-                                      const branchingtree::Node &to)
+bool BranchingTreeBuilder::check_bridge(const branchingtree::Node &from,
+                                        const branchingtree::Node &to) const
 {
     Vec3d fromd = from.pos.cast<double>(), tod = to.pos.cast<double>();
     double fromR = get_radius(from), toR = get_radius(to);
@@ -216,9 +270,9 @@ bool BranchingTreeBuilder::add_bridge(const branchingtree::Node &from,
     return ret;
 }
 
-bool BranchingTreeBuilder::add_merger(const branchingtree::Node &node,
-                                      const branchingtree::Node &closest,
-                                      const branchingtree::Node &merge_node)
+bool BranchingTreeBuilder::check_merger(const branchingtree::Node &node,
+                                        const branchingtree::Node &closest,
+                                        const branchingtree::Node &merge_node) const
 {
     Vec3d from1d = node.pos.cast<double>(),
           from2d = closest.pos.cast<double>(),
@@ -240,27 +294,156 @@ bool BranchingTreeBuilder::add_merger(const branchingtree::Node &node,
     return ret;
 }
 
+GroundConnection BranchingTreeBuilder::search_ground_connection(
+    const branchingtree::Node &from, const branchingtree::Node &to) const
+{
+    sla::Junction j{from.pos.cast<double>(), get_radius(from)};
+    Vec3d init_dir = (to.pos - from.pos).cast<double>().normalized();
+
+    return deepsearch_ground_connection(beam_ex_policy , m_sm, j,
+                                        get_radius(to), init_dir);
+}
+
+std::optional<Anchor> BranchingTreeBuilder::find_mesh_anchor(
+    const branchingtree::Node &from, const branchingtree::Node &to) const
+{
+    if (from.weight > m_sm.cfg.max_weight_on_model_support)
+        return {};
+
+    sla::Junction fromj = {from.pos.cast<double>(), get_radius(from)};
+
+    auto anchor = m_sm.cfg.ground_facing_only ?
+                      std::optional<Anchor>{} : // If no mesh connections are allowed
+                      calculate_anchor_placement(beam_ex_policy , m_sm, fromj,
+                                                 to.pos.cast<double>());
+
+    if (anchor) {
+        sla::Junction toj = {anchor->junction_point(), anchor->r_back_mm};
+
+        auto hit = beam_mesh_hit(beam_ex_policy , m_sm.emesh,
+                                 Beam{{fromj.pos, fromj.r}, {toj.pos, toj.r}}, 0.);
+
+        if (hit.distance() <= distance(fromj.pos, toj.pos))
+            anchor.reset();
+    }
+
+    return anchor;
+}
+
+std::vector<bool> BranchingTreeBuilder::check_connections(
+    const std::vector<branchingtree::Connection> &conns)
+{
+    using Connection = branchingtree::Connection;
+
+    if (!m_batch_checks)
+        return Builder::check_connections(conns);
+
+    m_checked_conns = conns;
+    m_checked.assign(conns.size(), {});
+
+    // All the candidates of one node share the ground connection, which is
+    // searched with the first ground bridge candidate in the order, the
+    // same way as if the candidates were tried one by one.
+    auto first_gnd = std::find_if(conns.begin(), conns.end(), [](auto &c) {
+        return c.type == Connection::GroundBridge;
+    });
+
+    execution::for_each(ex_tbb, size_t(0), conns.size(),
+        [this, &conns, &first_gnd](size_t i) {
+            if (m_builder.ctl().stopcondition())
+                return;
+
+            const Connection  &c   = conns[i];
+            CheckedConnection &res = m_checked[i];
+
+            switch (c.type) {
+            case Connection::Bridge:
+                res.feasible = check_bridge(c.from, c.to);
+                break;
+            case Connection::Merger:
+                res.feasible = check_merger(c.from, c.to, c.merge_node);
+                break;
+            case Connection::GroundBridge: {
+                if (i != size_t(first_gnd - conns.begin()))
+                    break;
+
+                std::optional<GroundConnection> cached;
+                {
+                    std::lock_guard lk{m_gnd_connections_mtx};
+                    auto it = m_gnd_connections.find(c.from.id);
+                    if (it != m_gnd_connections.end())
+                        cached = it->second;
+                }
+
+                // Remember the result even if the node can't go to ground,
+                // as add_ground_bridge() would, so that the node retried with
+                // more candidates or an avoidance is not searched again.
+                if (!cached) {
+                    cached = search_ground_connection(c.from, c.to);
+                    std::lock_guard lk{m_gnd_connections_mtx};
+                    m_gnd_connections[c.from.id] = *cached;
+                }
+
+                res.feasible = bool(*cached);
+                break;
+            }
+            case Connection::MeshBridge:
+                res.anchor   = find_mesh_anchor(c.from, c.to);
+                res.feasible = bool(res.anchor);
+                break;
+            }
+        }, 1);
+
+    for (size_t i = 0; i < conns.size(); ++i)
+        if (conns[i].type == Connection::GroundBridge && first_gnd != conns.begin() + i)
+            m_checked[i].feasible = m_checked[first_gnd - conns.begin()].feasible;
+
+    std::vector<bool> ret(conns.size());
+    for (size_t i = 0; i < conns.size(); ++i)
+        ret[i] = m_checked[i].feasible;
+
+    return ret;
+}
+
+bool BranchingTreeBuilder::add_bridge(const branchingtree::Node &from,
+                                      const branchingtree::Node &to)
+{
+    using Connection = branchingtree::Connection;
+
+    if (auto *checked = find_checked(Connection::Bridge, from, to))
+        return checked->feasible;
+
+    return check_bridge(from, to);
+}
+
+bool BranchingTreeBuilder::add_merger(const branchingtree::Node &node,
+                                      const branchingtree::Node &closest,
+                                      const branchingtree::Node &merge_node)
+{
+    using Connection = branchingtree::Connection;
+
+    if (auto *checked = find_checked(Connection::Merger, node, closest, &merge_node))
+        return checked->feasible;
+
+    return check_merger(node, closest, merge_node);
+}
+
 bool BranchingTreeBuilder::add_ground_bridge(const branchingtree::Node &from,
                                              const branchingtree::Node &to)
 {
     bool ret = false;
 
-    namespace bgi = boost::geometry::index;
-
+    // The ground connection is already known if it was searched by
+    // check_connections().
     auto it = m_gnd_connections.find(from.id);
     const GroundConnection *connptr = nullptr;
 
     if (it == m_gnd_connections.end()) {
-        sla::Junction j{from.pos.cast<double>(), get_radius(from)};
-        Vec3d init_dir = (to.pos - from.pos).cast<double>().normalized();
-
-        auto conn = deepsearch_ground_connection(beam_ex_policy , m_sm, j,
-                                                 get_radius(to), init_dir);
-
         // Remember that this node was tested if can go to ground, don't
         // test it with any other destination ground point because
         // it is unlikely that search_ground_route would find a better solution
-        connptr = &(m_gnd_connections[from.id] = conn);
+        connptr = &(m_gnd_connections[from.id] =
+                        search_ground_connection(from, to));
     } else {
         connptr = &(it->second);
     }
@@ -277,30 +460,19 @@ bool BranchingTreeBuilder::add_ground_bridge(const branchingtree::Node &from,
 bool BranchingTreeBuilder::add_mesh_bridge(const branchingtree::Node &from,
                                            const branchingtree::Node &to)
 {
-    if (from.weight > m_sm.cfg.max_weight_on_model_support)
-        return false;
+    using Connection = branchingtree::Connection;
 
-    sla::Junction fromj = {from.pos.cast<double>(), get_radius(from)};
-
-    auto anchor = m_sm.cfg.ground_facing_only ?
-                      std::optional<Anchor>{} : // If no mesh connections are allowed
-                      calculate_anchor_placement(beam_ex_policy , m_sm, fromj,
-                                                 to.pos.cast<double>());
+    auto *checked = find_checked(Connection::MeshBridge, from, to);
+    auto  anchor  = checked ? checked->anchor : find_mesh_anchor(from, to);
 
     if (anchor) {
-        sla::Junction toj = {anchor->junction_point(), anchor->r_back_mm};
+        sla::Junction fromj = {from.pos.cast<double>(), get_radius(from)};
+        sla::Junction toj   = {anchor->junction_point(), anchor->r_back_mm};
 
-        auto hit = beam_mesh_hit(beam_ex_policy , m_sm.emesh,
-                                 Beam{{fromj.pos, fromj.r}, {toj.pos, toj.r}}, 0.);
+        m_builder.add_diffbridge(fromj.pos, toj.pos, fromj.r, toj.r);
+        m_builder.add_anchor(*anchor);
 
-        if (hit.distance() > distance(fromj.pos, toj.pos)) {
-            m_builder.add_diffbridge(fromj.pos, toj.pos, fromj.r, toj.r);
-            m_builder.add_anchor(*anchor);
-
-            build_subtree(from.id);
-        } else {
-            anchor.reset();
-        }
+        build_subtree(from.id);
     }
 
     return bool(anchor);
@@ -370,7 +542,7 @@ inline void build_pillars(SupportTreeBuilder &builder,
     }
 }
 
-void create_branching_tree(SupportTreeBuilder &builder, const SupportableMesh &sm)
+void create_branching_tree(SupportTreeBuilder &builder, const SupportableMesh &sm, bool batch_checks)
 {
     auto coordfn = [&sm](size_t id, size_t dim) { return sm.pts[id].pos(dim); };
     KDTreeIndirect<3, float, decltype (coordfn)> tree{coordfn, sm.pts.size()};
@@ -422,7 +594,7 @@ void create_branching_tree(SupportTreeBuilder &builder, const SupportableMesh &s
     branchingtree::PointCloud nodes{std::move(meshpts), std::move(bedpts),
                                     std::move(leafs), props};
 
-    BranchingTreeBuilder vbuilder{builder, sm, nodes};
+    BranchingTreeBuilder vbuilder{builder, sm, nodes, batch_checks};
 
     execution::for_each(ex_tbb,
                         size_t(0),
@@ -14,7 +14,10 @@ namespace Slic3r { namespace sla {
 class SupportTreeBuilder;
 struct SupportableMesh;
 
-void create_branching_tree(SupportTreeBuilder& builder, const SupportableMesh &sm);
+// The candidate connections of each node are checked concurrently unless
+// batch_checks is false, the resulting tree is the same.
+void create_branching_tree(SupportTreeBuilder& builder, const SupportableMesh &sm,
+                           bool batch_checks = true);
 
 }} // namespace Slic3r::sla
 
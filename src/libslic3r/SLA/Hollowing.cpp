@@ -9,7 +9,7 @@
 #include <libslic3r/AABBTreeIndirect.hpp>
 #include <libslic3r/AABBMesh.hpp>
 #include <libslic3r/ClipperUtils.hpp>
-#include <libslic3r/Execution/ExecutionSeq.hpp>
+#include <libslic3r/Execution/ExecutionTBB.hpp>
 #include <libslic3r/Model.hpp>
 #include <libslic3r/MeshBoolean.hpp>
 #include <boost/log/trivial.hpp>
@@ -330,11 +330,12 @@ struct TriangleBubble { Vec3f center; double R; };
 
 // Return the distance of bubble center to the interior boundary or NaN if the
 // triangle is too big to be measured.
-static double get_distance(const TriangleBubble &b, const Interior &interior)
+static double get_distance(const TriangleBubble &b, const Interior &interior,
+                           const VoxelGridAccessor &accessor)
 {
     double R = b.R;
     double D = 2. * R;
-    double Dst = get_distance_raw(b.center, interior);
+    double Dst = accessor.get_distance_raw(b.center);
 
     return D > interior.full_narrowb ||
            ((Dst - R) < 0. && 2 * R > interior.thickness) ?
@@ -406,8 +407,6 @@ void divide_triangle(const DivFace &face, Fn &&visitor)
 void remove_inside_triangles(indexed_triangle_set &mesh, const Interior &interior,
                              const std::vector<bool> &exclude_mask)
 {
-    enum TrPos { posInside, posTouch, posOutside };
-
     auto &faces       = mesh.indices;
     auto &vertices    = mesh.vertices;
     auto bb           = bounding_box(mesh); //mesh.bounding_box();
@@ -417,37 +416,24 @@ void remove_inside_triangles(indexed_triangle_set &mesh, const Interior &interio
         return use_exclude_mask && exclude_mask[face_id];
     };
 
-    // TODO: Parallel mode not working yet
-    constexpr auto &exec_policy = ex_seq;
+    // The faces are classified in batches, each with its own grid accessor.
+    // The divided faces only touch their own top parent, and the triangles
+    // to be re-added are collected per batch so that their order does not
+    // depend on the scheduling of the batches.
+    constexpr size_t BatchSize = 1000;
 
     // Info about the needed modifications on the input mesh.
     struct MeshMods {
 
-        // Just a thread safe wrapper for a vector of triangles.
-        struct {
-            std::vector<std::array<Vec3f, 3>> data;
-            execution::SpinningMutex<decltype(exec_policy)> mutex;
-
-            void emplace_back(const std::array<Vec3f, 3> &pts)
-            {
-                std::lock_guard lk{mutex};
-                data.emplace_back(pts);
-            }
+        // The triangles to be re-added, separately for each batch of faces.
+        std::vector<std::vector<std::array<Vec3f, 3>>> new_triangles;
 
-            size_t size() const { return data.size(); }
-            const std::array<Vec3f, 3>& operator[](size_t idx) const
-            {
-                return data[idx];
-            }
+        // A flag for all faces signaling if it needs to be removed or not.
+        // Not a vector of bool, as those are written from multiple threads.
+        std::vector<char> to_remove;
 
-        } new_triangles;
-
-        // A vector of bool for all faces signaling if it needs to be removed
-        // or not.
-        std::vector<bool> to_remove;
-
-        MeshMods(const indexed_triangle_set &mesh):
-            to_remove(mesh.indices.size(), false) {}
+        MeshMods(const indexed_triangle_set &mesh, size_t batches):
+            new_triangles(batches), to_remove(mesh.indices.size(), false) {}
 
         // Number of triangles that need to be removed.
         size_t to_remove_cnt() const
@@ -455,99 +441,113 @@ void remove_inside_triangles(indexed_triangle_set &mesh, const Interior &interio
             return std::accumulate(to_remove.begin(), to_remove.end(), size_t(0));
         }
 
-    } mesh_mods{mesh};
+        // Number of triangles that need to be added.
+        size_t new_triangles_cnt() const
+        {
+            return std::accumulate(new_triangles.begin(), new_triangles.end(), size_t(0),
+                                   [](size_t a, const auto &v) { return a + v.size(); });
+        }
 
-    // Must return true if further division of the face is needed.
-    auto divfn = [&interior, bb, &mesh_mods](const DivFace &f) {
-        BoundingBoxf3 facebb { f.verts.begin(), f.verts.end() };
+    } mesh_mods{mesh, (faces.size() + BatchSize - 1) / BatchSize};
 
-        // Face is certainly outside the cavity
-        if (! facebb.intersects(bb) && f.faceid != NEW_FACE) {
-            return false;
-        }
+    execution::for_each(
+        ex_tbb, size_t(0), mesh_mods.new_triangles.size(),
+        [&](size_t batch_idx) {
+            VoxelGridAccessor accessor{*interior.gridptr};
+            auto &new_triangles = mesh_mods.new_triangles[batch_idx];
 
-        TriangleBubble bubble{facebb.center().cast<float>(), facebb.radius()};
+            // Must return true if further division of the face is needed.
+            auto divfn = [&](const DivFace &f) {
+                BoundingBoxf3 facebb { f.verts.begin(), f.verts.end() };
 
-        double D = get_distance(bubble, interior);
-        double R = bubble.R;
+                // Face is certainly outside the cavity
+                if (! facebb.intersects(bb) && f.faceid != NEW_FACE) {
+                    return false;
+                }
 
-        if (std::isnan(D)) // The distance cannot be measured, triangle too big
-            return true;
+                TriangleBubble bubble{facebb.center().cast<float>(), facebb.radius()};
 
-        // Distance of the bubble wall to the interior wall. Negative if the
-        // bubble is overlapping with the interior
-        double bubble_distance = D - R;
+                double D = get_distance(bubble, interior, accessor);
+                double R = bubble.R;
 
-        // The face is crossing the interior or inside, it must be removed and
-        // parts of it re-added, that are outside the interior
-        if (bubble_distance < 0.) {
-            if (f.faceid != NEW_FACE)
-                mesh_mods.to_remove[f.faceid] = true;
+                if (std::isnan(D)) // The distance cannot be measured, triangle too big
+                    return true;
 
-            if (f.parent != NEW_FACE) // Top parent needs to be removed as well
-                mesh_mods.to_remove[f.parent] = true;
+                // Distance of the bubble wall to the interior wall. Negative if the
+                // bubble is overlapping with the interior
+                double bubble_distance = D - R;
 
-            // If the outside part is between the interior and the exterior
-            // (inside the wall being invisible), no further division is needed.
-            if ((R + D) < interior.thickness)
-                return false;
+                // The face is crossing the interior or inside, it must be removed and
+                // parts of it re-added, that are outside the interior
+                if (bubble_distance < 0.) {
+                    if (f.faceid != NEW_FACE)
+                        mesh_mods.to_remove[f.faceid] = true;
 
-            return true;
-        } else if (f.faceid == NEW_FACE) {
-            // New face completely outside needs to be re-added.
-            mesh_mods.new_triangles.emplace_back(f.verts);
-        }
+                    if (f.parent != NEW_FACE) // Top parent needs to be removed as well
+                        mesh_mods.to_remove[f.parent] = true;
 
-        return false;
-    };
+                    // If the outside part is between the interior and the exterior
+                    // (inside the wall being invisible), no further division is needed.
+                    if ((R + D) < interior.thickness)
+                        return false;
 
-    interior.reset_accessor();
+                    return true;
+                } else if (f.faceid == NEW_FACE) {
+                    // New face completely outside needs to be re-added.
+                    new_triangles.emplace_back(f.verts);
+                }
 
-    execution::for_each(
-        exec_policy, size_t(0), faces.size(),
-        [&](size_t face_idx) {
-            const Vec3i &face = faces[face_idx];
+                return false;
+            };
+
+            size_t from = batch_idx * BatchSize;
+            size_t to   = std::min(from + BatchSize, faces.size());
+            for (size_t face_idx = from; face_idx < to; ++face_idx) {
+                const Vec3i &face = faces[face_idx];
 
-            // If the triangle is excluded, we need to keep it.
-            if (is_excluded(face_idx))
-                return;
+                // If the triangle is excluded, we need to keep it.
+                if (is_excluded(face_idx))
+                    continue;
 
-            std::array<Vec3f, 3> pts = {vertices[face(0)], vertices[face(1)],
-                                        vertices[face(2)]};
+                std::array<Vec3f, 3> pts = {vertices[face(0)], vertices[face(1)],
+                                            vertices[face(2)]};
 
-            BoundingBoxf3 facebb{pts.begin(), pts.end()};
+                BoundingBoxf3 facebb{pts.begin(), pts.end()};
 
-            // Face is certainly outside the cavity
-            if (!facebb.intersects(bb))
-                return;
+                // Face is certainly outside the cavity
+                if (!facebb.intersects(bb))
+                    continue;
 
-            DivFace df{face, pts, long(face_idx)};
+                DivFace df{face, pts, long(face_idx)};
 
-            if (divfn(df)) divide_triangle(df, divfn);
+                if (divfn(df)) divide_triangle(df, divfn);
+            }
         },
-        execution::max_concurrency(exec_policy)
+        execution::max_concurrency(ex_tbb)
     );
 
-    auto new_faces = reserve_vector<Vec3i>(faces.size() +
-                                           mesh_mods.new_triangles.size());
+    size_t new_triangles_cnt = mesh_mods.new_triangles_cnt();
+    auto new_faces = reserve_vector<Vec3i>(faces.size() + new_triangles_cnt);
 
     for (size_t face_idx = 0; face_idx < faces.size(); ++face_idx) {
         if (!mesh_mods.to_remove[face_idx])
             new_faces.emplace_back(faces[face_idx]);
     }
 
-    for(size_t i = 0; i < mesh_mods.new_triangles.size(); ++i) {
-        size_t o = vertices.size();
-        vertices.emplace_back(mesh_mods.new_triangles[i][0]);
-        vertices.emplace_back(mesh_mods.new_triangles[i][1]);
-        vertices.emplace_back(mesh_mods.new_triangles[i][2]);
-        new_faces.emplace_back(int(o), int(o + 1), int(o + 2));
-    }
+    vertices.reserve(vertices.size() + 3 * new_triangles_cnt);
+    for (const auto &batch : mesh_mods.new_triangles)
+        for (const std::array<Vec3f, 3> &tri : batch) {
+            size_t o = vertices.size();
+            vertices.emplace_back(tri[0]);
+            vertices.emplace_back(tri[1]);
+            vertices.emplace_back(tri[2]);
+            new_faces.emplace_back(int(o), int(o + 1), int(o + 2));
+        }
 
     BOOST_LOG_TRIVIAL(info)
             << "Trimming: " << mesh_mods.to_remove_cnt() << " triangles removed";
     BOOST_LOG_TRIVIAL(info)
-            << "Trimming: " << mesh_mods.new_triangles.size() << " triangles added";
+            << "Trimming: " << new_triangles_cnt << " triangles added";
 
     faces.swap(new_faces);
     new_faces = {};
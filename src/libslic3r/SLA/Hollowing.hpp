@@ -128,30 +128,44 @@ template<class Cont> double csgmesh_positive_maxvolume(const Cont &csg)
     return mesh_vol;
 }
 
+// The signed distance grid of a csg mesh with the given voxel scale. The
+// interior is generated from this grid by offsetting its level set, thus it
+// can be reused for any wall thickness and closing distance. If a cache is
+// given, only the csg parts missing from it are voxelized.
 template<class It>
-InteriorPtr generate_interior(const Range<It>       &csgparts,
-                              const HollowingConfig &hc  = {},
-                              const JobController   &ctl = {})
+VoxelGridPtr generate_interior_grid(const Range<It>     &csgparts,
+                                    double               voxel_scale,
+                                    const JobController &ctl   = {},
+                                    csg::VoxelGridCache *cache = nullptr)
 {
-    double mesh_vol = csgmesh_positive_maxvolume(csgparts);
-    double voxsc    = get_voxel_scale(mesh_vol, hc);
-
     auto params = csg::VoxelizeParams{}
-                      .voxel_scale(voxsc)
+                      .voxel_scale(voxel_scale)
                       .exterior_bandwidth(3.f)
                       .interior_bandwidth(3.f)
                       .statusfn([&ctl](int){
                           return ctl.stopcondition && ctl.stopcondition();
                       });
 
-    auto ptr = csg::voxelize_csgmesh(csgparts, params);
+    auto ptr = cache ? csg::voxelize_csgmesh(csgparts, params, *cache) :
+                       csg::voxelize_csgmesh(csgparts, params);
 
     if (!ptr || (ctl.stopcondition && ctl.stopcondition()))
         return {};
 
-    ptr = redistance_grid(*ptr, IsoAtZero,
-                          params.exterior_bandwidth(),
-                          params.interior_bandwidth());
+    return redistance_grid(*ptr, IsoAtZero,
+                           params.exterior_bandwidth(),
+                           params.interior_bandwidth());
+}
+
+template<class It>
+InteriorPtr generate_interior(const Range<It>       &csgparts,
+                              const HollowingConfig &hc  = {},
+                              const JobController   &ctl = {})
+{
+    double mesh_vol = csgmesh_positive_maxvolume(csgparts);
+    double voxsc    = get_voxel_scale(mesh_vol, hc);
+
+    auto ptr = generate_interior_grid(csgparts, voxsc, ctl);
 
     return ptr ? generate_interior(*ptr, hc, ctl) :
                  InteriorPtr{};
@@ -14,33 +14,341 @@
 #include <cmath>
 #include <iterator>
 #include <cstdlib>
+#include <cstring>
+
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
 
 #include "agg/agg_gamma_functions.h"
 
 namespace Slic3r { namespace sla {
 
-EncodedRaster PNGRasterEncoder::operator()(const void *ptr, size_t w, size_t h,
-                                           size_t      num_components)
+namespace {
+
+void png_write_u32(uint8_t *dst, uint32_t v)
 {
-    std::vector<uint8_t> buf;
-    size_t s = 0;
-    
-    void *rawdata = tdefl_write_image_to_png_file_in_memory(
-        ptr, int(w), int(h), int(num_components), &s);
-    
+    for (int i = 0; i < 4; ++ i, v <<= 8)
+        dst[i] = uint8_t(v >> 24);
+}
+
+void png_append_u32(std::vector<uint8_t> &dst, uint32_t v)
+{
+    dst.resize(dst.size() + 4);
+    png_write_u32(dst.data() + dst.size() - 4, v);
+}
+
+// Same as adler32_combine() of zlib, which miniz does not provide.
+uint32_t adler32_combine(uint32_t adler1, uint32_t adler2, size_t len2)
+{
+    static constexpr uint32_t BASE = 65521;
+    uint32_t rem  = uint32_t(len2 % BASE);
+    uint32_t sum1 = adler1 & 0xffff;
+    uint32_t sum2 = uint32_t((uint64_t(rem) * sum1) % BASE);
+    sum1 += (adler2 & 0xffff) + BASE - 1;
+    sum2 += ((adler1 >> 16) & 0xffff) + ((adler2 >> 16) & 0xffff) + BASE - rem;
+    if (sum1 >= BASE) sum1 -= BASE;
+    if (sum1 >= BASE) sum1 -= BASE;
+    if (sum2 >= (BASE << 1)) sum2 -= (BASE << 1);
+    if (sum2 >= BASE) sum2 -= BASE;
+    return sum1 | (sum2 << 16);
+}
+
+// Uncompressed bytes of the image deflated by a single task. Smaller chunks
+// parallelize better, each chunk starts with an empty deflate dictionary.
+constexpr size_t PNG_CHUNK_BYTES = 1024 * 1024;
+
+using PNGFilter = PNGRasterEncoder::Filter;
+
+uint8_t paeth_predictor(uint8_t a, uint8_t b, uint8_t c)
+{
+    int p  = int(a) + int(b) - int(c);
+    int pa = std::abs(p - int(a));
+    int pb = std::abs(p - int(b));
+    int pc = std::abs(p - int(c));
+    return pa <= pb && pa <= pc ? a : pb <= pc ? b : c;
+}
+
+// Filters the row cur of bpl bytes into dst, prev is the row above (zeros
+// for the first row, not used by the None and Sub filters), bpp is the number
+// of bytes of a pixel (at least one).
+void png_filter_row(PNGFilter filter, const uint8_t *cur, const uint8_t *prev, size_t bpl, size_t bpp, uint8_t *dst)
+{
+    for (size_t i = 0; i < bpl; ++ i) {
+        const uint8_t left = i >= bpp ? cur[i - bpp] : 0;
+        uint8_t       pred = 0;
+        switch (filter) {
+        case PNGFilter::None:    pred = 0; break;
+        case PNGFilter::Sub:     pred = left; break;
+        case PNGFilter::Up:      pred = prev[i]; break;
+        case PNGFilter::Average: pred = uint8_t((int(left) + int(prev[i])) >> 1); break;
+        case PNGFilter::Paeth:   pred = paeth_predictor(left, prev[i], i >= bpp ? prev[i - bpp] : 0); break;
+        }
+        dst[i] = uint8_t(cur[i] - pred);
+    }
+}
+
+// Packs w pixels of an 8 bit row to 1 bit per pixel, the most significant
+// bit first. Non-zero pixels are set.
+void pack_bilevel_row(const uint8_t *src, size_t w, uint8_t *dst)
+{
+    for (size_t x = 0; x < w; x += 8) {
+        uint8_t byte = 0;
+        for (size_t i = x; i < std::min(w, x + 8); ++ i)
+            byte |= uint8_t(src[i] != 0) << (7 - (i - x));
+        dst[x / 8] = byte;
+    }
+}
+
+// Writes a PNG of rows filtered by filter. Unfiltered rows suit the masks
+// best: they are mostly runs of black and white and rows repeating the row
+// above, which deflate matches well by itself, while the PNG row filters only
+// turn the edges into noise. If bilevel, the single component image of just
+// black and white pixels is written with 1 bit per pixel.
+// The image is split into chunks of rows deflated in parallel into a single
+// zlib stream, each chunk ends on a byte boundary by a sync flush (same as
+// pigz does), so even a single large frame uses all the cores not busy with
+// other layers.
+// get_row(y, buf) returns a pointer to w * num_components bytes of row y,
+// it may use buf as a storage.
+template<class GetRowFn>
+EncodedRaster encode_png(size_t w, size_t h, size_t num_components, int level, PNGFilter filter, bool bilevel, GetRowFn &&get_row)
+{
+    static const uint8_t color_types[] = { 0x00, 0x00, 0x04, 0x02, 0x06 };
+    if (num_components < 1 || num_components > 4 || w == 0 || h == 0 || (bilevel && num_components != 1))
+        return EncodedRaster({}, "png");
+
+    // Bytes of an encoded row and of an encoded pixel (at least one byte as the filters require).
+    const size_t bpl            = bilevel ? (w + 7) / 8 : w * num_components;
+    const size_t bpp            = bilevel ? 1 : num_components;
+    // Rows filtered by the row above.
+    const bool   uses_prev      = filter == PNGFilter::Up || filter == PNGFilter::Average || filter == PNGFilter::Paeth;
+    const size_t rows_per_chunk = std::max<size_t>(1, PNG_CHUNK_BYTES / (bpl + 1));
+    const size_t num_chunks     = (h + rows_per_chunk - 1) / rows_per_chunk;
+    // Raw deflate, the zlib header and the checksum are written here.
+    const mz_uint comp_flags = tdefl_create_comp_flags_from_zip_params(level, -MZ_DEFAULT_WINDOW_BITS, MZ_DEFAULT_STRATEGY);
+
+    struct Chunk {
+        std::vector<uint8_t> data;
+        uint32_t             adler = MZ_ADLER32_INIT;
+        size_t               raw_size = 0;
+        bool                 ok = false;
+    };
+    std::vector<Chunk> chunks(num_chunks);
+
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_chunks, 1), [&](const tbb::blocked_range<size_t> &range) {
+        auto compressor = std::make_unique<tdefl_compressor>();
+        std::vector<uint8_t> row_buf(w * num_components);
+        std::vector<uint8_t> packed(bilevel ? bpl : 0);
+        std::vector<uint8_t> prev(uses_prev ? bpl : 0);
+        std::vector<uint8_t> filtered(filter == PNGFilter::None ? 0 : bpl);
+        const uint8_t        filter_type = uint8_t(filter);
+        // Row y as encoded before filtering.
+        auto encoded_row = [&](size_t y) {
+            const uint8_t *row = get_row(y, row_buf);
+            if (! bilevel)
+                return row;
+            pack_bilevel_row(row, w, packed.data());
+            return static_cast<const uint8_t*>(packed.data());
+        };
+        auto putter = [](const void *data, int len, void *user) -> mz_bool {
+            auto &dst = *static_cast<std::vector<uint8_t>*>(user);
+            auto  src = static_cast<const uint8_t*>(data);
+            dst.insert(dst.end(), src, src + len);
+            return MZ_TRUE;
+        };
+        for (size_t chunk_idx = range.begin(); chunk_idx < range.end(); ++ chunk_idx) {
+            Chunk &chunk = chunks[chunk_idx];
+            const size_t row_begin = chunk_idx * rows_per_chunk;
+            const size_t row_end   = std::min(h, row_begin + rows_per_chunk);
+            tdefl_init(compressor.get(), putter, &chunk.data, int(comp_flags));
+
+            if (uses_prev) {
+                // The first row of a chunk is filtered by the last row of the previous chunk.
+                if (row_begin == 0)
+                    std::fill(prev.begin(), prev.end(), uint8_t(0));
+                else {
+                    const uint8_t *row = encoded_row(row_begin - 1);
+                    std::copy(row, row + bpl, prev.begin());
+                }
+            }
+
+            bool ok = true;
+            for (size_t y = row_begin; y < row_end && ok; ++ y) {
+                const uint8_t *row = encoded_row(y);
+                const uint8_t *out = row;
+                if (filter != PNGFilter::None) {
+                    png_filter_row(filter, row, prev.data(), bpl, bpp, filtered.data());
+                    out = filtered.data();
+                    if (uses_prev)
+                        std::copy(row, row + bpl, prev.begin());
+                }
+                chunk.adler = uint32_t(mz_adler32(chunk.adler, &filter_type, 1));
+                chunk.adler = uint32_t(mz_adler32(chunk.adler, out, bpl));
+                ok = tdefl_compress_buffer(compressor.get(), &filter_type, 1, TDEFL_NO_FLUSH) == TDEFL_STATUS_OKAY &&
+                     tdefl_compress_buffer(compressor.get(), out, bpl, TDEFL_NO_FLUSH) == TDEFL_STATUS_OKAY;
+            }
+            const bool last = chunk_idx + 1 == num_chunks;
+            tdefl_status status = tdefl_compress_buffer(compressor.get(), nullptr, 0, last ? TDEFL_FINISH : TDEFL_SYNC_FLUSH);
+            chunk.raw_size = (row_end - row_begin) * (bpl + 1);
+            chunk.ok       = ok && status == (last ? TDEFL_STATUS_DONE : TDEFL_STATUS_OKAY);
+        }
+    });
+
     // On error, data() will return an empty vector. No other info can be
     // retrieved from miniz anyway...
-    if (rawdata == nullptr) return EncodedRaster({}, "png");
-    
-    auto pptr = static_cast<std::uint8_t*>(rawdata);
-    
-    buf.reserve(s);
-    std::copy(pptr, pptr + s, std::back_inserter(buf));
-    
-    MZ_FREE(rawdata);
+    size_t idat_size = 2 + 4;
+    uint32_t adler = MZ_ADLER32_INIT;
+    for (const Chunk &chunk : chunks) {
+        if (! chunk.ok)
+            return EncodedRaster({}, "png");
+        idat_size += chunk.data.size();
+        adler = adler32_combine(adler, chunk.adler, chunk.raw_size);
+    }
+
+    std::vector<uint8_t> buf;
+    buf.reserve(8 + 25 + 12 + idat_size + 12);
+    static const uint8_t signature[8] = { 0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a };
+    buf.insert(buf.end(), signature, signature + sizeof(signature));
+
+    auto begin_chunk = [&buf](const char *type, size_t size) {
+        png_append_u32(buf, uint32_t(size));
+        buf.insert(buf.end(), type, type + 4);
+        return buf.size() - 4;
+    };
+    auto end_chunk = [&buf](size_t start) {
+        png_append_u32(buf, uint32_t(mz_crc32(MZ_CRC32_INIT, buf.data() + start, buf.size() - start)));
+    };
+
+    size_t start = begin_chunk("IHDR", 13);
+    png_append_u32(buf, uint32_t(w));
+    png_append_u32(buf, uint32_t(h));
+    // bit depth, color type, default compression, filter method, no interlace
+    const uint8_t ihdr_tail[5] = { uint8_t(bilevel ? 1 : 8), color_types[num_components], 0, 0, 0 };
+    buf.insert(buf.end(), ihdr_tail, ihdr_tail + sizeof(ihdr_tail));
+    end_chunk(start);
+
+    start = begin_chunk("IDAT", idat_size);
+    // zlib header: deflate with 32K window, no preset dictionary
+    buf.push_back(0x78);
+    buf.push_back(0x01);
+    for (const Chunk &chunk : chunks)
+        buf.insert(buf.end(), chunk.data.begin(), chunk.data.end());
+    png_append_u32(buf, adler);
+    end_chunk(start);
+
+    start = begin_chunk("IEND", 0);
+    end_chunk(start);
+
     return EncodedRaster(std::move(buf), "png");
 }
 
+} // namespace
+
+EncodedRaster PNGRasterEncoder::operator()(const void *ptr, size_t w, size_t h,
+                                           size_t      num_components)
+{
+    const auto *pixels = static_cast<const uint8_t*>(ptr);
+    const size_t bpl = w * num_components;
+    const bool   black_and_white = bilevel && num_components == 1 &&
+        std::all_of(pixels, pixels + bpl * h, [](uint8_t px) { return px == 0 || px == 255; });
+    return encode_png(w, h, num_components, compression_level, filter, black_and_white,
+        [pixels, bpl](size_t y, std::vector<uint8_t>&) { return pixels + y * bpl; });
+}
+
+// Only the rows being compressed are unpacked.
+EncodedRaster PNGRasterEncoder::operator()(const RasterRuns &runs)
+{
+    // The pixels not covered by the runs are black.
+    const bool black_and_white = bilevel &&
+        std::all_of(runs.rows.begin(), runs.rows.end(), [](const auto &row) {
+            return std::all_of(row.begin(), row.end(), [](const PixelRun &run) { return run.value == 0 || run.value == 255; });
+        });
+    return encode_png(runs.resolution.width_px, runs.resolution.height_px, 1, compression_level, filter, black_and_white,
+        [&runs](size_t y, std::vector<uint8_t> &buf) {
+            std::fill(buf.begin(), buf.end(), uint8_t(0));
+            runs.unpack_row(y, buf.data());
+            return static_cast<const uint8_t*>(buf.data());
+        });
+}
+
+void RasterRuns::unpack_row(size_t row, uint8_t *dst) const
+{
+    for (const PixelRun &run : rows[row])
+        std::memset(dst + run.x, run.value, run.len);
+}
+
+void RasterGrayscaleAARuns::blend_row(size_t row)
+{
+    // Same as agg::pixfmt_gray8::blend_solid_hspan() with white color.
+    auto blend = [](uint8_t px, uint8_t cover) -> uint8_t {
+        return cover == agg::cover_mask ?
+            uint8_t(255) :
+            agg::gray8::lerp(px, 255, agg::gray8::mult_cover(255, cover));
+    };
+
+    std::vector<PixelRun> &dst = m_merged_runs;
+    dst.clear();
+    auto push = [&dst](uint32_t x, uint32_t len, uint8_t value) {
+        if (len == 0 || value == 0)
+            return;
+        if (! dst.empty() && dst.back().value == value && dst.back().x + dst.back().len == x)
+            dst.back().len += len;
+        else
+            dst.push_back({ x, len, value });
+    };
+
+    // Sweep the old runs of the row (a) and the runs of the scanline (b).
+    const std::vector<PixelRun> &old_runs = m_runs.rows[row];
+    const std::vector<PixelRun> &new_runs = m_scanline_runs;
+    auto it_a = old_runs.begin();
+    auto it_b = new_runs.begin();
+    PixelRun a, b;
+    bool has_a = it_a != old_runs.end(), has_b = it_b != new_runs.end();
+    if (has_a) a = *it_a ++;
+    if (has_b) b = *it_b ++;
+    auto next_a = [&]() { if ((has_a = it_a != old_runs.end())) a = *it_a ++; };
+    auto next_b = [&]() { if ((has_b = it_b != new_runs.end())) b = *it_b ++; };
+
+    while (has_a || has_b) {
+        if (! has_b || (has_a && a.x + a.len <= b.x)) {
+            push(a.x, a.len, a.value);
+            next_a();
+        } else if (! has_a || b.x + b.len <= a.x) {
+            push(b.x, b.len, blend(0, b.value));
+            next_b();
+        } else {
+            // Overlapping, emit the part before the overlap first.
+            if (a.x < b.x) {
+                push(a.x, b.x - a.x, a.value);
+                a.len -= b.x - a.x;
+                a.x    = b.x;
+            } else if (b.x < a.x) {
+                push(b.x, a.x - b.x, blend(0, b.value));
+                b.len -= a.x - b.x;
+                b.x    = a.x;
+            }
+            uint32_t len = std::min(a.len, b.len);
+            push(a.x, len, blend(a.value, b.value));
+            a.x += len; a.len -= len;
+            b.x += len; b.len -= len;
+            if (a.len == 0) next_a();
+            if (b.len == 0) next_b();
+        }
+    }
+
+    m_runs.rows[row].assign(dst.begin(), dst.end());
+}
+
+EncodedRaster RasterGrayscaleAARuns::encode(RasterEncoder encoder) const
+{
+    const Resolution res = resolution();
+    std::vector<uint8_t> buf(res.pixels(), 0);
+    for (size_t y = 0; y < res.height_px; ++ y)
+        m_runs.unpack_row(y, buf.data() + y * res.width_px);
+
+    return encoder(buf.data(), res.width_px, res.height_px, 1);
+}
+
 std::ostream &operator<<(std::ostream &stream, const EncodedRaster &bytes)
 {
     stream.write(reinterpret_cast<const char *>(bytes.data()),
@@ -88,6 +396,22 @@ std::unique_ptr<RasterBase> create_raster_grayscale_aa(
     return rst;
 }
 
+std::unique_ptr<RasterBase> create_raster_grayscale_aa_runs(
+    const Resolution        &res,
+    const PixelDim          &pxdim,
+    double                   gamma,
+    const RasterBase::Trafo &tr)
+{
+    std::unique_ptr<RasterBase> rst;
+
+    if (gamma > 0)
+        rst = std::make_unique<RasterGrayscaleAARuns>(res, pxdim, tr, agg::gamma_power(gamma));
+    else
+        rst = std::make_unique<RasterGrayscaleAARuns>(res, pxdim, tr, agg::gamma_threshold(.5));
+
+    return rst;
+}
+
 } // namespace sla
 } // namespace Slic3r
 
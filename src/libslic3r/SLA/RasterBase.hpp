@@ -62,9 +62,28 @@ struct PixelDim {
     {}
 };
 
+/// Run of pixels of the same non-black value on a raster row.
+struct PixelRun {
+    uint32_t x     = 0;
+    uint32_t len   = 0;
+    uint8_t  value = 0;
+};
+
+/// Sparse 8-bit grayscale image. Each row is a list of runs sorted by x,
+/// the pixels not covered by any run are black.
+struct RasterRuns {
+    Resolution resolution;
+    std::vector<std::vector<PixelRun>> rows;
+
+    /// Write the pixels of a row into dst of resolution.width_px bytes.
+    void unpack_row(size_t row, uint8_t *dst) const;
+};
+
 using RasterEncoder =
     std::function<EncodedRaster(const void *ptr, size_t w, size_t h, size_t num_components)>;
 
+using RasterRunsEncoder = std::function<EncodedRaster(const RasterRuns &runs)>;
+
 class RasterBase {
 public:
     
@@ -105,10 +124,32 @@ public:
     virtual Trafo      trafo() const = 0;
     
     virtual EncodedRaster encode(RasterEncoder encoder) const = 0;
+
+    /// Rasters keeping their pixels as runs are encoded by runs_encoder
+    /// straight from the runs, the others by encoder.
+    virtual EncodedRaster encode(RasterEncoder encoder, RasterRunsEncoder /*runs_encoder*/) const
+    {
+        return encode(std::move(encoder));
+    }
 };
 
 struct PNGRasterEncoder {
+    // Deflate level 0-10. The archives keep the default level 6, level 1
+    // encodes the layer masks about three times faster for about double
+    // the size.
+    int compression_level = 6;
+    // PNG row filter applied to all the rows. The masks deflate best
+    // unfiltered, the filters may help images with gradients.
+    enum class Filter : uint8_t { None, Sub, Up, Average, Paeth };
+    Filter filter = Filter::None;
+    // Single component images of just black and white pixels, e.g. masks
+    // drawn with gamma thresholding, are written with 1 bit per pixel.
+    // Other images are written with 8 bits per component.
+    bool bilevel = false;
+
     EncodedRaster operator()(const void *ptr, size_t w, size_t h, size_t num_components);
+    // Produces the same PNG as the above from the rows of pixel runs.
+    EncodedRaster operator()(const RasterRuns &runs);
 };
 
 struct PPMRasterEncoder {
@@ -124,6 +165,15 @@ std::unique_ptr<RasterBase> create_raster_grayscale_aa(
     double                   gamma = 1.0,
     const RasterBase::Trafo &tr    = {});
 
+// Same as create_raster_grayscale_aa(), but the raster does not allocate the
+// whole frame, it keeps the pixel runs of the drawn rows only. Memory and
+// drawing time scale with the drawn area instead of with the resolution.
+std::unique_ptr<RasterBase> create_raster_grayscale_aa_runs(
+    const Resolution        &res,
+    const PixelDim          &pxdim,
+    double                   gamma = 1.0,
+    const RasterBase::Trafo &tr    = {});
+
 }} // namespace Slic3r::sla
 
 #endif // SLARASTERBASE_HPP
@@ -8,6 +8,8 @@
 #include <libslic3r/Geometry.hpp>
 #include <limits>
 #include <thread>
+#include <atomic>
+#include <chrono>
 #include <algorithm>
 #include <array>
 #include <cmath>
@@ -84,30 +86,135 @@ struct Facestats {
     }
 };
 
-// Try to guess the number of support points needed to support a mesh
-double get_misalginment_score(const TriangleMesh &mesh, const Transform3f &tr)
-{
-    if (mesh.its.vertices.empty()) return NaNd;
+// Unit normals and areas of the mesh faces, laid out as a structure of arrays.
+// A rotation does not change the face areas, so the rotations can be scored
+// by transforming only the normals, in loops the compiler can vectorize.
+struct FaceNormals {
+    std::vector<float> nx, ny, nz, area;
+
+    explicit FaceNormals(const indexed_triangle_set &its)
+        : nx(its.indices.size())
+        , ny(its.indices.size())
+        , nz(its.indices.size())
+        , area(its.indices.size())
+    {
+        execution::for_each(
+            ex_tbb, size_t(0), its.indices.size(), [this, &its](size_t fi) {
+                const auto &face = its.indices[fi];
+                Facestats   fc{{its.vertices[face(0)], its.vertices[face(1)],
+                                its.vertices[face(2)]}};
+                nx[fi]   = fc.normal.x();
+                ny[fi]   = fc.normal.y();
+                nz[fi]   = fc.normal.z();
+                area[fi] = float(fc.area);
+            });
+    }
 
-    auto accessfn = [&mesh, &tr](size_t fi) {
-        Facestats fc{get_transformed_triangle(mesh, tr, fi)};
+    size_t size() const { return area.size(); }
+};
+
+// Vertex coordinates of a mesh, laid out as a structure of arrays.
+struct VertexCoords {
+    std::vector<float> x, y, z;
 
-        float score = fc.area
-                      * (std::abs(fc.normal.dot(Vec3f::UnitX()))
-                         + std::abs(fc.normal.dot(Vec3f::UnitY()))
-                         + std::abs(fc.normal.dot(Vec3f::UnitZ())));
+    explicit VertexCoords(const indexed_triangle_set &its)
+    {
+        x.reserve(its.vertices.size());
+        y.reserve(its.vertices.size());
+        z.reserve(its.vertices.size());
+        for (const Vec3f &v : its.vertices) {
+            x.emplace_back(v.x());
+            y.emplace_back(v.y());
+            z.emplace_back(v.z());
+        }
+    }
 
-        // We should score against the alignment with the reference planes
-        return scaled<int_fast64_t>(score);
+    size_t size() const { return z.size(); }
+};
+
+// Number of independent partial results kept by the scoring loops. Separate
+// accumulators let the compiler vectorize the loops without having to
+// reassociate the floating point operations.
+constexpr size_t SCORE_LANES = 8;
+
+// Partial float sums are flushed into a double after this many faces to keep
+// the rounding error bounded on huge meshes.
+constexpr size_t SCORE_BLOCK = 4096;
+
+// Score the alignment of the rotated faces with the reference planes. It is
+// evaluated serially, the candidate rotations are scored in parallel instead.
+double get_misalginment_score(const FaceNormals &fn, const Matrix3f &R)
+{
+    size_t facecount = fn.size();
+    if (facecount == 0) return NaNd;
+
+    const float *nx = fn.nx.data(), *ny = fn.ny.data(), *nz = fn.nz.data();
+    const float *area = fn.area.data();
+
+    const float r00 = R(0, 0), r01 = R(0, 1), r02 = R(0, 2);
+    const float r10 = R(1, 0), r11 = R(1, 1), r12 = R(1, 2);
+    const float r20 = R(2, 0), r21 = R(2, 1), r22 = R(2, 2);
+
+    auto facescore = [&](size_t fi) {
+        // The dot products of the rotated normal with the unit axes are
+        // just the components of the rotated normal.
+        return area[fi] * (std::abs(r00 * nx[fi] + r01 * ny[fi] + r02 * nz[fi]) +
+                           std::abs(r10 * nx[fi] + r11 * ny[fi] + r12 * nz[fi]) +
+                           std::abs(r20 * nx[fi] + r21 * ny[fi] + r22 * nz[fi]));
     };
 
-    size_t facecount = mesh.its.indices.size();
-    size_t Nthreads  = std::thread::hardware_concurrency();
-    double S = unscaled(sum_score<int_fast64_t>(accessfn, facecount, Nthreads));
+    double S = 0.;
+    for (size_t from = 0; from < facecount; from += SCORE_BLOCK) {
+        size_t to = std::min(from + SCORE_BLOCK, facecount);
+        std::array<float, SCORE_LANES> acc = {};
+
+        size_t fi = from;
+        for (; fi + SCORE_LANES <= to; fi += SCORE_LANES)
+            for (size_t l = 0; l < SCORE_LANES; ++l)
+                acc[l] += facescore(fi + l);
+
+        for (; fi < to; ++fi)
+            acc[0] += facescore(fi);
+
+        for (float a : acc)
+            S += a;
+    }
 
     return S / facecount;
 }
 
+// Height of the vertex set after rotation. Only the z row of the rotation
+// matrix is needed for it.
+float get_rotated_height(const VertexCoords &vc, const Matrix3f &R)
+{
+    size_t vcount = vc.size();
+    if (vcount == 0) return 0.f;
+
+    const float *x = vc.x.data(), *y = vc.y.data(), *z = vc.z.data();
+    const float r20 = R(2, 0), r21 = R(2, 1), r22 = R(2, 2);
+
+    std::array<float, SCORE_LANES> zmin, zmax;
+    zmin.fill(std::numeric_limits<float>::max());
+    zmax.fill(std::numeric_limits<float>::lowest());
+
+    size_t vi = 0;
+    for (; vi + SCORE_LANES <= vcount; vi += SCORE_LANES)
+        for (size_t l = 0; l < SCORE_LANES; ++l) {
+            float h = r20 * x[vi + l] + r21 * y[vi + l] + r22 * z[vi + l];
+            zmin[l] = std::min(zmin[l], h);
+            zmax[l] = std::max(zmax[l], h);
+        }
+
+    for (; vi < vcount; ++vi) {
+        float h = r20 * x[vi] + r21 * y[vi] + r22 * z[vi];
+        zmin[0] = std::min(zmin[0], h);
+        zmax[0] = std::max(zmax[0], h);
+    }
+
+    return *std::max_element(zmax.begin(), zmax.end()) -
+           *std::min_element(zmin.begin(), zmin.end());
+}
+
 // The score function for a particular face
 inline double get_supportedness_score(const Facestats &fc)
 {
@@ -291,6 +398,130 @@ std::array<double, N> find_min_score(Fn &&fn, It from, It to, StopCond &&stopfn)
     return ret;
 }
 
+// Score a batch of candidate rotations in parallel. Every score is computed
+// by a single thread, so the score function itself should be serial. The
+// candidates skipped after the stop condition is met are scored NaN.
+template<class Fn, class StopCond>
+std::vector<double> eval_rotations(Fn &&fn,
+                                   const std::vector<XYRotation> &rots,
+                                   StopCond &&stopfn)
+{
+    std::vector<double> scores(rots.size(), NaNd);
+
+    execution::for_each(
+        ex_tbb, size_t(0), rots.size(), [&stopfn, &scores, &fn, &rots](size_t i) {
+            if (stopfn()) return;
+
+            scores[i] = fn(rots[i]);
+        });
+
+    return scores;
+}
+
+// Scored rotation for the maximizing searches.
+struct RotScore { XYRotation rot; double score; };
+
+// Pick up to max_count best scoring rotations of a grid search, each being
+// at least min_dist apart from the others in both angles, to be used as the
+// starting points of a local search.
+std::vector<RotScore> select_starts(const std::vector<XYRotation> &rots,
+                                    const std::vector<double>     &scores,
+                                    size_t                         max_count,
+                                    double                         min_dist)
+{
+    std::vector<size_t> order;
+    order.reserve(rots.size());
+    for (size_t i = 0; i < rots.size(); ++i)
+        if (!std::isnan(scores[i]))
+            order.emplace_back(i);
+
+    // Stable, so that the first of the equally scored rotations is preferred
+    // like in the grid search.
+    std::stable_sort(order.begin(), order.end(), [&scores](size_t a, size_t b) {
+        return scores[a] > scores[b];
+    });
+
+    std::vector<RotScore> ret;
+    for (size_t i : order) {
+        if (ret.size() >= max_count)
+            break;
+
+        auto is_far = [&rots, i, min_dist](const RotScore &rs) {
+            return std::abs(rs.rot[X] - rots[i][X]) >= min_dist ||
+                   std::abs(rs.rot[Y] - rots[i][Y]) >= min_dist;
+        };
+
+        if (std::all_of(ret.begin(), ret.end(), is_far))
+            ret.push_back({rots[i], scores[i]});
+    }
+
+    return ret;
+}
+
+// Maximize the score function from multiple starting points concurrently,
+// with a compass search. In every round, the four axis neighbours of each
+// start still searching are scored in one parallel batch. A start moves to
+// its best neighbour if that improves its score, otherwise its step is
+// halved until it gets below min_step. Returns the best rotation found.
+template<class Fn, class StopCond>
+RotScore refine_multistart(Fn                  &&fn,
+                           std::vector<RotScore> starts,
+                           double                step,
+                           double                min_step,
+                           size_t                max_evals,
+                           StopCond            &&stopfn)
+{
+    if (starts.empty())
+        return {XYRotation{0., 0.}, NaNd};
+
+    std::vector<double> steps(starts.size(), step);
+    std::vector<XYRotation> batch;
+    std::vector<size_t> owners;
+
+    size_t evals = 0;
+    while (evals < max_evals && !stopfn()) {
+        batch.clear();
+        owners.clear();
+        for (size_t i = 0; i < starts.size(); ++i) {
+            if (steps[i] < min_step)
+                continue;
+
+            for (size_t d = 0; d < 4; ++d) {
+                XYRotation rot = starts[i].rot;
+                rot[d % 2] += d < 2 ? steps[i] : -steps[i];
+                batch.emplace_back(rot);
+                owners.emplace_back(i);
+            }
+        }
+
+        if (batch.empty())
+            break;
+
+        std::vector<double> scores = eval_rotations(fn, batch, stopfn);
+        evals += batch.size();
+
+        std::vector<RotScore> moved = starts;
+        for (size_t j = 0; j < batch.size(); ++j)
+            if (scores[j] > moved[owners[j]].score)
+                moved[owners[j]] = {batch[j], scores[j]};
+
+        for (size_t i = 0; i < starts.size(); ++i) {
+            if (steps[i] < min_step)
+                continue;
+
+            if (moved[i].score > starts[i].score)
+                starts[i] = moved[i];
+            else
+                steps[i] /= 2.;
+        }
+    }
+
+    return *std::max_element(starts.begin(), starts.end(),
+                             [](const RotScore &a, const RotScore &b) {
+                                 return a.score < b.score;
+                             });
+}
+
 } // namespace
 
 
@@ -298,11 +529,14 @@ std::array<double, N> find_min_score(Fn &&fn, It from, It to, StopCond &&stopfn)
 template<unsigned MAX_ITER>
 struct RotfinderBoilerplate {
     static constexpr unsigned MAX_TRIES = MAX_ITER;
+    using Clock = std::chrono::steady_clock;
 
-    int status = 0, prev_status = 0;
+    // The status is reported from the threads evaluating the rotations
+    std::atomic<int> status = 0, prev_status = 0;
     TriangleMesh mesh;
     unsigned max_tries;
     const RotOptimizeParams &params;
+    Clock::time_point deadline = Clock::time_point::max();
 
     // Assemble the mesh with the correct transformation to be used in rotation
     // optimization.
@@ -322,47 +556,68 @@ struct RotfinderBoilerplate {
         : mesh{get_mesh_to_rotate(mo)}
         , max_tries(p.accuracy() * MAX_TRIES)
         , params{p}
-    {}
+    {
+        if (p.time_budget() > 0.)
+            deadline = Clock::now() +
+                       std::chrono::duration_cast<Clock::duration>(
+                           std::chrono::duration<double>(p.time_budget()));
+    }
 
     void statusfn() {
-        int s = status * 100 / max_tries;
-        if (s != prev_status) {
+        int s = status.fetch_add(1) * 100 / std::max(max_tries, 1u);
+        if (s != prev_status.exchange(s))
             params.statuscb()(s);
-            prev_status = s;
-        }
-
-        ++status;
     }
 
-    bool stopcond() { return ! params.statuscb()(-1); }
+    bool stopcond() {
+        return ! params.statuscb()(-1) || Clock::now() > deadline;
+    }
 };
 
 Vec2d find_best_misalignment_rotation(const ModelObject &      mo,
                                       const RotOptimizeParams &params)
 {
+    // Number of the best grid rotations refined by the local search and
+    // the share of the evaluations spent on the refinement.
+    constexpr size_t REFINE_STARTS = 4;
+    constexpr unsigned REFINE_SHARE = 4;
+
     RotfinderBoilerplate<1000> bp{mo, params};
 
-    // Preparing the optimizer.
-    size_t gridsize = std::sqrt(bp.max_tries);
-    opt::Optimizer<opt::AlgBruteForce> solver(
-        opt::StopCriteria{}.max_iterations(bp.max_tries)
-                           .stop_condition([&bp] { return bp.stopcond(); }),
-        gridsize
-    );
-
-    // We are searching rotations around only two axes x, y. Thus the
-    // problem becomes a 2 dimensional optimization task.
-    // We can specify the bounds for a dimension in the following way:
-    auto bounds = opt::bounds({ {-PI, PI}, {-PI, PI} });
-
-    auto result = solver.to_max().optimize(
-        [&bp] (const XYRotation &rot)
-        {
-            bp.statusfn();
-            return get_misalginment_score(bp.mesh, to_transform3f(rot));
-        }, opt::initvals({0., 0.}), bounds);
+    FaceNormals normals{bp.mesh.its};
+
+    // We are searching rotations around only two axes x, y. The rotations
+    // of a 2D grid over [-PI, PI] x [-PI, PI] are scored first in parallel,
+    // then the best of them are refined concurrently with a local search.
+    size_t gridsize = std::max<size_t>(std::sqrt(bp.max_tries), 2);
+    double gridstep = 2. * PI / (gridsize - 1);
+
+    auto grid = reserve_vector<XYRotation>(gridsize * gridsize);
+    for (size_t iy = 0; iy < gridsize; ++iy)
+        for (size_t ix = 0; ix < gridsize; ++ix)
+            grid.push_back({-PI + ix * gridstep, -PI + iy * gridstep});
+
+    unsigned refine_evals = bp.max_tries / REFINE_SHARE;
+    bp.max_tries = grid.size() + refine_evals;
+
+    auto objfn = [&bp, &normals](const XYRotation &rot) {
+        bp.statusfn();
+        return get_misalginment_score(normals, to_transform3f(rot).linear());
+    };
+
+    auto stopfn = [&bp] { return bp.stopcond(); };
 
-    return {result.optimum[0], result.optimum[1]};
+    std::vector<double> scores = eval_rotations(objfn, grid, stopfn);
+    std::vector<RotScore> starts = select_starts(grid, scores, REFINE_STARTS,
+                                                 1.5 * gridstep);
+
+    RotScore best = refine_multistart(objfn, std::move(starts), gridstep / 2.,
+                                      gridstep / 64., refine_evals, stopfn);
+
+    if (std::isnan(best.score))
+        return {0., 0.};
+
+    return {best.rot[0], best.rot[1]};
 }
 
 Vec2d find_least_supports_rotation(const ModelObject &      mo,
@@ -425,23 +680,6 @@ Vec2d find_least_supports_rotation(const ModelObject &      mo,
     return {rot[0], rot[1]};
 }
 
-inline BoundingBoxf3 bounding_box_with_tr(const indexed_triangle_set &its,
-                                          const Transform3f &tr)
-{
-    if (its.vertices.empty())
-        return {};
-
-    Vec3f bmin = tr * its.vertices.front(), bmax = tr * its.vertices.front();
-
-    for (const Vec3f &p : its.vertices) {
-        Vec3f pp = tr * p;
-        bmin = pp.cwiseMin(bmin);
-        bmax = pp.cwiseMax(bmax);
-    }
-
-    return {bmin.cast<double>(), bmax.cast<double>()};
-}
-
 Vec2d find_min_z_height_rotation(const ModelObject &mo,
                                  const RotOptimizeParams &params)
 {
@@ -473,10 +711,11 @@ Vec2d find_min_z_height_rotation(const ModelObject &mo,
     inputs.shrink_to_fit();
     bp.max_tries = inputs.size();
 
-    auto objfn = [&bp, &chull](const XYRotation &rot) {
+    VertexCoords chull_coords{chull.its};
+
+    auto objfn = [&bp, &chull_coords](const XYRotation &rot) {
         bp.statusfn();
-        Transform3f tr = to_transform3f(rot);
-        return bounding_box_with_tr(chull.its, tr).size().z();
+        return get_rotated_height(chull_coords, to_transform3f(rot).linear());
     };
 
     XYRotation rot = find_min_score<2>(objfn, inputs.begin(), inputs.end(), [&bp] {
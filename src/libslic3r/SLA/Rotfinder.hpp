@@ -23,12 +23,16 @@ using RotOptimizeStatusCB = std::function<bool(int)>;
 
 class RotOptimizeParams {
     float m_accuracy = 1.;
+    double m_time_budget = 0.;
     const DynamicPrintConfig *m_print_config = nullptr;
     RotOptimizeStatusCB m_statuscb = [](int) { return true; };
 
 public:
 
     RotOptimizeParams &accuracy(float a) { m_accuracy = a; return *this; }
+    // Wall clock limit for the search in seconds, zero means no limit. When
+    // the budget runs out, the best rotation found so far is returned.
+    RotOptimizeParams &time_budget(double seconds) { m_time_budget = seconds; return *this; }
     RotOptimizeParams &print_config(const DynamicPrintConfig *c)
     {
         m_print_config = c;
@@ -41,6 +45,7 @@ public:
     }
 
     float accuracy() const { return m_accuracy; }
+    double time_budget() const { return m_time_budget; }
     const DynamicPrintConfig * print_config() const { return m_print_config; }
     const RotOptimizeStatusCB &statuscb() const { return m_statuscb; }
 };
@@ -50,8 +55,9 @@ public:
   *
   * @param modelobj The model object representing the 3d mesh.
   * @param accuracy The optimization accuracy from 0.0f to 1.0f. Currently,
-  * the nlopt genetic optimizer is used and the number of iterations is
-  * accuracy * 100000. This can change in the future.
+  * a grid of accuracy * 1000 rotations is evaluated and the best candidates
+  * are refined by a parallel multi-start local search. This can change in
+  * the future.
   * @param statuscb A status indicator callback called with the int
   * argument spanning from 0 to 100. May not reach 100 if the optimization finds
   * an optimum before max iterations are reached. It should return a boolean
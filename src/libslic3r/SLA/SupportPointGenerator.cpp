@@ -230,6 +230,67 @@ static std::vector<SupportPointGenerator::MyLayer> make_layers(
     return layers;
 }
 
+// Group the islands of a layer so that islands closer to each other than
+// 'dist' (in mm) end up in the same group. A group keeps the original order
+// of its islands, the groups are ordered by their first island.
+static std::vector<std::vector<size_t>> group_islands(
+    const std::vector<SupportPointGenerator::Structure> &islands, float dist)
+{
+    const coord_t d = scaled(dist);
+
+    std::vector<size_t> parent(islands.size());
+    std::iota(parent.begin(), parent.end(), size_t(0));
+    auto find_root = [&parent](size_t i) {
+        while (parent[i] != i)
+            i = parent[i] = parent[parent[i]];
+        return i;
+    };
+
+    std::vector<size_t> order(islands.size());
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::sort(order.begin(), order.end(), [&islands](size_t a, size_t b) {
+        return islands[a].bbox.min.x() < islands[b].bbox.min.x();
+    });
+
+    for (size_t a = 0; a < order.size(); ++a) {
+        const BoundingBox &bba = islands[order[a]].bbox;
+        for (size_t b = a + 1;
+             b < order.size() && islands[order[b]].bbox.min.x() <= bba.max.x() + d; ++b) {
+            const BoundingBox &bbb = islands[order[b]].bbox;
+            if (bbb.min.y() <= bba.max.y() + d && bba.min.y() <= bbb.max.y() + d) {
+                size_t ra = find_root(order[a]), rb = find_root(order[b]);
+                parent[std::max(ra, rb)] = std::min(ra, rb);
+            }
+        }
+    }
+
+    std::vector<std::vector<size_t>> groups;
+    std::vector<size_t> group_idx(islands.size(), islands.size());
+    for (size_t i = 0; i < islands.size(); ++i) {
+        size_t r = find_root(i);
+        if (group_idx[r] == islands.size()) {
+            group_idx[r] = groups.size();
+            groups.emplace_back();
+        }
+        groups[group_idx[r]].emplace_back(i);
+    }
+
+    return groups;
+}
+
+// Seed of the random generator of an island, given by the seed of the
+// generator and the position of the island.
+static uint32_t island_seed(uint32_t seed, size_t layer_id, size_t island_idx)
+{
+    uint64_t h = seed;
+    for (uint64_t v : {uint64_t(layer_id), uint64_t(island_idx)}) {
+        h = (h ^ v) * 0x9e3779b97f4a7c15ULL;
+        h ^= h >> 29;
+    }
+
+    return uint32_t(h ^ (h >> 32));
+}
+
 void SupportPointGenerator::process(const std::vector<ExPolygons>& slices, const std::vector<float>& heights)
 {
 #ifdef SLA_SUPPORTPOINTGEN_DEBUG
@@ -244,6 +305,9 @@ void SupportPointGenerator::process(const std::vector<ExPolygons>& slices, const
     double increment = 100.0 / layers.size();
     double status    = 0;
 
+    // Seed of the random generators of the individual islands.
+    const std::mt19937::result_type seed = m_rng();
+
     for (unsigned int layer_id = 0; layer_id < layers.size(); ++ layer_id) {
         SupportPointGenerator::MyLayer *layer_top     = &layers[layer_id];
         SupportPointGenerator::MyLayer *layer_bottom  = (layer_id > 0) ? &layers[layer_id - 1] : nullptr;
@@ -278,12 +342,28 @@ void SupportPointGenerator::process(const std::vector<ExPolygons>& slices, const
             }
         }
         // Now iterate over all polygons and append new points if needed.
-        for (Structure &s : layer_top->islands) {
-            // Penalization resulting from large diff from the last layer:
-            s.supports_force_inherited /= std::max(1.f, 0.17f * (s.overhangs_area) / s.area);
+        // Groups of islands too far from each other to share any points are
+        // covered in parallel, the islands of one group in order. Each
+        // island gets its own random generator seeded by its position.
+        std::vector<std::vector<size_t>> groups = group_islands(layer_top->islands, poisson_radius());
+        std::vector<std::vector<SupportPoint>> island_points(layer_top->islands.size());
+
+        execution::for_each(ex_tbb, size_t(0), groups.size(),
+                            [this, layer_top, layer_id, seed, &groups, &island_points,
+                             &point_grid](size_t group_idx) {
+            for (size_t island_idx : groups[group_idx]) {
+                Structure &s = layer_top->islands[island_idx];
+
+                // Penalization resulting from large diff from the last layer:
+                s.supports_force_inherited /= std::max(1.f, 0.17f * (s.overhangs_area) / s.area);
+
+                IslandRandom rng{island_seed(seed, layer_id, island_idx)};
+                add_support_points(s, point_grid, rng, island_points[island_idx]);
+            }
+        });
 
-            add_support_points(s, point_grid);
-        }
+        for (std::vector<SupportPoint> &pts : island_points)
+            append(m_output, std::move(pts));
 
         m_throw_on_cancel();
 
@@ -292,7 +372,10 @@ void SupportPointGenerator::process(const std::vector<ExPolygons>& slices, const
     }
 }
 
-void SupportPointGenerator::add_support_points(SupportPointGenerator::Structure &s, SupportPointGenerator::PointGrid3D &grid3d)
+void SupportPointGenerator::add_support_points(SupportPointGenerator::Structure &s,
+                                               SupportPointGenerator::PointGrid3D &grid3d,
+                                               IslandRandom &rng,
+                                               std::vector<SupportPoint> &out) const
 {
     // Select each type of surface (overrhang, dangling, slope), derive the support
     // force deficit for it and call uniformly conver with the right params
@@ -303,12 +386,12 @@ void SupportPointGenerator::add_support_points(SupportPointGenerator::Structure
     if (s.islands_below.empty()) {
         // completely new island - needs support no doubt
         // deficit is full, there is nothing below that would hold this island
-        uniformly_cover({ *s.polygon }, s, s.area * tp, grid3d, IslandCoverageFlags(icfIsNew | icfWithBoundary) );
+        uniformly_cover({ *s.polygon }, s, s.area * tp, grid3d, rng, out, IslandCoverageFlags(icfIsNew | icfWithBoundary) );
         return;
     }
 
     if (! s.overhangs.empty()) {
-        uniformly_cover(s.overhangs, s, s.overhangs_area * tp, grid3d);
+        uniformly_cover(s.overhangs, s, s.overhangs_area * tp, grid3d, rng, out);
     }
 
     auto areafn = [](double sum, auto &p) { return sum + p.area() * SCALING_FACTOR * SCALING_FACTOR; };
@@ -319,13 +402,13 @@ void SupportPointGenerator::add_support_points(SupportPointGenerator::Structure
         // What we now have in polygons needs support, regardless of what the forces are, so we can add them.
 
         double a = std::accumulate(s.dangling_areas.begin(), s.dangling_areas.end(), 0., areafn);
-        uniformly_cover(s.dangling_areas, s, a * tp - a * current * s.area, grid3d, icfWithBoundary);
+        uniformly_cover(s.dangling_areas, s, a * tp - a * current * s.area, grid3d, rng, out, icfWithBoundary);
     }
 
     current = s.supports_force_total();
     if (! s.overhangs_slopes.empty()) {
         double a = std::accumulate(s.overhangs_slopes.begin(), s.overhangs_slopes.end(), 0., areafn);
-        uniformly_cover(s.overhangs_slopes, s, a * tp - a * current / s.area, grid3d, icfWithBoundary);
+        uniformly_cover(s.overhangs_slopes, s, a * tp - a * current / s.area, grid3d, rng, out, icfWithBoundary);
     }
 }
 
@@ -540,7 +623,15 @@ static inline std::vector<Vec2f> poisson_disk_from_samples(const std::vector<Vec
 }
 
 
-void SupportPointGenerator::uniformly_cover(const ExPolygons& islands, Structure& structure, float deficit, PointGrid3D &grid3d, IslandCoverageFlags flags)
+float SupportPointGenerator::poisson_radius() const
+{
+    const float density_horizontal = m_config.tear_pressure() / m_config.support_force();
+    //FIXME why?
+    return std::max(m_config.minimal_distance, 1.f / (5.f * density_horizontal));
+}
+
+void SupportPointGenerator::uniformly_cover(const ExPolygons& islands, Structure& structure, float deficit, PointGrid3D &grid3d,
+                                            IslandRandom &rng, std::vector<SupportPoint> &out, IslandCoverageFlags flags) const
 {
     //int num_of_points = std::max(1, (int)((island.area()*pow(SCALING_FACTOR, 2) * m_config.tear_pressure)/m_config.support_force));
 
@@ -564,22 +655,18 @@ void SupportPointGenerator::uniformly_cover(const ExPolygons& islands, Structure
     // Number of newly added points.
     const size_t poisson_samples_target = size_t(ceil(support_force_deficit / m_config.support_force()));
 
-    const float density_horizontal = m_config.tear_pressure() / m_config.support_force();
-    //FIXME why?
-    float poisson_radius		= std::max(m_config.minimal_distance, 1.f / (5.f * density_horizontal));
+    float poisson_radius		= this->poisson_radius();
 //    const float poisson_radius     = 1.f / (15.f * density_horizontal);
     const float samples_per_mm2 = 30.f / (float(M_PI) * poisson_radius * poisson_radius);
     // Minimum distance between samples, in 3D space.
 //    float min_spacing			= poisson_radius / 3.f;
     float min_spacing			= poisson_radius;
 
-    //FIXME share the random generator. The random generator may be not so cheap to initialize, also we don't want the random generator to be restarted for each polygon.
-
     std::vector<Vec2f> raw_samples =
         flags & icfWithBoundary ?
             sample_expolygon_with_boundary(islands, samples_per_mm2,
-                                           5.f / poisson_radius, m_rng) :
-            sample_expolygon(islands, samples_per_mm2, m_rng);
+                                           5.f / poisson_radius, rng.get()) :
+            sample_expolygon(islands, samples_per_mm2, rng.get());
 
     std::vector<Vec2f>  poisson_samples;
     for (size_t iter = 0; iter < 4; ++ iter) {
@@ -611,11 +698,11 @@ void SupportPointGenerator::uniformly_cover(const ExPolygons& islands, Structure
 
 //    assert(! poisson_samples.empty());
     if (poisson_samples_target < poisson_samples.size()) {
-        std::shuffle(poisson_samples.begin(), poisson_samples.end(), m_rng);
+        std::shuffle(poisson_samples.begin(), poisson_samples.end(), rng.get());
         poisson_samples.erase(poisson_samples.begin() + poisson_samples_target, poisson_samples.end());
     }
     for (const Vec2f &pt : poisson_samples) {
-        m_output.emplace_back(float(pt(0)), float(pt(1)), structure.zlevel, m_config.head_diameter/2.f, flags & icfIsNew);
+        out.emplace_back(float(pt(0)), float(pt(1)), structure.zlevel, m_config.head_diameter/2.f, flags & icfIsNew);
         structure.supports_force_this_layer += m_config.support_force();
         grid3d.insert(pt, &structure);
     }
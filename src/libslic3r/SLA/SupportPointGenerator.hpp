@@ -11,11 +11,13 @@
 #include <libslic3r/ClipperUtils.hpp>
 #include <libslic3r/Point.hpp>
 #include <boost/container/small_vector.hpp>
+#include <tbb/concurrent_unordered_map.h>
 #include <stdint.h>
 #include <random>
 #include <cmath>
 #include <cstddef>
 #include <functional>
+#include <optional>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -153,13 +155,15 @@ public:
         Structure   *island;
     };
     
+    // Points can be inserted and looked up concurrently, the islands of a
+    // layer are covered in parallel.
     struct PointGrid3D {
         struct GridHash {
             std::size_t operator()(const Vec3i &cell_id) const {
                 return std::hash<int>()(cell_id.x()) ^ std::hash<int>()(cell_id.y() * 593) ^ std::hash<int>()(cell_id.z() * 7919);
             }
         };
-        typedef std::unordered_multimap<Vec3i, RichSupportPoint, GridHash> Grid;
+        typedef tbb::concurrent_unordered_multimap<Vec3i, RichSupportPoint, GridHash> Grid;
         
         Vec3f   cell_size;
         Grid    grid;
@@ -222,9 +226,35 @@ public:
 
 private:
 
-    void uniformly_cover(const ExPolygons& islands, Structure& structure, float deficit, PointGrid3D &grid3d, IslandCoverageFlags flags = icfNone);
+    // Random generator of one island, seeded deterministically. Most of the
+    // islands need no new points, so the generator is created on first use.
+    class IslandRandom {
+        uint32_t m_seed;
+        std::optional<std::mt19937> m_rng;
 
-    void add_support_points(Structure& structure, PointGrid3D &grid3d);
+    public:
+        explicit IslandRandom(uint32_t seed) : m_seed(seed) {}
+
+        std::mt19937 &get()
+        {
+            if (!m_rng)
+                m_rng.emplace(m_seed);
+
+            return *m_rng;
+        }
+    };
+
+    // The new points of an island are written into 'out', the random
+    // generator is the island's own, so the islands can be covered in
+    // parallel with deterministic results.
+    void uniformly_cover(const ExPolygons& islands, Structure& structure, float deficit, PointGrid3D &grid3d,
+                         IslandRandom &rng, std::vector<SupportPoint> &out, IslandCoverageFlags flags = icfNone) const;
+
+    void add_support_points(Structure& structure, PointGrid3D &grid3d, IslandRandom &rng, std::vector<SupportPoint> &out) const;
+
+    // Initial minimal distance of the points covering an island. Points
+    // further apart do not influence each other.
+    float poisson_radius() const;
 
     void project_onto_mesh(std::vector<SupportPoint>& points) const;
 
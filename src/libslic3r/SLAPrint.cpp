@@ -16,6 +16,7 @@
 #include "Thread.hpp"
 
 #include <unordered_set>
+#include <atomic>
 #include <numeric>
 
 #include <tbb/parallel_for.h>
@@ -694,9 +695,23 @@ std::string SLAPrint::validate(std::vector<std::string>*) const
 
 void SLAPrint::export_print(const std::string &fname, const ThumbnailsList &thumbnails, const std::string &projectname)
 {
-    if (m_archiver)
-        m_archiver->export_print(fname, *this, thumbnails, projectname);
-    else {
+    if (m_archiver) {
+        // The layers are rasterized from m_printer_input while exporting, see SLAPrint::Steps::rasterize().
+        // m_printer_input is only valid and not being modified once the print is finished.
+        if (! this->finished())
+            throw ExportError(_u8L("The print has to be sliced before it can be exported."));
+
+        SLAArchiveWriter::ExportCallbacks callbacks;
+        callbacks.cancelfn   = [this]() { return this->canceled(); };
+        int last_percent     = -1;
+        callbacks.progressfn = [this, &last_percent](size_t layers_written, size_t layer_count) {
+            if (int percent = int(100 * layers_written / std::max(layer_count, size_t(1))); percent != last_percent) {
+                last_percent = percent;
+                this->set_status(percent, _u8L("Rasterizing layers"));
+            }
+        };
+        m_archiver->export_print(fname, *this, thumbnails, projectname, callbacks);
+    } else {
         throw ExportError(format(_u8L("Unknown archive format: %s"), m_printer_config.sla_archive_format.value));
     }
 }
@@ -1153,6 +1168,12 @@ const std::vector<sla::SupportPoint> EMPTY_SUPPORT_POINTS;
 
 const SliceRecord SliceRecord::EMPTY(0, std::nanf(""), 0.f);
 
+void SliceRecord::touch()
+{
+    static std::atomic<size_t> last_stamp{0};
+    m_stamp = ++last_stamp;
+}
+
 const std::vector<sla::SupportPoint>& SLAPrintObject::get_support_points() const
 {
     return m_supportdata? m_supportdata->input.pts : EMPTY_SUPPORT_POINTS;
@@ -20,6 +20,7 @@
 #include <limits>
 #include <memory>
 #include <string>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -192,6 +193,9 @@ public:
         size_t m_support_slices_idx = NONE;
         const SLAPrintObject *m_po = nullptr;
 
+        // Changes whenever the slices referenced by this record change.
+        size_t m_stamp = 0;
+
     public:
 
         SliceRecord(coord_t key, float slicez, float height):
@@ -224,6 +228,11 @@ public:
         {
             return o == soModel ? m_model_slices_idx : m_support_slices_idx;
         }
+
+        // Unique among all the records of all the print objects, a merged
+        // print layer is valid as long as the stamps of its records are.
+        size_t stamp() const { return m_stamp; }
+        void   touch();
     };
 
 private:
@@ -339,7 +348,14 @@ protected:
         m_left_handed = left_handed;
     }
 
-    template<class InstVec> inline void set_instances(InstVec&& instances) { m_instances = std::forward<InstVec>(instances); }
+    template<class InstVec> inline void set_instances(InstVec&& instances)
+    {
+        m_instances = std::forward<InstVec>(instances);
+        ++m_instances_stamp;
+    }
+
+    // Changes whenever the instances of this object change.
+    size_t                  instances_stamp() const { return m_instances_stamp; }
 
     // Invalidates the step, and its depending steps in SLAPrintObject and SLAPrint.
     bool                    invalidate_step(SLAPrintObjectStep step);
@@ -357,6 +373,7 @@ private:
     bool                                    m_left_handed = false;
 
     std::vector<Instance> 					m_instances;
+    size_t                                  m_instances_stamp = 0;
 
     // Individual 2d slice polygons from lower z to higher z levels
     std::vector<ExPolygons>                 m_model_slices;
@@ -372,6 +389,27 @@ private:
         sla::SupportableMesh    input; // the input
         std::vector<ExPolygons> support_slices;   // sliced supports
         TriangleMesh tree_mesh, pad_mesh, full_mesh; // cached artifacts
+
+        // Footprint of a triangle of the tree or pad mesh for finding the
+        // layers to slice again if the support geometry changes.
+        struct SlicedTriangle
+        {
+            uint64_t hash;
+            float    zmin, zmax;
+
+            bool operator<(const SlicedTriangle &other) const
+            {
+                return std::tie(hash, zmin, zmax) <
+                       std::tie(other.hash, other.zmin, other.zmax);
+            }
+        };
+
+        // The input of the last slicing of the supports. Valid only if
+        // 'sliced' is true and then 'support_slices' is its result.
+        std::vector<SlicedTriangle> sliced_triangles;
+        std::vector<float>          sliced_heights;
+        std::vector<double>         sliced_params;
+        bool                        sliced = false;
         
         inline SupportData(const TriangleMesh &t)
             : input{t.its, {}, {}}
@@ -420,6 +458,22 @@ private:
     };
     
     std::unique_ptr<HollowingData> m_hollowing_data;
+
+    // The distance grid of the assembled mesh the interior was generated
+    // from. Survives the hollowing step, so that changing the wall thickness
+    // or the closing distance does not need to voxelize the mesh again.
+    // The grids of the csg parts survive the mesh assembly too, only the
+    // changed parts are voxelized again when a volume is modified.
+    struct HollowingGrid
+    {
+        VoxelGridPtr        grid;
+        double              voxel_scale = 0.;
+        csg::VoxelGridCache parts;
+    } m_hollowing_grid;
+
+    // Voxel grids of the csg parts for the approximated preview meshes, so
+    // that adding or moving a drain hole voxelizes only that hole.
+    csg::VoxelGridCache m_preview_grid_cache;
 };
 
 using PrintObjects = std::vector<SLAPrintObject*>;
@@ -542,6 +596,12 @@ public:
 
         ExPolygons m_transformed_slices;
 
+        // Stamps of the slice records and of the instances of their objects
+        // the transformed slices and the areas were merged from. Empty if the
+        // layer was not merged yet.
+        std::vector<std::pair<size_t, size_t>> m_merged_stamps;
+        double m_model_area = 0., m_support_area = 0.;
+
         template<class Container> void transformed_slices(Container&& c)
         {
             m_transformed_slices = std::forward<Container>(c);
@@ -22,6 +22,7 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstring>
 #include <functional>
 #include <iterator>
 #include <limits>
@@ -116,7 +117,8 @@ SLAPrint::Steps::Steps(SLAPrint *print)
     , objectstep_scale{(max_objstatus - min_objstatus) / (objcount * 100.0)}
 {}
 
-void SLAPrint::Steps::apply_printer_corrections(SLAPrintObject &po, SliceOrigin o)
+void SLAPrint::Steps::apply_printer_corrections(SLAPrintObject &po, SliceOrigin o,
+                                                const std::vector<bool> &layers)
 {
     if (o == soSupport && !po.m_supportdata) return;
 
@@ -138,15 +140,17 @@ void SLAPrint::Steps::apply_printer_corrections(SLAPrintObject &po, SliceOrigin
                                           po.m_model_slices :
                                           po.m_supportdata->support_slices;
 
+    auto is_corrected = [&layers](size_t i) { return layers.empty() || layers[i]; };
+
     if (clpr_offs != 0) for (size_t i = 0; i < po.m_slice_index.size(); ++i) {
         size_t idx = po.m_slice_index[i].get_slice_idx(o);
-        if (idx < slices.size())
+        if (idx < slices.size() && is_corrected(i))
             slices[idx] = offset_ex(slices[idx], float(clpr_offs));
     }
 
     if (start_efc > 0.) for (size_t i = 0; i < faded_lyrs; ++i) {
         size_t idx = po.m_slice_index[i].get_slice_idx(o);
-        if (idx < slices.size())
+        if (idx < slices.size() && is_corrected(i))
             slices[idx] = elephant_foot_compensation(slices[idx], min_w, efc(i));
     }
 
@@ -176,7 +180,7 @@ indexed_triangle_set SLAPrint::Steps::generate_preview_vdb(
     });
 
     auto r = range(po.m_mesh_to_slice);
-    auto grid = csg::voxelize_csgmesh(r, voxparams);
+    auto grid = csg::voxelize_csgmesh(r, voxparams, po.m_preview_grid_cache);
     auto m = grid ? grid_to_mesh(*grid, 0., 0.01) : indexed_triangle_set{};
     float loss_less_max_error = float(1e-6);
     its_quadric_edge_collapse(m, 0U, &loss_less_max_error);
@@ -343,6 +347,7 @@ void SLAPrint::Steps::mesh_assembly(SLAPrintObject &po)
     po.m_mesh_to_slice.clear();
     po.m_supportdata.reset();
     po.m_hollowing_data.reset();
+    po.m_hollowing_grid.grid.reset();
 
     csg::model_to_csgmesh(*po.model_object(), po.trafo(),
                           csg_inserter{po.m_mesh_to_slice, slaposAssembly},
@@ -360,6 +365,7 @@ void SLAPrint::Steps::hollow_model(SLAPrintObject &po)
 
     if (! po.m_config.hollowing_enable.getBool()) {
         BOOST_LOG_TRIVIAL(info) << "Skipping hollowing step!";
+        po.m_hollowing_grid = {};
         return;
     }
 
@@ -373,8 +379,22 @@ void SLAPrint::Steps::hollow_model(SLAPrintObject &po)
     ctl.stopcondition = [this]() { return canceled(); };
     ctl.cancelfn = [this]() { throw_if_canceled(); };
 
+    // The voxel scale depends only on the mesh and the hollowing quality,
+    // the cached grid is valid until the mesh is assembled again.
+    double voxel_scale = sla::get_voxel_scale(
+        sla::csgmesh_positive_maxvolume(po.mesh_to_slice()), hlwcfg);
+
+    auto &hlwgrid = po.m_hollowing_grid;
+    if (!hlwgrid.grid || hlwgrid.voxel_scale != voxel_scale) {
+        hlwgrid.grid = sla::generate_interior_grid(po.mesh_to_slice(),
+                                                   voxel_scale, ctl,
+                                                   &hlwgrid.parts);
+        hlwgrid.voxel_scale = voxel_scale;
+    }
+
     sla::InteriorPtr interior =
-        generate_interior(po.mesh_to_slice(), hlwcfg, ctl);
+        hlwgrid.grid ? sla::generate_interior(*hlwgrid.grid, hlwcfg, ctl) :
+                       sla::InteriorPtr{};
 
     if (!interior || sla::get_mesh(*interior).empty())
         BOOST_LOG_TRIVIAL(warning) << "Hollowed interior is empty!";
@@ -542,6 +562,9 @@ void SLAPrint::Steps::slice_model(SLAPrintObject &po)
     // We apply the printer correction offset here.
     apply_printer_corrections(po, soModel);
 
+    for (SliceRecord &rec : po.m_slice_index)
+        rec.touch();
+
 //    po.m_preview_meshes[slaposObjectSlice] = po.get_mesh_to_print();
 //    report_status(-2, "", SlicingStatus::RELOAD_SLA_PREVIEW);
 }
@@ -799,36 +822,183 @@ void SLAPrint::Steps::generate_pad(SLAPrintObject &po) {
     report_status(-1, _u8L("Visualizing supports"), SlicingStatus::RELOAD_SCENE);
 }
 
+std::vector<SLAPrintObject::SupportData::SlicedTriangle>
+SLAPrint::Steps::sliced_triangles(const indexed_triangle_set &tree,
+                                  const indexed_triangle_set &pad)
+{
+    using SlicedTriangle = SLAPrintObject::SupportData::SlicedTriangle;
+
+    auto mix = [](uint64_t h) {
+        h ^= h >> 33; h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33; h *= 0xc4ceb9fe1a85ec53ULL;
+        return h ^ (h >> 33);
+    };
+
+    auto ret = reserve_vector<SlicedTriangle>(tree.indices.size() + pad.indices.size());
+
+    auto add_triangles = [&ret, &mix](const indexed_triangle_set &its, uint64_t seed) {
+        for (const stl_triangle_vertex_indices &face : its.indices) {
+            SlicedTriangle t{seed, std::numeric_limits<float>::max(),
+                             std::numeric_limits<float>::lowest()};
+
+            for (int v = 0; v < 3; ++v) {
+                const Vec3f &p = its.vertices[face(v)];
+                for (int c = 0; c < 3; ++c) {
+                    uint32_t bits;
+                    std::memcpy(&bits, &p(c), sizeof(bits));
+                    t.hash = mix(t.hash ^ bits);
+                }
+                t.zmin = std::min(t.zmin, p.z());
+                t.zmax = std::max(t.zmax, p.z());
+            }
+
+            ret.emplace_back(t);
+        }
+    };
+
+    add_triangles(tree, 1);
+    add_triangles(pad, 2);
+    std::sort(ret.begin(), ret.end());
+
+    return ret;
+}
+
 // Slicing the support geometries similarly to the model slicing procedure.
 // If the pad had been added previously (see step "base_pool" than it will
-// be part of the slices)
+// be part of the slices). If the supports were sliced before on the same
+// grid and with the same parameters, only the layers crossed by the changed
+// triangles of the support tree and the pad are sliced again.
 void SLAPrint::Steps::slice_supports(SLAPrintObject &po) {
     auto& sd = po.m_supportdata;
 
-    if(sd) sd->support_slices.clear();
-
     // Don't bother if no supports and no pad is present.
-    if (!po.m_config.supports_enable.getBool() && !po.m_config.pad_enable.getBool())
+    if (!po.m_config.supports_enable.getBool() && !po.m_config.pad_enable.getBool()) {
+        if (sd) {
+            sd->support_slices.clear();
+            sd->sliced = false;
+        }
+
+        for (SliceRecord &rec : po.m_slice_index)
+            rec.touch();
+
         return;
+    }
+
+    // The layers of the slice index with changed support slices
+    std::vector<bool> changed(po.m_slice_index.size(), true);
+    bool incremental = false;
 
     if(sd) {
         auto heights = reserve_vector<float>(po.m_slice_index.size());
 
         for(auto& rec : po.m_slice_index) heights.emplace_back(rec.slice_level());
 
+        float closing_radius = float(po.config().slice_closing_radius.value);
+
+        // Everything the support slices depend on apart from the meshes,
+        // including the printer corrections applied on them.
+        std::vector<double> params = {
+            po.config().slice_closing_radius.value,
+            double(po.m_config.faded_layers.getInt()),
+            m_print->m_printer_config.elefant_foot_min_width.getFloat(),
+            m_print->m_printer_config.elefant_foot_compensation.getFloat(),
+            m_print->m_printer_config.absolute_correction.getFloat()};
+
+        auto triangles = sliced_triangles(sd->tree_mesh.its, sd->pad_mesh.its);
+
         sla::JobController ctl;
         ctl.stopcondition = [this]() { return canceled(); };
         ctl.cancelfn = [this]() { throw_if_canceled(); };
 
-        sd->support_slices =
-            sla::slice(sd->tree_mesh.its, sd->pad_mesh.its, heights,
-                       float(po.config().slice_closing_radius.value), ctl);
+        incremental = sd->sliced && sd->sliced_heights == heights &&
+                      sd->sliced_params == params;
+
+        // The slices are not consistent with the cached input until the
+        // slicing is finished.
+        sd->sliced = false;
+
+        if (incremental) {
+            using SlicedTriangle = SLAPrintObject::SupportData::SlicedTriangle;
+
+            std::vector<SlicedTriangle> diff;
+            std::set_symmetric_difference(sd->sliced_triangles.begin(),
+                                          sd->sliced_triangles.end(),
+                                          triangles.begin(), triangles.end(),
+                                          std::back_inserter(diff));
+
+            std::sort(diff.begin(), diff.end(),
+                      [](const SlicedTriangle &a, const SlicedTriangle &b) {
+                          return a.zmin < b.zmin;
+                      });
+
+            // Mark the layers within the merged Z ranges of the triangles
+            // that were added or removed.
+            std::fill(changed.begin(), changed.end(), false);
+            for (size_t i = 0; i < diff.size();) {
+                float zmin = diff[i].zmin, zmax = diff[i].zmax;
+                for (++i; i < diff.size() && diff[i].zmin <= zmax; ++i)
+                    zmax = std::max(zmax, diff[i].zmax);
+
+                auto from = std::lower_bound(heights.begin(), heights.end(), zmin);
+                auto to   = std::upper_bound(from, heights.end(), zmax);
+                std::fill(changed.begin() + (from - heights.begin()),
+                          changed.begin() + (to - heights.begin()), true);
+            }
+
+            // The slicing yields as many layers as the grid has, or only
+            // those up to the top of the pad if there is no support tree.
+            size_t count = heights.size();
+            if (sd->tree_mesh.its.empty())
+                count = sd->pad_mesh.its.empty() ?
+                            0 :
+                            size_t(std::upper_bound(heights.begin(), heights.end(),
+                                                    bounding_box(sd->pad_mesh.its).max.z()) -
+                                   heights.begin());
+
+            auto &slices = sd->support_slices;
+            for (size_t i = std::min(count, slices.size());
+                 i < std::max(count, slices.size()) && i < changed.size(); ++i)
+                changed[i] = true;
+
+            std::vector<float>  grid;
+            std::vector<size_t> grid_idx;
+            for (size_t i = 0; i < count; ++i)
+                if (changed[i]) {
+                    grid.emplace_back(heights[i]);
+                    grid_idx.emplace_back(i);
+                }
+
+            std::vector<ExPolygons> reslices;
+            if (!grid.empty())
+                reslices = sla::slice(sd->tree_mesh.its, sd->pad_mesh.its, grid,
+                                      closing_radius, ctl);
+
+            slices.resize(count);
+            for (size_t i = 0; i < grid_idx.size(); ++i)
+                slices[grid_idx[i]] = i < reslices.size() ? std::move(reslices[i]) :
+                                                            ExPolygons{};
+        } else {
+            sd->support_slices =
+                sla::slice(sd->tree_mesh.its, sd->pad_mesh.its, heights,
+                           closing_radius, ctl);
+        }
+
+        sd->sliced_triangles = std::move(triangles);
+        sd->sliced_heights   = std::move(heights);
+        sd->sliced_params    = std::move(params);
     }
 
     for (size_t i = 0; i < sd->support_slices.size() && i < po.m_slice_index.size(); ++i)
         po.m_slice_index[i].set_support_slice_idx(po, i);
 
-    apply_printer_corrections(po, soSupport);
+    apply_printer_corrections(po, soSupport, incremental ? changed : std::vector<bool>{});
+
+    for (size_t i = 0; i < po.m_slice_index.size(); ++i)
+        if (changed[i])
+            po.m_slice_index[i].touch();
+
+    if (sd)
+        sd->sliced = true;
 
     // Using RELOAD_SLA_PREVIEW to tell the Plater to pass the update
     // status to the 3D preview to load the SLA slices.
@@ -1122,9 +1292,15 @@ static int layer_peel_move_time(int layer_height_nm, ExposureProfile p)
 }
 
 // Merging the slices from all the print objects into one slice grid and
-// calculating print statistics from the merge result.
+// calculating print statistics from the merge result. The merged slices of
+// the layers whose slice records and instances did not change since the
+// previous merge are reused, only the statistics are calculated again.
 void SLAPrint::Steps::merge_slices_and_eval_stats() {
 
+    // The slice records referenced by the previous layers may not exist
+    // anymore, only the stamps of the previous merge are compared.
+    std::vector<PrintLayer> prev_input = std::move(m_print->m_printer_input);
+
     initialize_printer_input();
 
     auto &print_statistics = m_print->m_print_statistics;
@@ -1134,6 +1310,32 @@ void SLAPrint::Steps::merge_slices_and_eval_stats() {
 
     print_statistics.clear();
 
+    // Stamps identifying the input of the merged slices of a print layer
+    auto merged_stamps = [](const PrintLayer &layer) {
+        auto ret = reserve_vector<std::pair<size_t, size_t>>(layer.slices().size());
+        for (const SliceRecord &sr : layer.slices())
+            ret.emplace_back(sr.stamp(), sr.print_obj()->instances_stamp());
+
+        return ret;
+    };
+
+    std::vector<bool> reused(printer_input.size(), false);
+    for (size_t i = 0; i < printer_input.size(); ++i) {
+        PrintLayer &layer = printer_input[i];
+        auto it = std::lower_bound(prev_input.begin(), prev_input.end(), layer);
+        if (it == prev_input.end() || it->level() != layer.level() ||
+            it->m_merged_stamps.empty() || it->m_merged_stamps != merged_stamps(layer))
+            continue;
+
+        layer.m_transformed_slices = std::move(it->m_transformed_slices);
+        layer.m_merged_stamps      = std::move(it->m_merged_stamps);
+        layer.m_model_area         = it->m_model_area;
+        layer.m_support_area       = it->m_support_area;
+        reused[i] = true;
+    }
+
+    prev_input.clear();
+
     const double area_fill = material_config.area_fill.getFloat()*0.01;// 0.5 (50%);
     const double fast_tilt = printer_config.fast_tilt_time.getFloat();// 5.0;
     const double slow_tilt = printer_config.slow_tilt_time.getFloat();// 8.0;
@@ -1163,7 +1365,7 @@ void SLAPrint::Steps::merge_slices_and_eval_stats() {
     // Going to parallel:
     auto printlayerfn = [this,
             // functions and read only vars
-            area_fill, display_area, exp_time, init_exp_time, fast_tilt, slow_tilt, hv_tilt, material_config, delta_fade_time, is_prusa_print, first_slow_layers, below, above,
+            area_fill, display_area, exp_time, init_exp_time, fast_tilt, slow_tilt, hv_tilt, material_config, delta_fade_time, is_prusa_print, first_slow_layers, below, above, &reused, &merged_stamps,
 
             // write vars
             &layers_info](size_t sliced_layer_cnt)
@@ -1180,65 +1382,70 @@ void SLAPrint::Steps::merge_slices_and_eval_stats() {
 
         // Calculation of the consumed material
 
-        ExPolygons model_polygons;
-        ExPolygons supports_polygons;
+        if (!reused[sliced_layer_cnt]) {
+            ExPolygons model_polygons;
+            ExPolygons supports_polygons;
 
-        size_t c = std::accumulate(layer.slices().begin(),
-                                   layer.slices().end(),
-                                   size_t(0),
-                                   [](size_t a, const SliceRecord &sr) {
-            return a + sr.get_slice(soModel).size();
-        });
+            size_t c = std::accumulate(layer.slices().begin(),
+                                       layer.slices().end(),
+                                       size_t(0),
+                                       [](size_t a, const SliceRecord &sr) {
+                return a + sr.get_slice(soModel).size();
+            });
 
-        model_polygons.reserve(c);
+            model_polygons.reserve(c);
 
-        c = std::accumulate(layer.slices().begin(),
-                            layer.slices().end(),
-                            size_t(0),
-                            [](size_t a, const SliceRecord &sr) {
-            return a + sr.get_slice(soSupport).size();
-        });
+            c = std::accumulate(layer.slices().begin(),
+                                layer.slices().end(),
+                                size_t(0),
+                                [](size_t a, const SliceRecord &sr) {
+                return a + sr.get_slice(soSupport).size();
+            });
 
-        supports_polygons.reserve(c);
+            supports_polygons.reserve(c);
 
-        for(const SliceRecord& record : layer.slices()) {
+            for(const SliceRecord& record : layer.slices()) {
 
-            ExPolygons modelslices = get_all_polygons(record, soModel);
-            for(ExPolygon& p_tmp : modelslices) model_polygons.emplace_back(std::move(p_tmp));
+                ExPolygons modelslices = get_all_polygons(record, soModel);
+                for(ExPolygon& p_tmp : modelslices) model_polygons.emplace_back(std::move(p_tmp));
 
-            ExPolygons supportslices = get_all_polygons(record, soSupport);
-            for(ExPolygon& p_tmp : supportslices) supports_polygons.emplace_back(std::move(p_tmp));
+                ExPolygons supportslices = get_all_polygons(record, soSupport);
+                for(ExPolygon& p_tmp : supportslices) supports_polygons.emplace_back(std::move(p_tmp));
 
-        }
+            }
 
-        model_polygons = union_ex(model_polygons);
-        double layer_model_area = 0;
-        for (const ExPolygon& polygon : model_polygons)
-            layer_model_area += area(polygon);
+            model_polygons = union_ex(model_polygons);
+            layer.m_model_area = 0;
+            for (const ExPolygon& polygon : model_polygons)
+                layer.m_model_area += area(polygon);
 
-        const double models_volume = (layer_model_area < 0 || layer_model_area > 0) ? layer_model_area * l_height : 0.;
+            if(!supports_polygons.empty()) {
+                if(model_polygons.empty()) supports_polygons = union_ex(supports_polygons);
+                else supports_polygons = diff_ex(supports_polygons, model_polygons);
+                // allegedly, union of subject is done withing the diff according to the pftPositive polyFillType
+            }
+
+            layer.m_support_area = 0;
+            for (const ExPolygon& polygon : supports_polygons)
+                layer.m_support_area += area(polygon);
 
-        if(!supports_polygons.empty()) {
-            if(model_polygons.empty()) supports_polygons = union_ex(supports_polygons);
-            else supports_polygons = diff_ex(supports_polygons, model_polygons);
-            // allegedly, union of subject is done withing the diff according to the pftPositive polyFillType
+            // Here we can save the expensively calculated polygons for printing
+            ExPolygons trslices;
+            trslices.reserve(model_polygons.size() + supports_polygons.size());
+            for(ExPolygon& poly : model_polygons) trslices.emplace_back(std::move(poly));
+            for(ExPolygon& poly : supports_polygons) trslices.emplace_back(std::move(poly));
+
+            layer.transformed_slices(union_ex(trslices));
+            layer.m_merged_stamps = merged_stamps(layer);
         }
 
-        double layer_support_area = 0;
-        for (const ExPolygon& polygon : supports_polygons)
-            layer_support_area += area(polygon);
+        const double layer_model_area = layer.m_model_area;
+        const double models_volume = (layer_model_area < 0 || layer_model_area > 0) ? layer_model_area * l_height : 0.;
 
+        const double layer_support_area = layer.m_support_area;
         const double supports_volume = (layer_support_area < 0 || layer_support_area > 0) ? layer_support_area * l_height : 0.;
         const double layer_area = layer_model_area + layer_support_area;
 
-        // Here we can save the expensively calculated polygons for printing
-        ExPolygons trslices;
-        trslices.reserve(model_polygons.size() + supports_polygons.size());
-        for(ExPolygon& poly : model_polygons) trslices.emplace_back(std::move(poly));
-        for(ExPolygon& poly : supports_polygons) trslices.emplace_back(std::move(poly));
-
-        layer.transformed_slices(union_ex(trslices));
-
         // Calculation of the printing time
         // + Calculation of the slow and fast layers to the future controlling those values on FW
         double layer_times = 0.0;
@@ -1324,50 +1531,23 @@ void SLAPrint::Steps::rasterize()
 {
     if(canceled() || !m_print->m_archiver) return;
 
-    // coefficient to map the rasterization state (0-99) to the allocated
-    // portion (slot) of the process state
-    double sd = (100 - max_objstatus) / 100.0;
-
-    // slot is the portion of 100% that is realted to rasterization
-    unsigned slot = PRINT_STEP_LEVELS[slapsRasterize];
-
-    // pst: previous state
-    double pst = current_status();
-
-    double increment = (slot * sd) / m_print->m_printer_input.size();
-    double dstatus = current_status();
-
-    execution::SpinningMutex<ExecutionTBB> slck;
-
-    // procedure to process one height level. This will run in parallel
-    auto lvlfn =
-        [this, &slck, increment, &dstatus, &pst]
-        (sla::RasterBase& raster, size_t idx)
+    // The layers are rasterized and encoded only while exporting, streamed
+    // into the archive, so that the rasters of all the layers are never held
+    // in memory at once. Every export rasterizes the layers again.
+    // SLAPrint::export_print() only exports a finished print, thus
+    // m_printer_input is not modified while exporting: it is only written by
+    // slapsMergeSlicesAndEval, which invalidates this step.
+    // Procedure to draw one height level, it will run in parallel.
+    const SLAPrint *print = m_print;
+    auto lvlfn = [print](sla::RasterBase& raster, size_t idx)
     {
-        PrintLayer& printlayer = m_print->m_printer_input[idx];
-        if(canceled()) return;
+        assert(print->finished() && idx < print->m_printer_input.size());
 
-        for (const ExPolygon& poly : printlayer.transformed_slices())
+        for (const ExPolygon& poly : print->m_printer_input[idx].transformed_slices())
             raster.draw(poly);
-
-        // Status indication guarded with the spinlock
-        {
-            std::lock_guard lck(slck);
-            dstatus += increment;
-            double st = std::round(dstatus);
-            if(st > pst) {
-                report_status(st, PRINT_STEP_LABELS(slapsRasterize));
-                pst = st;
-            }
-        }
     };
 
-    // last minute escape
-    if(canceled()) return;
-
-    // Print all the layers in parallel
-    m_print->m_archiver->draw_layers(m_print->m_printer_input.size(), lvlfn,
-                                    [this]() { return canceled(); }, ex_tbb);
+    m_print->m_archiver->draw_layers_on_export(m_print->m_printer_input.size(), lvlfn);
 }
 
 std::string SLAPrint::Steps::label(SLAPrintObjectStep step)
@@ -51,7 +51,14 @@ private:
     bool canceled() const { return m_print->canceled(); }
     void initialize_printer_input();
 
-    void apply_printer_corrections(SLAPrintObject &po, SliceOrigin o);
+    // If 'layers' is not empty, only the slices of the marked slice records
+    // are corrected.
+    void apply_printer_corrections(SLAPrintObject &po, SliceOrigin o,
+                                   const std::vector<bool> &layers = {});
+
+    // Footprints of the triangles of the support tree and the pad, sorted.
+    static std::vector<SLAPrintObject::SupportData::SlicedTriangle>
+    sliced_triangles(const indexed_triangle_set &tree, const indexed_triangle_set &pad);
 
     void generate_preview(SLAPrintObject &po, SLAPrintObjectStep step);
     indexed_triangle_set generate_preview_vdb(SLAPrintObject &po, SLAPrintObjectStep step);
@@ -44,10 +44,13 @@ std::vector<std::pair<size_t, bool>> chain_segments_closest_point(std::vector<En
 	size_t first_point_idx = &first_point - end_points.data();
 	out.emplace_back(first_point_idx / 2, (first_point_idx & 1) != 0);
 	first_point.chain_id = 1;
+	// Points already visited are never considered again, remove them from the KD tree.
+	kdtree.remove(first_point_idx);
 	size_t this_idx = first_point_idx ^ 1;
 	for (int iter = (int)num_segments - 2; iter >= 0; -- iter) {
 		EndPointType &this_point = end_points[this_idx];
     	this_point.chain_id = 1;
+		kdtree.remove(this_idx);
     	// Find the closest point to this end_point, which lies on a different extrusion path (filtered by the lambda).
     	// Ignore the starting point as the starting point is considered to be occupied, no end point coud connect to it.
 		size_t next_idx = find_closest_point(kdtree, this_point.pos,
@@ -57,6 +60,7 @@ std::vector<std::pair<size_t, bool>> chain_segments_closest_point(std::vector<En
 		assert(next_idx < end_points.size());
 		EndPointType &end_point = end_points[next_idx];
 		end_point.chain_id = 1;
+		kdtree.remove(next_idx);
 		assert((next_idx & 1) == 0 || could_reverse_func(next_idx >> 1));
 		out.emplace_back(next_idx / 2, (next_idx & 1) != 0);
 		this_idx = next_idx ^ 1;
@@ -188,6 +192,8 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy_constrained_reversals
 			first_point->distance_out = 0.;
 			first_point->chain_id = equivalent_chain.next();
 			first_point_idx = idx;
+			// No end point may connect to the first point.
+			kdtree.remove(idx);
 		}
 		EndPoint *initial_point = first_point;
 		EndPoint *last_point = nullptr;
@@ -311,6 +317,10 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy_constrained_reversals
 								equivalent_chain.merge(end_point1_other_chain_id, end_point2_other_chain_id));
 				end_point1.chain_id = chain_id;
 				end_point2.chain_id = chain_id;
+				// Connected end points are never considered again, remove them from the KD tree,
+				// so that the closest point search does not traverse them anymore.
+				kdtree.remove(&end_point1 - &end_points.front());
+				kdtree.remove(&end_point2 - &end_points.front());
 				assert(validate_graph_and_queue());
 				if (iter == 0) {
 					// Last iteration. There shall be exactly one or two end points waiting to be connected.
@@ -353,8 +363,6 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy_constrained_reversals
 #endif /* NDEBUG */
 				// Update position of this end point in the queue based on the distance calculated at the line above.
 				queue.update(end_point1.heap_idx);
-		    	//FIXME Remove the other end point from the KD tree.
-		    	// As the KD tree update is expensive, do it only after some larger number of points is removed from the queue.
 				assert(validate_graph_and_queue());
 	    	}
 		}
@@ -403,9 +411,12 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy_constrained_reversals
 					} while (first_point != nullptr);
 				}
 			}
-			if (failed)
+			if (failed) {
 				// As a last resort, try a dumb algorithm, which is not sensitive to edge reversal constraints.
+				// Points were removed from the KD tree while chaining, start over with all of them.
+				kdtree.build(end_points.size());
 				out = chain_segments_closest_point<EndPoint, decltype(kdtree), CouldReverseFunc>(end_points, kdtree, could_reverse_func, (initial_point != nullptr) ? *initial_point : end_points.front());
+			}
 		} else {
 			assert(! failed);
 		}
@@ -712,6 +723,19 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy_constrained_reversals
 			}
 		}
 
+		if (first_point != nullptr)
+			// No end point may connect to the first point.
+			kdtree.remove(first_point_idx);
+		// A segment connected at both its ends stays inside its chain for good, flipping of the chain does not change that.
+		// Both its end points are never considered again, remove them from the KD tree.
+		auto remove_if_interior = [&kdtree, &end_points, &first_point](EndPoint *ep) {
+			EndPoint *ep_other = &ep->opposite(end_points);
+			if ((ep->edge_out != nullptr || ep == first_point) && (ep_other->edge_out != nullptr || ep_other == first_point)) {
+				kdtree.remove(ep->index(end_points));
+				kdtree.remove(ep_other->index(end_points));
+			}
+		};
+
 	    // Initialize a heap of end points sorted by the lowest distance to the next valid point of a path.
 	    auto queue = make_mutable_priority_queue<EndPoint*, true>(
 			[](EndPoint *ep, size_t idx){ ep->heap_idx = idx; }, 
@@ -879,6 +903,8 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy_constrained_reversals
 					chain.begin->chain_id = 0;
 				if (chain.end != first_point)
 					chain.end->chain_id = 0;
+				remove_if_interior(end_point1);
+				remove_if_interior(end_point2);
 				if (-- num_connections_to_end == 0) {
 					assert(validate_graph_and_queue());
 					// Last iteration. There shall be exactly one or two end points waiting to be connected.
@@ -932,8 +958,6 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy_constrained_reversals
 //					printf("Warning: taking shorter length than previously is suspicious\n");
 				}
 #endif /* NDEBUG */
-		    	//FIXME Remove the other end point from the KD tree.
-		    	// As the KD tree update is expensive, do it only after some larger number of points is removed from the queue.
 		    }
 			assert(validate_graph_and_queue());
 		}
@@ -982,9 +1006,12 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy_constrained_reversals
 					} while (first_point != nullptr);
 				}
 			}
-			if (failed)
+			if (failed) {
 				// As a last resort, try a dumb algorithm, which is not sensitive to edge reversal constraints.
+				// Points were removed from the KD tree while chaining, start over with all of them.
+				kdtree.build(end_points.size());
 				out = chain_segments_closest_point<EndPoint, decltype(kdtree), CouldReverseFunc>(end_points, kdtree, could_reverse_func, (initial_point != nullptr) ? *initial_point : end_points.front());
+			}
 		} else {
 			assert(! failed);
 		}
@@ -1020,12 +1047,66 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy2(SegmentEndPointFunc
 	return chain_segments_greedy_constrained_reversals2_<PointType, SegmentEndPointFunc, false, decltype(could_reverse_func)>(end_point_func, could_reverse_func, num_segments, start_near);
 }
 
-std::vector<std::pair<size_t, bool>> chain_extrusion_entities(const std::vector<ExtrusionEntity*> &entities, const Point *start_near, const bool reversed)
+// Bounded 2-opt improvement of a chain of segments produced by one of the greedy algorithms above:
+// A run of at most max_run_length consecutive segments is reversed (its order and the direction of each of its segments)
+// if that shortens the two connections at the ends of the run. Runs containing a segment, which cannot be reversed, are skipped.
+// If fixed_start is set, the first segment of the chain keeps its place and direction.
+// Time complexity is O(max_passes * n * max_run_length), independent of the density of the segments.
+template<typename SegmentEndPointFunc, typename CouldReverseFunc>
+void improve_chain_by_bounded_two_opt(std::vector<std::pair<size_t, bool>> &chain, SegmentEndPointFunc end_point_func, CouldReverseFunc could_reverse_func, 
+	bool fixed_start, size_t max_run_length = 64, size_t max_passes = 8)
+{
+	const size_t num_segments = chain.size();
+	if (num_segments < 2)
+		return;
+	// Points, where the path enters and leaves a segment of the chain.
+	auto entry_point = [&end_point_func](const std::pair<size_t, bool> &segment) -> Vec2d { return end_point_func(segment.first, ! segment.second).template cast<double>(); };
+	auto exit_point  = [&end_point_func](const std::pair<size_t, bool> &segment) -> Vec2d { return end_point_func(segment.first,   segment.second).template cast<double>(); };
+	for (size_t pass = 0; pass < max_passes; ++ pass) {
+		bool improved = false;
+		for (size_t begin = fixed_start ? 1 : 0; begin < num_segments; ++ begin) {
+			const bool  has_prev = begin > 0;
+			const Vec2d prev     = has_prev ? exit_point(chain[begin - 1]) : Vec2d::Zero();
+			const Vec2d first    = entry_point(chain[begin]);
+			const double cost_prev = has_prev ? (first - prev).norm() : 0.;
+			for (size_t end = begin; end < num_segments && end - begin < max_run_length; ++ end) {
+				if (! could_reverse_func(chain[end].first))
+					break;
+				// Reversing chain[begin .. end] replaces connections (prev, first) and (last, next) with (prev, last) and (first, next).
+				const Vec2d last     = exit_point(chain[end]);
+				const bool  has_next = end + 1 < num_segments;
+				if (! has_prev && ! has_next)
+					// Reversing the whole chain does not change its length.
+					continue;
+				double cost_old = cost_prev;
+				double cost_new = has_prev ? (last - prev).norm() : 0.;
+				if (has_next) {
+					const Vec2d next = entry_point(chain[end + 1]);
+					cost_old += (next - last).norm();
+					cost_new += (next - first).norm();
+				}
+				if (cost_new < cost_old - SCALED_EPSILON) {
+					std::reverse(chain.begin() + begin, chain.begin() + end + 1);
+					for (size_t i = begin; i <= end; ++ i)
+						chain[i].second = ! chain[i].second;
+					improved = true;
+					break;
+				}
+			}
+		}
+		if (! improved)
+			break;
+	}
+}
+
+std::vector<std::pair<size_t, bool>> chain_extrusion_entities(const std::vector<ExtrusionEntity*> &entities, const Point *start_near, const bool reversed, const bool improve)
 {
 	auto segment_end_point = [&entities, reversed](size_t idx, bool first_point) -> const Point& { return first_point == reversed ? entities[idx]->last_point() : entities[idx]->first_point(); };
 	auto could_reverse 	   = [&entities](size_t idx) { const ExtrusionEntity *ee = entities[idx]; return ee->is_loop() || ee->can_reverse(); };
 	std::vector<std::pair<size_t, bool>> out = chain_segments_greedy_constrained_reversals<Point, decltype(segment_end_point), decltype(could_reverse)>(
 		segment_end_point, could_reverse, entities.size(), start_near);
+	if (improve)
+		improve_chain_by_bounded_two_opt(out, segment_end_point, could_reverse, start_near != nullptr);
 	for (std::pair<size_t, bool> &segment : out) {
 		ExtrusionEntity *ee = entities[segment.first];
 		if (ee->is_loop())
@@ -1059,9 +1140,9 @@ void chain_and_reorder_extrusion_entities(std::vector<ExtrusionEntity*> &entitie
 	reorder_extrusion_entities(entities, chain_extrusion_entities(entities, start_near));
 }
 
-ExtrusionEntityReferences chain_extrusion_references(const std::vector<ExtrusionEntity*> &entities, const Point *start_near, const bool reversed)
+ExtrusionEntityReferences chain_extrusion_references(const std::vector<ExtrusionEntity*> &entities, const Point *start_near, const bool reversed, const bool improve)
 {
-	const std::vector<std::pair<size_t, bool>> chain = chain_extrusion_entities(entities, start_near, reversed);
+	const std::vector<std::pair<size_t, bool>> chain = chain_extrusion_entities(entities, start_near, reversed, improve);
 	ExtrusionEntityReferences out;
 	out.reserve(chain.size());
     for (const std::pair<size_t, bool> &idx : chain) {
@@ -1988,13 +2069,19 @@ Polylines chain_polylines(Polylines &&polylines, const Point *start_near)
 	if (! polylines.empty()) {
 		auto segment_end_point = [&polylines](size_t idx, bool first_point) -> const Point& { return first_point ? polylines[idx].first_point() : polylines[idx].last_point(); };
 		std::vector<std::pair<size_t, bool>> ordered = chain_segments_greedy2<Point, decltype(segment_end_point)>(segment_end_point, polylines.size(), start_near);
+		// The exchanges with segment flipping below are quadratic in the number of polylines,
+		// huge sets of polylines are improved by a bounded 2-opt pass instead.
+		static constexpr const size_t max_polylines_exchanges = 1000;
+		const bool bounded_two_opt = start_near == nullptr && polylines.size() > max_polylines_exchanges;
+		if (bounded_two_opt)
+			improve_chain_by_bounded_two_opt(ordered, segment_end_point, [](size_t) { return true; }, false);
 		out.reserve(polylines.size()); 
 		for (auto &segment_and_reversal : ordered) {
 			out.emplace_back(std::move(polylines[segment_and_reversal.first]));
 			if (segment_and_reversal.second)
 				out.back().reverse();
 		}
-		if (out.size() > 1 && start_near == nullptr) {
+		if (out.size() > 1 && start_near == nullptr && ! bounded_two_opt) {
 			improve_ordering_by_two_exchanges_with_segment_flipping(out, start_near != nullptr);
 			//improve_ordering_by_segment_flipping(out, start_near != nullptr);
 		}
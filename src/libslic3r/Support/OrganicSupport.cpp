@@ -1211,117 +1211,151 @@ void organic_draw_branches(
     MeshSlicingParams mesh_slicing_params;
     mesh_slicing_params.mode = MeshSlicingParams::SlicingMode::Positive;
 
-    tbb::parallel_for(tbb::blocked_range<size_t>(0, trees.size(), 1),
-        [&trees, &volumes, &config, &slicing_params, &move_bounds, &mesh_slicing_params, &throw_on_cancel](const tbb::blocked_range<size_t> &range) {
+    // Branches of all trees, each is meshed and sliced independently.
+    // Large trees may consist of thousands of branches, thus the branches are processed in parallel rather than the trees.
+    struct BranchSlices {
+        std::vector<Polygons> slices;
+        std::vector<Polygons> bottom_contacts;
+        LayerIndex            layer_begin;
+        LayerIndex            layer_end;
+        size_t                num_empty { 0 };
+    };
+    std::vector<std::pair<size_t, size_t>> tree_branches;
+    for (size_t tree_id = 0; tree_id < trees.size(); ++ tree_id)
+        for (size_t branch_id = 0; branch_id < trees[tree_id].branches.size(); ++ branch_id)
+            tree_branches.emplace_back(tree_id, branch_id);
+    std::vector<BranchSlices> branch_slices(tree_branches.size());
+
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, tree_branches.size(), 1),
+        [&trees, &tree_branches, &branch_slices, &volumes, &config, &slicing_params, &move_bounds, &mesh_slicing_params, &throw_on_cancel](const tbb::blocked_range<size_t> &range) {
+            // Buffers reused by the branches of this range.
             indexed_triangle_set    partial_mesh;
             std::vector<float>      slice_z;
-            std::vector<Polygons>   bottom_contacts;
-            for (size_t tree_id = range.begin(); tree_id < range.end(); ++ tree_id) {
-                Tree &tree = trees[tree_id];
-                for (const Branch &branch : tree.branches) {
-                    // Triangulate the tube.
-                    partial_mesh.clear();
-                    std::pair<float, float> zspan = extrude_branch(branch.path, config, slicing_params, move_bounds, partial_mesh);
-                    LayerIndex layer_begin = branch.has_root ?
-                        branch.path.front()->state.layer_idx : 
-                        std::min(branch.path.front()->state.layer_idx, layer_idx_ceil(slicing_params, config, zspan.first));
-                    LayerIndex layer_end   = (branch.has_tip ?
-                        branch.path.back()->state.layer_idx :
-                        std::max(branch.path.back()->state.layer_idx, layer_idx_floor(slicing_params, config, zspan.second))) + 1;
-                    slice_z.clear();
-                    for (LayerIndex layer_idx = layer_begin; layer_idx < layer_end; ++ layer_idx) {
-                        const double print_z  = layer_z(slicing_params, config, layer_idx);
-                        const double bottom_z = layer_idx > 0 ? layer_z(slicing_params, config, layer_idx - 1) : 0.;
-                        slice_z.emplace_back(float(0.5 * (bottom_z + print_z)));
-                    }
-                    std::vector<Polygons> slices = slice_mesh(partial_mesh, slice_z, mesh_slicing_params, throw_on_cancel);
-                    bottom_contacts.clear();
-                    //FIXME parallelize?
-                    for (LayerIndex i = 0; i < LayerIndex(slices.size()); ++ i)
-                        slices[i] = diff_clipped(slices[i], volumes.getCollision(0, layer_begin + i, true)); //FIXME parent_uses_min || draw_area.element->state.use_min_xy_dist);
-
-                    size_t num_empty = 0;
-                    if (slices.front().empty()) {
-                        // Some of the initial layers are empty.
-                        num_empty = std::find_if(slices.begin(), slices.end(), [](auto &s) { return !s.empty(); }) - slices.begin();
-                    } else {
-                        if (branch.has_root) {
-                            if (branch.path.front()->state.to_model_gracious) {
-                                if (config.settings.support_floor_layers > 0)
-                                    //FIXME one may just take the whole tree slice as bottom interface.
-                                    bottom_contacts.emplace_back(intersection_clipped(slices.front(), volumes.getPlaceableAreas(0, layer_begin, [] {})));
-                            } else if (layer_begin > 0) {
-                                // Drop down areas that do rest non - gracefully on the model to ensure the branch actually rests on something.
-                                struct BottomExtraSlice {
-                                    Polygons polygons;
-                                    double   area;
-                                };
-                                std::vector<BottomExtraSlice>   bottom_extra_slices;
-                                Polygons                        rest_support;
-                                coord_t                         bottom_radius = support_element_radius(config, *branch.path.front());
-                                // Don't propagate further than 1.5 * bottom radius.
-                                //LayerIndex                      layers_propagate_max = 2 * bottom_radius / config.layer_height;
-                                LayerIndex                      layers_propagate_max = 5 * bottom_radius / config.layer_height;
-                                LayerIndex                      layer_bottommost = branch.path.front()->state.verylost ? 
-                                    // If the tree bottom is hanging in the air, bring it down to some surface.
-                                    0 : 
-                                    //FIXME the "verylost" branches should stop when crossing another support.
-                                    std::max(0, layer_begin - layers_propagate_max);
-                                double                          support_area_min_radius = M_PI * sqr(double(config.branch_radius));
-                                double                          support_area_stop = std::max(0.2 * M_PI * sqr(double(bottom_radius)), 0.5 * support_area_min_radius);
-                                 // Only propagate until the rest area is smaller than this threshold.
-                                //double                          support_area_min = 0.1 * support_area_min_radius;
-                                for (LayerIndex layer_idx = layer_begin - 1; layer_idx >= layer_bottommost; -- layer_idx) {
-                                    rest_support = diff_clipped(rest_support.empty() ? slices.front() : rest_support, volumes.getCollision(0, layer_idx, false));
-                                    double rest_support_area = area(rest_support);
-                                    if (rest_support_area < support_area_stop)
-                                        // Don't propagate a fraction of the tree contact surface.
-                                        break;
-                                    bottom_extra_slices.push_back({ rest_support, rest_support_area });
-                                }
-                                // Now remove those bottom slices that are not supported at all.
-#if 0
-                                while (! bottom_extra_slices.empty()) {
-                                    Polygons this_bottom_contacts = intersection_clipped(
-                                        bottom_extra_slices.back().polygons, volumes.getPlaceableAreas(0, layer_begin - LayerIndex(bottom_extra_slices.size()), [] {}));
-                                    if (area(this_bottom_contacts) < support_area_min)
-                                        bottom_extra_slices.pop_back();
-                                    else {
-                                        // At least a fraction of the tree bottom is considered to be supported.
-                                        if (config.settings.support_floor_layers > 0)
-                                            // Turn this fraction of the tree bottom into a contact layer.
-                                            bottom_contacts.emplace_back(std::move(this_bottom_contacts));
-                                        break;
-                                    }
-                                }
-#endif
-                                if (config.settings.support_floor_layers > 0)
-                                    for (int i = int(bottom_extra_slices.size()) - 2; i >= 0; -- i)
-                                        bottom_contacts.emplace_back(
-                                            intersection_clipped(bottom_extra_slices[i].polygons, volumes.getPlaceableAreas(0, layer_begin - i - 1, [] {})));
-                                layer_begin -= LayerIndex(bottom_extra_slices.size());
-                                slices.insert(slices.begin(), bottom_extra_slices.size(), {});
-                                auto it_dst = slices.begin();
-                                for (auto it_src = bottom_extra_slices.rbegin(); it_src != bottom_extra_slices.rend(); ++ it_src)
-                                    *it_dst ++ = std::move(it_src->polygons);
+            for (size_t branch_idx = range.begin(); branch_idx < range.end(); ++ branch_idx) {
+                const Branch &branch = trees[tree_branches[branch_idx].first].branches[tree_branches[branch_idx].second];
+                BranchSlices &out    = branch_slices[branch_idx];
+                // Triangulate the tube.
+                partial_mesh.clear();
+                std::pair<float, float> zspan = extrude_branch(branch.path, config, slicing_params, move_bounds, partial_mesh);
+                LayerIndex &layer_begin = out.layer_begin;
+                LayerIndex &layer_end   = out.layer_end;
+                layer_begin = branch.has_root ?
+                    branch.path.front()->state.layer_idx : 
+                    std::min(branch.path.front()->state.layer_idx, layer_idx_ceil(slicing_params, config, zspan.first));
+                layer_end   = (branch.has_tip ?
+                    branch.path.back()->state.layer_idx :
+                    std::max(branch.path.back()->state.layer_idx, layer_idx_floor(slicing_params, config, zspan.second))) + 1;
+                slice_z.clear();
+                for (LayerIndex layer_idx = layer_begin; layer_idx < layer_end; ++ layer_idx) {
+                    const double print_z  = layer_z(slicing_params, config, layer_idx);
+                    const double bottom_z = layer_idx > 0 ? layer_z(slicing_params, config, layer_idx - 1) : 0.;
+                    slice_z.emplace_back(float(0.5 * (bottom_z + print_z)));
+                }
+                std::vector<Polygons> &slices          = out.slices;
+                std::vector<Polygons> &bottom_contacts = out.bottom_contacts;
+                size_t                &num_empty       = out.num_empty;
+                slices = slice_mesh(partial_mesh, slice_z, mesh_slicing_params, throw_on_cancel);
+                //FIXME parallelize?
+                for (LayerIndex i = 0; i < LayerIndex(slices.size()); ++ i)
+                    slices[i] = diff_clipped(slices[i], volumes.getCollision(0, layer_begin + i, true)); //FIXME parent_uses_min || draw_area.element->state.use_min_xy_dist);
+
+                if (slices.front().empty()) {
+                    // Some of the initial layers are empty.
+                    num_empty = std::find_if(slices.begin(), slices.end(), [](auto &s) { return !s.empty(); }) - slices.begin();
+                } else {
+                    if (branch.has_root) {
+                        if (branch.path.front()->state.to_model_gracious) {
+                            if (config.settings.support_floor_layers > 0)
+                                //FIXME one may just take the whole tree slice as bottom interface.
+                                bottom_contacts.emplace_back(intersection_clipped(slices.front(), volumes.getPlaceableAreas(0, layer_begin, [] {})));
+                        } else if (layer_begin > 0) {
+                            // Drop down areas that do rest non - gracefully on the model to ensure the branch actually rests on something.
+                            struct BottomExtraSlice {
+                                Polygons polygons;
+                                double   area;
+                            };
+                            std::vector<BottomExtraSlice>   bottom_extra_slices;
+                            Polygons                        rest_support;
+                            coord_t                         bottom_radius = support_element_radius(config, *branch.path.front());
+                            // Don't propagate further than 1.5 * bottom radius.
+                            //LayerIndex                      layers_propagate_max = 2 * bottom_radius / config.layer_height;
+                            LayerIndex                      layers_propagate_max = 5 * bottom_radius / config.layer_height;
+                            LayerIndex                      layer_bottommost = branch.path.front()->state.verylost ? 
+                                // If the tree bottom is hanging in the air, bring it down to some surface.
+                                0 : 
+                                //FIXME the "verylost" branches should stop when crossing another support.
+                                std::max(0, layer_begin - layers_propagate_max);
+                            double                          support_area_min_radius = M_PI * sqr(double(config.branch_radius));
+                            double                          support_area_stop = std::max(0.2 * M_PI * sqr(double(bottom_radius)), 0.5 * support_area_min_radius);
+                             // Only propagate until the rest area is smaller than this threshold.
+                            //double                          support_area_min = 0.1 * support_area_min_radius;
+                            for (LayerIndex layer_idx = layer_begin - 1; layer_idx >= layer_bottommost; -- layer_idx) {
+                                rest_support = diff_clipped(rest_support.empty() ? slices.front() : rest_support, volumes.getCollision(0, layer_idx, false));
+                                double rest_support_area = area(rest_support);
+                                if (rest_support_area < support_area_stop)
+                                    // Don't propagate a fraction of the tree contact surface.
+                                    break;
+                                bottom_extra_slices.push_back({ rest_support, rest_support_area });
                             }
-                        }
-                        
+                            // Now remove those bottom slices that are not supported at all.
 #if 0
-                        //FIXME branch.has_tip seems to not be reliable.
-                        if (branch.has_tip && interface_placer.support_parameters.has_top_contacts)
-                            // Add top slices to top contacts / interfaces / base interfaces.
-                            for (int i = int(branch.path.size()) - 1; i >= 0; -- i) {
-                                const SupportElement &el = *branch.path[i];
-                                if (el.state.missing_roof_layers == 0)
+                            while (! bottom_extra_slices.empty()) {
+                                Polygons this_bottom_contacts = intersection_clipped(
+                                    bottom_extra_slices.back().polygons, volumes.getPlaceableAreas(0, layer_begin - LayerIndex(bottom_extra_slices.size()), [] {}));
+                                if (area(this_bottom_contacts) < support_area_min)
+                                    bottom_extra_slices.pop_back();
+                                else {
+                                    // At least a fraction of the tree bottom is considered to be supported.
+                                    if (config.settings.support_floor_layers > 0)
+                                        // Turn this fraction of the tree bottom into a contact layer.
+                                        bottom_contacts.emplace_back(std::move(this_bottom_contacts));
                                     break;
-                                //FIXME Move or not?
-                                interface_placer.add_roof(std::move(slices[int(slices.size()) - i - 1]), el.state.layer_idx,
-                                    interface_placer.support_parameters.num_top_interface_layers + 1 - el.state.missing_roof_layers);
+                                }
                             }
 #endif
+                            if (config.settings.support_floor_layers > 0)
+                                for (int i = int(bottom_extra_slices.size()) - 2; i >= 0; -- i)
+                                    bottom_contacts.emplace_back(
+                                        intersection_clipped(bottom_extra_slices[i].polygons, volumes.getPlaceableAreas(0, layer_begin - i - 1, [] {})));
+                            layer_begin -= LayerIndex(bottom_extra_slices.size());
+                            slices.insert(slices.begin(), bottom_extra_slices.size(), {});
+                            auto it_dst = slices.begin();
+                            for (auto it_src = bottom_extra_slices.rbegin(); it_src != bottom_extra_slices.rend(); ++ it_src)
+                                *it_dst ++ = std::move(it_src->polygons);
+                        }
                     }
+                    
+#if 0
+                    //FIXME branch.has_tip seems to not be reliable.
+                    if (branch.has_tip && interface_placer.support_parameters.has_top_contacts)
+                        // Add top slices to top contacts / interfaces / base interfaces.
+                        for (int i = int(branch.path.size()) - 1; i >= 0; -- i) {
+                            const SupportElement &el = *branch.path[i];
+                            if (el.state.missing_roof_layers == 0)
+                                break;
+                            //FIXME Move or not?
+                            interface_placer.add_roof(std::move(slices[int(slices.size()) - i - 1]), el.state.layer_idx,
+                                interface_placer.support_parameters.num_top_interface_layers + 1 - el.state.missing_roof_layers);
+                        }
+#endif
+                }
+            }
+        });
 
+    // Collect the slices of branches into their trees in the order of the branches.
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, trees.size(), 1),
+        [&trees, &tree_branches, &branch_slices, &throw_on_cancel](const tbb::blocked_range<size_t> &range) {
+            for (size_t tree_id = range.begin(); tree_id < range.end(); ++ tree_id) {
+                Tree &tree = trees[tree_id];
+                auto  it_branch = std::lower_bound(tree_branches.begin(), tree_branches.end(), std::make_pair(tree_id, size_t(0)));
+                for (size_t branch_id = 0; branch_id < tree.branches.size(); ++ branch_id) {
+                    assert(it_branch->first == tree_id && it_branch->second == branch_id);
+                    BranchSlices          &branch          = branch_slices[it_branch ++ - tree_branches.begin()];
+                    std::vector<Polygons> &slices          = branch.slices;
+                    std::vector<Polygons> &bottom_contacts = branch.bottom_contacts;
+                    LayerIndex             layer_begin     = branch.layer_begin;
+                    LayerIndex             layer_end       = branch.layer_end;
+                    const size_t           num_empty       = branch.num_empty;
                     layer_begin += LayerIndex(num_empty);
                     while (! slices.empty() && slices.back().empty()) {
                         slices.pop_back();
@@ -1360,24 +1394,19 @@ void organic_draw_branches(
                         }
                         tree.first_layer_id = new_begin;
                     }
+                    // Release the branch slices early.
+                    branch = {};
                 }
+                for (Slice &slice : tree.slices)
+                    if (slice.num_branches > 1) {
+                        slice.polygons        = union_(slice.polygons);
+                        slice.bottom_contacts = union_(slice.bottom_contacts);
+                        slice.num_branches = 1;
+                    }
+                throw_on_cancel();
             }
         }, tbb::simple_partitioner());
 
-    tbb::parallel_for(tbb::blocked_range<size_t>(0, trees.size(), 1),
-        [&trees, &throw_on_cancel](const tbb::blocked_range<size_t> &range) {
-        for (size_t tree_id = range.begin(); tree_id < range.end(); ++ tree_id) {
-            Tree &tree = trees[tree_id];
-            for (Slice &slice : tree.slices)
-                if (slice.num_branches > 1) {
-                    slice.polygons        = union_(slice.polygons);
-                    slice.bottom_contacts = union_(slice.bottom_contacts);
-                    slice.num_branches = 1;
-                }
-            throw_on_cancel();
-        }
-    }, tbb::simple_partitioner());
-
     size_t num_layers = 0;
     for (Tree &tree : trees)
         if (tree.first_layer_id >= 0)
@@ -0,0 +1,101 @@
+///|/ Copyright (c) Prusa Research 2022 - 2023 Vojtěch Bubník @bubnikv
+///|/
+///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
+///|/
+#include "RadiusLayerPolygonCache.hpp"
+
+#include <algorithm>
+
+namespace Slic3r::FFFTreeSupport
+{
+
+void RadiusLayerPolygonCache::insert(LayerIndex layer_idx, coord_t radius, Polygons &&polygons)
+{
+    assert(layer_idx >= 0);
+    const size_t iseg = segment_idx(layer_idx);
+    assert(iseg < NumSegments);
+    LayerData *segment = m_segments[iseg].load(std::memory_order_acquire);
+    if (segment == nullptr) {
+        auto *new_segment = new LayerData[segment_size(iseg)];
+        if (m_segments[iseg].compare_exchange_strong(segment, new_segment, std::memory_order_acq_rel, std::memory_order_acquire))
+            segment = new_segment;
+        else
+            // Another thread allocated the segment in the meantime.
+            delete[] new_segment;
+    }
+
+    Node *node = nullptr;
+    for (;;) {
+        // Find the link to insert the new node to, keeping the list sorted by radius.
+        std::atomic<Node*> *link = &segment[size_t(layer_idx) - segment_begin(iseg)].head;
+        Node               *next = link->load(std::memory_order_acquire);
+        while (next && next->radius < radius) {
+            link = &next->next;
+            next = link->load(std::memory_order_acquire);
+        }
+        if (next && next->radius == radius) {
+            // Already cached, keep the old polygons, they may be referenced already.
+            delete node;
+            return;
+        }
+        if (node == nullptr)
+            node = new Node(radius, std::move(polygons));
+        node->next.store(next, std::memory_order_relaxed);
+        if (link->compare_exchange_weak(next, node, std::memory_order_release, std::memory_order_relaxed))
+            break;
+        // Another thread modified the link, search again.
+    }
+
+    for (LayerIndex num_layers = m_num_layers.load(std::memory_order_relaxed); 
+        num_layers <= layer_idx && ! m_num_layers.compare_exchange_weak(num_layers, layer_idx + 1, std::memory_order_release, std::memory_order_relaxed);) ;
+}
+
+void RadiusLayerPolygonCache::clear()
+{
+    for (size_t iseg = 0; iseg < NumSegments; ++ iseg)
+        if (LayerData *segment = m_segments[iseg].exchange(nullptr); segment) {
+            for (size_t i = 0; i < segment_size(iseg); ++ i)
+                for (Node *node = segment[i].head.load(std::memory_order_relaxed); node;) {
+                    Node *next = node->next.load(std::memory_order_relaxed);
+                    delete node;
+                    node = next;
+                }
+            delete[] segment;
+        }
+    m_num_layers = 0;
+}
+
+void RadiusLayerPolygonCache::clear_all_but_radius0()
+{
+    for (size_t iseg = 0; iseg < NumSegments; ++ iseg)
+        if (LayerData *segment = m_segments[iseg].load(std::memory_order_relaxed); segment)
+            for (size_t i = 0; i < segment_size(iseg); ++ i)
+                if (Node *first = segment[i].head.load(std::memory_order_relaxed); first) {
+                    // The list is sorted by radius, thus the radius 0 item is the first one if there is any.
+                    for (Node *node = first->radius == 0 ? first->next.exchange(nullptr) : segment[i].head.exchange(nullptr); node;) {
+                        Node *next = node->next.load(std::memory_order_relaxed);
+                        delete node;
+                        node = next;
+                    }
+                }
+}
+
+void RadiusLayerPolygonCache::move_from(RadiusLayerPolygonCache &rhs)
+{
+    for (size_t iseg = 0; iseg < NumSegments; ++ iseg)
+        m_segments[iseg].store(rhs.m_segments[iseg].exchange(nullptr));
+    m_num_layers.store(rhs.m_num_layers.exchange(0));
+}
+
+// For debugging purposes, sorted by layer index, then by radius.
+std::vector<std::pair<RadiusLayerPair, std::reference_wrapper<const Polygons>>> RadiusLayerPolygonCache::sorted() const
+{
+    std::vector<std::pair<RadiusLayerPair, std::reference_wrapper<const Polygons>>> out;
+    for (LayerIndex layer_idx = 0; layer_idx < m_num_layers.load(std::memory_order_acquire); ++ layer_idx)
+        for (const Node *node = this->first_node(layer_idx); node; node = node->next.load(std::memory_order_acquire))
+            out.emplace_back(std::make_pair(node->radius, layer_idx), node->polygons);
+    assert(std::is_sorted(out.begin(), out.end(), [](auto &l, auto &r){ return l.first.second < r.first.second || (l.first.second == r.first.second && l.first.first < r.first.first); }));
+    return out;
+}
+
+} // namespace Slic3r::FFFTreeSupport
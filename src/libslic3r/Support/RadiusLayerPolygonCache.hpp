@@ -0,0 +1,172 @@
+///|/ Copyright (c) Prusa Research 2022 - 2023 Vojtěch Bubník @bubnikv
+///|/
+///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
+///|/
+// Caches of the collision, avoidance and placeable areas of the tree supports, see TreeModelVolumes.
+
+#ifndef slic3r_RadiusLayerPolygonCache_hpp
+#define slic3r_RadiusLayerPolygonCache_hpp
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <functional>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "TreeSupportCommon.hpp"
+#include "../Polygon.hpp"
+
+namespace Slic3r
+{
+
+namespace FFFTreeSupport
+{
+
+// Caching polygons for a range of layers.
+class LayerPolygonCache {
+public:
+    void allocate(LayerIndex aidx_begin, LayerIndex aidx_end) {
+        m_idx_begin = aidx_begin;
+        m_idx_end = aidx_end;
+        m_polygons.assign(aidx_end - aidx_begin, {});
+    }
+
+    LayerIndex begin() const { return m_idx_begin; }
+    LayerIndex end()   const { return m_idx_end; }
+    size_t     size()  const { return m_polygons.size(); }
+
+    bool      has(LayerIndex idx) const { return idx >= m_idx_begin && idx < m_idx_end; }
+    Polygons& operator[](LayerIndex idx) { assert(idx >= m_idx_begin && idx < m_idx_end); return m_polygons[idx - m_idx_begin]; }
+    std::vector<Polygons>& polygons_mutable() { return m_polygons; }
+
+private:
+    std::vector<Polygons> m_polygons;
+    LayerIndex            m_idx_begin;
+    LayerIndex            m_idx_end;
+};
+
+/*!
+ * \brief Convenience typedef for the keys to the caches
+ */
+using RadiusLayerPair             = std::pair<coord_t, LayerIndex>;
+// Cache of polygons indexed by radius and layer, accessed concurrently from multiple threads.
+// Lookups do not lock: The layers are stored in segments of exponentially increasing size, which are never reallocated,
+// each layer holds a singly linked list of radii sorted by radius. New items are published by an atomic compare and swap.
+// Items are never removed while the cache is being accessed concurrently, thus references to Polygons returned are stable.
+class RadiusLayerPolygonCache {
+    struct Node {
+        Node(coord_t radius, Polygons &&polygons) : radius(radius), polygons(std::move(polygons)) {}
+        coord_t             radius;
+        Polygons            polygons;
+        std::atomic<Node*>  next { nullptr };
+    };
+    struct LayerData {
+        std::atomic<Node*>  head { nullptr };
+    };
+    // The first segment holds SegmentSize0 layers, each next segment is twice the size of the previous one.
+    static constexpr const size_t SegmentSize0 = 64;
+    static constexpr const size_t NumSegments  = 24;
+public:
+    RadiusLayerPolygonCache() = default;
+    RadiusLayerPolygonCache(RadiusLayerPolygonCache &&rhs) { this->move_from(rhs); }
+    RadiusLayerPolygonCache& operator=(RadiusLayerPolygonCache &&rhs) { if (this != &rhs) { this->clear(); this->move_from(rhs); } return *this; }
+    ~RadiusLayerPolygonCache() { this->clear(); }
+
+    RadiusLayerPolygonCache(const RadiusLayerPolygonCache&) = delete;
+    RadiusLayerPolygonCache& operator=(const RadiusLayerPolygonCache&) = delete;
+
+    // If a polygon is already cached for a radius and layer, the new one is dropped.
+    void insert(std::vector<std::pair<RadiusLayerPair, Polygons>> &&in) {
+        for (auto &d : in)
+            this->insert(d.first.second, d.first.first, std::move(d.second));
+    }
+    // by layer
+    void insert(std::vector<std::pair<coord_t, Polygons>> &&in, coord_t radius) {
+        for (auto &d : in)
+            this->insert(d.first, radius, std::move(d.second));
+    }
+    void insert(std::vector<Polygons> &&in, coord_t first_layer_idx, coord_t radius) {
+        for (auto &d : in)
+            this->insert(first_layer_idx ++, radius, std::move(d));
+    }
+    void insert(LayerPolygonCache &&in, coord_t radius) {
+        LayerIndex i = in.begin();
+        for (auto &d : in.polygons_mutable())
+            this->insert(i ++, radius, std::move(d));
+    }
+    /*!
+     * \brief Checks a cache for a given RadiusLayerPair and returns it if it is found
+     * \param key RadiusLayerPair of the requested areas. The radius will be calculated up to the provided layer.
+     * \return A wrapped optional reference of the requested area (if it was found, an empty optional if nothing was found)
+     */
+    std::optional<std::reference_wrapper<const Polygons>> getArea(const RadiusLayerPair &key) const {
+        for (const Node *node = this->first_node(key.second); node && node->radius <= key.first; node = node->next.load(std::memory_order_acquire))
+            if (node->radius == key.first)
+                return std::optional<std::reference_wrapper<const Polygons>>{ node->polygons };
+        return std::nullopt;
+    }
+    // Get a collision area at a given layer for a radius that is a lower or equial to the key radius.
+    std::optional<std::pair<coord_t, std::reference_wrapper<const Polygons>>> get_lower_bound_area(const RadiusLayerPair &key) const {
+        const Node *found = nullptr;
+        for (const Node *node = this->first_node(key.second); node && node->radius <= key.first; node = node->next.load(std::memory_order_acquire))
+            found = node;
+        if (found == nullptr)
+            return {};
+        return std::make_pair(found->radius, std::reference_wrapper<const Polygons>(found->polygons));
+    }
+    /*!
+     * \brief Get the highest already calculated layer in the cache.
+     * \param radius The radius for which the highest already calculated layer has to be found.
+     * \param map The cache in which the lookup is performed.
+     *
+     * \return A wrapped optional reference of the requested area (if it was found, an empty optional if nothing was found)
+     */
+    LayerIndex getMaxCalculatedLayer(coord_t radius) const {
+        auto layer_idx = m_num_layers.load(std::memory_order_acquire) - 1;
+        for (; layer_idx > 0; -- layer_idx)
+            if (this->getArea({ radius, layer_idx }))
+                break;
+        // The placeable on model areas do not exist on layer 0, as there can not be model below it. As such it may be possible that layer 1 is available, but layer 0 does not exist.
+        return layer_idx == 0 ? -1 : layer_idx;
+    }
+
+    // For debugging purposes, sorted by layer index, then by radius.
+    [[nodiscard]] std::vector<std::pair<RadiusLayerPair, std::reference_wrapper<const Polygons>>> sorted() const;
+
+    // Not thread safe.
+    void clear();
+    void clear_all_but_radius0();
+
+private:
+    static size_t       segment_idx(LayerIndex layer_idx) {
+        size_t v = size_t(layer_idx) / SegmentSize0 + 1;
+        size_t seg = 0;
+        while (v >>= 1)
+            ++ seg;
+        return seg;
+    }
+    static size_t       segment_begin(size_t segment_idx) { return SegmentSize0 * ((size_t(1) << segment_idx) - 1); }
+    static size_t       segment_size(size_t segment_idx) { return SegmentSize0 << segment_idx; }
+
+    const Node*         first_node(LayerIndex layer_idx) const {
+        if (layer_idx < 0 || layer_idx >= m_num_layers.load(std::memory_order_acquire))
+            return nullptr;
+        size_t           iseg    = segment_idx(layer_idx);
+        const LayerData *segment = m_segments[iseg].load(std::memory_order_acquire);
+        return segment ? segment[size_t(layer_idx) - segment_begin(iseg)].head.load(std::memory_order_acquire) : nullptr;
+    }
+    // Thread safe.
+    void                insert(LayerIndex layer_idx, coord_t radius, Polygons &&polygons);
+    void                move_from(RadiusLayerPolygonCache &rhs);
+
+    std::array<std::atomic<LayerData*>, NumSegments> m_segments {};
+    // One past the highest layer with an item.
+    std::atomic<LayerIndex>                          m_num_layers { 0 };
+};
+
+} // namespace FFFTreeSupport
+} // namespace Slic3r
+
+#endif // slic3r_RadiusLayerPolygonCache_hpp
@@ -2499,6 +2499,12 @@ void PrintObjectSupportMaterial::trim_support_layers_by_object(
         tbb::blocked_range<size_t>(0, nonempty_layers.size()),
         [this, &object, &nonempty_layers, gap_extra_above, gap_extra_below, gap_xy_scaled](const tbb::blocked_range<size_t>& range) {
             size_t idx_object_layer_overlapping = size_t(-1);
+            // The trimming polygons of all the layers of this range are collected first to be clipped in a single batch.
+            std::vector<Polygons>        trimming(range.size());
+            std::vector<const Polygons*> subjects;
+            std::vector<const Polygons*> clips;
+            subjects.reserve(range.size());
+            clips.reserve(range.size());
             for (size_t idx_layer = range.begin(); idx_layer < range.end(); ++ idx_layer) {
                 SupportGeneratorLayer &support_layer = *nonempty_layers[idx_layer];
                 // BOOST_LOG_TRIVIAL(trace) << "Support generator - trim_support_layers_by_object - trimmming non-empty layer " << idx_layer << " of " << nonempty_layers.size();
@@ -2509,7 +2515,7 @@ void PrintObjectSupportMaterial::trim_support_layers_by_object(
                     object.layers().begin(), object.layers().end(), idx_object_layer_overlapping,
                     [z_threshold](const Layer *layer){ return layer->print_z >= z_threshold; });
                 // Collect all the object layers intersecting with this layer.
-                Polygons polygons_trimming;
+                Polygons &polygons_trimming = trimming[idx_layer - range.begin()];
                 size_t i = idx_object_layer_overlapping;
                 for (; i < object.layers().size(); ++ i) {
                     const Layer &object_layer = *object.layers()[i];
@@ -2541,8 +2547,12 @@ void PrintObjectSupportMaterial::trim_support_layers_by_object(
                 // perimeter's width. $support contains the full shape of support
                 // material, thus including the width of its foremost extrusion.
                 // We leave a gap equal to a full extrusion width.
-                support_layer.polygons = diff(support_layer.polygons, polygons_trimming);
+                subjects.emplace_back(&support_layer.polygons);
+                clips.emplace_back(&polygons_trimming);
             }
+            std::vector<Polygons> trimmed = diff_batch(subjects, clips);
+            for (size_t idx_layer = range.begin(); idx_layer < range.end(); ++ idx_layer)
+                nonempty_layers[idx_layer]->polygons = std::move(trimmed[idx_layer - range.begin()]);
         });
     BOOST_LOG_TRIVIAL(debug) << "PrintObjectSupportMaterial::trim_support_layers_by_object() in parallel - end";
 }
@@ -162,6 +162,108 @@ TreeModelVolumes::TreeModelVolumes(
         });
     }
 #endif
+
+    m_cache_key = this->calculate_cache_key();
+}
+
+// Hash of polygons layer by layer, the layers are hashed in parallel.
+static size_t hash_layer_polygons(const std::vector<Polygons> &layers)
+{
+    std::vector<size_t> layer_hashes(layers.size(), 0);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, layers.size()),
+        [&layers, &layer_hashes](const tbb::blocked_range<size_t> &range) {
+        for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx) {
+            size_t seed = layers[layer_idx].size();
+            for (const Polygon &polygon : layers[layer_idx]) {
+                boost::hash_combine(seed, polygon.size());
+                for (const Point &pt : polygon.points) {
+                    boost::hash_combine(seed, pt.x());
+                    boost::hash_combine(seed, pt.y());
+                }
+            }
+            layer_hashes[layer_idx] = seed;
+        }
+    });
+    return boost::hash_range(layer_hashes.begin(), layer_hashes.end());
+}
+
+size_t TreeModelVolumes::calculate_cache_key() const
+{
+    size_t seed = 0;
+    for (const auto &[settings, outlines] : m_layer_outlines) {
+        // Only the settings used by calculateCollision().
+        boost::hash_combine(seed, settings.layer_height);
+        boost::hash_combine(seed, settings.support_bottom_distance);
+        boost::hash_combine(seed, settings.support_top_distance);
+        boost::hash_combine(seed, settings.support_xy_distance);
+        boost::hash_combine(seed, settings.resolution);
+        boost::hash_combine(seed, settings.support_material_buildplate_only);
+        boost::hash_combine(seed, hash_layer_polygons(outlines));
+    }
+    boost::hash_combine(seed, hash_layer_polygons(m_anti_overhang));
+    boost::hash_combine(seed, hash_layer_polygons({ m_machine_border }));
+    boost::hash_combine(seed, m_max_move);
+    boost::hash_combine(seed, m_max_move_slow);
+    boost::hash_combine(seed, m_min_resolution);
+    boost::hash_combine(seed, m_current_outline_idx);
+    boost::hash_combine(seed, m_current_min_xy_dist);
+    boost::hash_combine(seed, m_current_min_xy_dist_delta);
+    boost::hash_combine(seed, m_support_rests_on_model);
+    boost::hash_combine(seed, m_increase_until_radius);
+    return seed;
+}
+
+bool TreeModelVolumes::same_cache_inputs(const TreeModelVolumes &rhs) const
+{
+    if (m_layer_outlines.size() != rhs.m_layer_outlines.size())
+        return false;
+    for (size_t idx = 0; idx < m_layer_outlines.size(); ++ idx) {
+        // Only the settings used by calculateCollision(), the same as hashed by calculate_cache_key().
+        const TreeSupportMeshGroupSettings &settings     = m_layer_outlines[idx].first;
+        const TreeSupportMeshGroupSettings &settings_rhs = rhs.m_layer_outlines[idx].first;
+        if (settings.layer_height                     != settings_rhs.layer_height ||
+            settings.support_bottom_distance          != settings_rhs.support_bottom_distance ||
+            settings.support_top_distance             != settings_rhs.support_top_distance ||
+            settings.support_xy_distance              != settings_rhs.support_xy_distance ||
+            settings.resolution                       != settings_rhs.resolution ||
+            settings.support_material_buildplate_only != settings_rhs.support_material_buildplate_only ||
+            m_layer_outlines[idx].second              != rhs.m_layer_outlines[idx].second)
+            return false;
+    }
+    return m_anti_overhang             == rhs.m_anti_overhang &&
+           m_machine_border            == rhs.m_machine_border &&
+           m_max_move                  == rhs.m_max_move &&
+           m_max_move_slow             == rhs.m_max_move_slow &&
+           m_min_resolution            == rhs.m_min_resolution &&
+           m_current_outline_idx       == rhs.m_current_outline_idx &&
+           m_current_min_xy_dist       == rhs.m_current_min_xy_dist &&
+           m_current_min_xy_dist_delta == rhs.m_current_min_xy_dist_delta &&
+           m_support_rests_on_model    == rhs.m_support_rests_on_model &&
+           m_increase_until_radius     == rhs.m_increase_until_radius;
+}
+
+bool TreeModelVolumes::reuse_caches(TreeModelVolumes &&rhs)
+{
+    // The hash rejects most of the changes quickly, the inputs are compared to rule out a hash collision.
+    if (rhs.m_cache_key != m_cache_key || ! this->same_cache_inputs(rhs))
+        return false;
+    m_collision_cache                   = std::move(rhs.m_collision_cache);
+    m_collision_cache_holefree          = std::move(rhs.m_collision_cache_holefree);
+    m_avoidance_cache                   = std::move(rhs.m_avoidance_cache);
+    m_avoidance_cache_slow              = std::move(rhs.m_avoidance_cache_slow);
+    m_avoidance_cache_to_model          = std::move(rhs.m_avoidance_cache_to_model);
+    m_avoidance_cache_to_model_slow     = std::move(rhs.m_avoidance_cache_to_model_slow);
+    m_placeable_areas_cache             = std::move(rhs.m_placeable_areas_cache);
+    m_avoidance_cache_holefree          = std::move(rhs.m_avoidance_cache_holefree);
+    m_avoidance_cache_holefree_to_model = std::move(rhs.m_avoidance_cache_holefree_to_model);
+    m_wall_restrictions_cache           = std::move(rhs.m_wall_restrictions_cache);
+    m_wall_restrictions_cache_min       = std::move(rhs.m_wall_restrictions_cache_min);
+    return true;
+}
+
+void TreeModelVolumesDeleter::operator()(TreeModelVolumes *p)
+{
+    delete p;
 }
 
 void TreeModelVolumes::precalculate(const PrintObject& print_object, const coord_t max_layer, std::function<void()> throw_on_cancel)
@@ -596,7 +698,8 @@ void TreeModelVolumes::calculateCollisionHolefree(const std::vector<RadiusLayerP
         data.reserve(range.size() * keys.size());
         for (LayerIndex layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx) {
             for (RadiusLayerPair key : keys)
-                if (layer_idx <= key.second) {
+                // The collisions may already be cached from a previous run, see reuse_caches().
+                if (layer_idx <= key.second && ! m_collision_cache_holefree.getArea({ key.first, layer_idx })) {
                     // Logically increase the collision by m_increase_until_radius
                     coord_t radius = key.first;
                     assert(radius == this->ceilRadius(radius));
@@ -860,26 +963,4 @@ coord_t TreeModelVolumes::ceilRadius(const coord_t radius) const
     return out;
 }
 
-void TreeModelVolumes::RadiusLayerPolygonCache::allocate_layers(size_t num_layers)
-{
-    if (num_layers > m_data.size()) {
-        if (num_layers > m_data.capacity())
-            reserve_power_of_2(m_data, num_layers);
-        m_data.resize(num_layers, {});
-    }
-}
-
-// For debugging purposes, sorted by layer index, then by radius.
-std::vector<std::pair<TreeModelVolumes::RadiusLayerPair, std::reference_wrapper<const Polygons>>> TreeModelVolumes::RadiusLayerPolygonCache::sorted() const
-{
-    std::vector<std::pair<RadiusLayerPair, std::reference_wrapper<const Polygons>>> out;
-    for (auto &layer : m_data) {
-        auto layer_idx = LayerIndex(&layer - m_data.data());
-        for (auto &radius_polygons : layer)
-            out.emplace_back(std::make_pair(radius_polygons.first, layer_idx), radius_polygons.second);
-    }
-    assert(std::is_sorted(out.begin(), out.end(), [](auto &l, auto &r){ return l.first.second < r.first.second || (l.first.second == r.first.second) && l.first.first < r.first.first; }));
-    return out;
-}
-
 } // namespace Slic3r::FFFTreeSupport
@@ -17,6 +17,8 @@
 #include <assert.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <array>
+#include <atomic>
 #include <mutex>
 #include <unordered_map>
 #include <functional>
@@ -28,6 +30,7 @@
 #include <cinttypes>
 #include <cstddef>
 
+#include "RadiusLayerPolygonCache.hpp"
 #include "TreeSupportCommon.hpp"
 #include "../Point.hpp"
 #include "../Polygon.hpp"
@@ -65,6 +68,21 @@ public:
     TreeModelVolumes(const TreeModelVolumes&) = delete;
     TreeModelVolumes& operator=(const TreeModelVolumes&) = delete;
 
+    /*!
+     * \brief Hash of the model outlines, of the areas to be avoided and of the parameters the collision, avoidance, placeable and wall restriction caches depend on.
+     *
+     * The caches are indexed by the rounded radius, thus the parameters that only affect rounding of the radius (branch diameter, tip diameter) are not part of the key.
+     */
+    size_t cache_key() const { return m_cache_key; }
+    /*!
+     * \brief Take over the caches of TreeModelVolumes kept from a previous run of the support generator.
+     *
+     * The caches are taken over only if they were calculated for the same model outlines and the same parameters.
+     * The cache keys are compared first, then the inputs themselves.
+     * \return Were the caches reused?
+     */
+    bool reuse_caches(TreeModelVolumes &&rhs);
+
     void clear() { 
         this->clear_all_but_object_collision();
         m_collision_cache.clear();
@@ -182,146 +200,9 @@ public:
     }
 
 private:
-    // Caching polygons for a range of layers.
-    class LayerPolygonCache {
-    public:
-        void allocate(LayerIndex aidx_begin, LayerIndex aidx_end) {
-            m_idx_begin = aidx_begin;
-            m_idx_end = aidx_end;
-            m_polygons.assign(aidx_end - aidx_begin, {});
-        }
-
-        LayerIndex begin() const { return m_idx_begin; }
-        LayerIndex end()   const { return m_idx_end; }
-        size_t     size()  const { return m_polygons.size(); }
-
-        bool      has(LayerIndex idx) const { return idx >= m_idx_begin && idx < m_idx_end; }
-        Polygons& operator[](LayerIndex idx) { assert(idx >= m_idx_begin && idx < m_idx_end); return m_polygons[idx - m_idx_begin]; }
-        std::vector<Polygons>& polygons_mutable() { return m_polygons; }
-
-    private:
-        std::vector<Polygons> m_polygons;
-        LayerIndex            m_idx_begin;
-        LayerIndex            m_idx_end;
-    };
-
-    /*!
-     * \brief Convenience typedef for the keys to the caches
-     */
-    using RadiusLayerPair             = std::pair<coord_t, LayerIndex>;
-    class RadiusLayerPolygonCache {
-        // Map from radius to Polygons. Cache of one layer collision regions.
-        using LayerData = std::map<coord_t, Polygons>;
-        // Vector of layers, at each layer map of radius to Polygons.
-        // Reference to Polygons returned shall be stable to insertion.
-        using Layers = std::vector<LayerData>;
-    public:
-        RadiusLayerPolygonCache() = default;
-        RadiusLayerPolygonCache(RadiusLayerPolygonCache &&rhs) : m_data(std::move(rhs.m_data)) {}
-        RadiusLayerPolygonCache& operator=(RadiusLayerPolygonCache &&rhs) { m_data = std::move(rhs.m_data); return *this; }
-
-        RadiusLayerPolygonCache(const RadiusLayerPolygonCache&) = delete;
-        RadiusLayerPolygonCache& operator=(const RadiusLayerPolygonCache&) = delete;
-
-        void insert(std::vector<std::pair<RadiusLayerPair, Polygons>> &&in) {
-            std::lock_guard<std::mutex> guard(m_mutex);
-            for (auto &d : in)
-                this->get_allocate_layer_data(d.first.second).emplace(d.first.first, std::move(d.second));
-        }
-        // by layer
-        void insert(std::vector<std::pair<coord_t, Polygons>> &&in, coord_t radius) {
-            std::lock_guard<std::mutex> guard(m_mutex);
-            for (auto &d : in)
-                this->get_allocate_layer_data(d.first).emplace(radius, std::move(d.second));
-        }
-        void insert(std::vector<Polygons> &&in, coord_t first_layer_idx, coord_t radius) {
-            std::lock_guard<std::mutex> guard(m_mutex);
-            allocate_layers(first_layer_idx + in.size());
-            for (auto &d : in)
-                m_data[first_layer_idx ++].emplace(radius, std::move(d));
-        }
-        void insert(LayerPolygonCache &&in, coord_t radius) {
-            std::lock_guard<std::mutex> guard(m_mutex);
-            LayerIndex i = in.begin();
-            allocate_layers(i + LayerIndex(in.size()));
-            for (auto &d : in.polygons_mutable())
-                m_data[i ++].emplace(radius, std::move(d));
-        }
-        /*!
-         * \brief Checks a cache for a given RadiusLayerPair and returns it if it is found
-         * \param key RadiusLayerPair of the requested areas. The radius will be calculated up to the provided layer.
-         * \return A wrapped optional reference of the requested area (if it was found, an empty optional if nothing was found)
-         */
-        std::optional<std::reference_wrapper<const Polygons>> getArea(const TreeModelVolumes::RadiusLayerPair &key) const {
-            std::lock_guard<std::mutex> guard(m_mutex);
-
-            if (key.second >= LayerIndex(m_data.size()))
-                return std::nullopt;
-
-            const LayerData &layer = m_data[key.second];
-            auto it = layer.find(key.first);
-            if (it == layer.end())
-                return std::nullopt;
-
-            return std::optional<std::reference_wrapper<const Polygons>>{it->second};
-        }
-        // Get a collision area at a given layer for a radius that is a lower or equial to the key radius.
-        std::optional<std::pair<coord_t, std::reference_wrapper<const Polygons>>> get_lower_bound_area(const TreeModelVolumes::RadiusLayerPair &key) const {
-            std::lock_guard<std::mutex> guard(m_mutex);
-            if (key.second >= LayerIndex(m_data.size()))
-                return {};
-            const auto &layer = m_data[key.second];
-            if (layer.empty())
-                return {};
-            auto it = layer.lower_bound(key.first);
-            if (it == layer.end() || it->first != key.first) {
-                if (it == layer.begin())
-                    return {};
-                -- it;
-            }
-            return std::make_pair(it->first, std::reference_wrapper<const Polygons>(it->second));
-        }
-        /*!
-         * \brief Get the highest already calculated layer in the cache.
-         * \param radius The radius for which the highest already calculated layer has to be found.
-         * \param map The cache in which the lookup is performed.
-         *
-         * \return A wrapped optional reference of the requested area (if it was found, an empty optional if nothing was found)
-         */
-        LayerIndex getMaxCalculatedLayer(coord_t radius) const {
-            std::lock_guard<std::mutex> guard(m_mutex);
-            auto layer_idx = LayerIndex(m_data.size()) - 1;
-            for (; layer_idx > 0; -- layer_idx)
-                if (const auto &layer = m_data[layer_idx]; layer.find(radius) != layer.end())
-                    break;
-            // The placeable on model areas do not exist on layer 0, as there can not be model below it. As such it may be possible that layer 1 is available, but layer 0 does not exist.
-            return layer_idx == 0 ? -1 : layer_idx;
-        }
-
-        // For debugging purposes, sorted by layer index, then by radius.
-        [[nodiscard]] std::vector<std::pair<RadiusLayerPair, std::reference_wrapper<const Polygons>>> sorted() const;
-
-        void clear() { m_data.clear(); }
-        void clear_all_but_radius0() { 
-            for (LayerData &l : m_data) {
-                auto begin = l.begin();
-                auto end = l.end();
-                if (begin != end && ++ begin != end)
-                    l.erase(begin, end);
-            }
-        }
-
-    private:
-        LayerData&          get_allocate_layer_data(LayerIndex layer_idx) {
-            allocate_layers(layer_idx + 1);
-            return m_data[layer_idx];
-        }
-        void                allocate_layers(size_t num_layers);
-
-        Layers              m_data;
-        mutable std::mutex  m_mutex;
-    };
-
+    size_t calculate_cache_key() const;
+    // Are the inputs of the caches equal to the inputs of rhs? See cache_key().
+    bool   same_cache_inputs(const TreeModelVolumes &rhs) const;
 
     /*!
      * \brief Provides the areas that have to be avoided by the tree's branches to prevent collision with the model on this layer. Holes are removed.
@@ -509,6 +390,11 @@ private:
     // Z heights of the raft layers (additional layers below the object, last raft layer aligned with the bottom of the first object layer).
     std::vector<double>         m_raft_layers;
 
+    /*!
+     * \brief Hash of the inputs of the caches below, see cache_key().
+     */
+    size_t                      m_cache_key { 0 };
+
     /*!
      * \brief Caches for the collision, avoidance and areas on the model where support can be placed safely
      * at given radius and layer indices.
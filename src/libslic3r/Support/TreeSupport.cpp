@@ -16,7 +16,6 @@
 #include <oneapi/tbb/blocked_range.h>
 #include <oneapi/tbb/parallel_for.h>
 #include <oneapi/tbb/partitioner.h>
-#include <oneapi/tbb/task_arena.h>
 #include <cassert>
 #include <chrono>
 #include <optional>
@@ -24,6 +23,7 @@
 #include <cmath>
 #include <cstdint>
 #include <iterator>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <numeric>
@@ -2322,7 +2322,7 @@ static SupportElementMerging* merge_influence_areas_two_sets(
 }
 
 /*!
- * \brief Merges Influence Areas at one layer if possible.
+ * \brief Merges a cluster of Influence Areas at one layer if possible.
  *
  * Branches which do overlap have to be merged. This manages the helper and uses a divide and conquer approach to parallelize this problem. This parallelization can at most accelerate the merging by a factor of 2.
  *
@@ -2334,7 +2334,7 @@ static SupportElementMerging* merge_influence_areas_two_sets(
  *  Value is the influence area where the center of a circle of support may be placed.
  * \param layer_idx[in] The current layer.
  */
-static void merge_influence_areas(
+static void merge_influence_areas_cluster(
     const TreeModelVolumes             &volumes, 
     const TreeSupportSettings          &config, 
     const LayerIndex                    layer_idx,
@@ -2342,7 +2342,7 @@ static void merge_influence_areas(
     std::function<void()>               throw_on_cancel)
 {
     const size_t input_size = influence_areas.size();
-    if (input_size == 0)
+    if (input_size < 2)
         return;
 
     // Merging by divide & conquer.
@@ -2368,13 +2368,14 @@ static void merge_influence_areas(
     size_t num_buckets_initial;
     {
         // How many buckets per first merge iteration?
-        const size_t num_threads     = tbb::this_task_arena::max_concurrency();
-        // 4 buckets per thread if possible,
+        // The buckets do not depend on the number of threads, so that the merge result does not depend on the number of threads either.
+        // Buckets of 4 influence areas if there are enough of them to keep the threads busy,
         const size_t num_buckets_min = (input_size + 2) / 4;
-        // 2 buckets per thread otherwise.
+        // buckets of 2 influence areas otherwise.
         const size_t num_buckets_max = input_size / 2;
-        num_buckets_initial          = num_buckets_min >= num_threads ? num_buckets_min : num_buckets_max;
-        const size_t bucket_size     = num_buckets_min >= num_threads ? 4 : 2;
+        const bool   large_buckets   = input_size >= 64;
+        num_buckets_initial          = large_buckets ? num_buckets_min : num_buckets_max;
+        const size_t bucket_size     = large_buckets ? 4 : 2;
         // Fill in the buckets.
         SupportElementMerging *it = influence_areas.data();
         // Reserve one more bucket to keep a single influence area which will not be merged in the first iteration.
@@ -2424,6 +2425,118 @@ static void merge_influence_areas(
     }
 }
 
+/*!
+ * \brief Splits influence areas into clusters, which cannot be merged with each other.
+ *
+ * merge_influence_areas_two_elements() only merges two influence areas if their bounding boxes are not further apart
+ * than the difference of their radii, therefore influence areas with bounding boxes further apart than max_radius_delta
+ * end up in different clusters.
+ *
+ * \param influence_areas[in] Influence areas to be clustered.
+ * \param max_radius_delta[in] Maximum difference of radii of the influence areas.
+ * \return Cluster index of each influence area. Clusters are numbered in the order of their first influence area.
+ */
+static std::vector<size_t> cluster_influence_areas(const std::vector<SupportElementMerging> &influence_areas, const coord_t max_radius_delta)
+{
+    const size_t        num_areas = influence_areas.size();
+    // Union-find, the root of a cluster is its lowest index.
+    std::vector<size_t> parent(num_areas);
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find_root = [&parent](size_t i) {
+        while (parent[i] != i)
+            i = parent[i] = parent[parent[i]];
+        return i;
+    };
+
+    // Sweep and prune along the X axis.
+    std::vector<size_t> order(num_areas);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&influence_areas](size_t l, size_t r) { return influence_areas[l].bbox().min().x() < influence_areas[r].bbox().min().x(); });
+    for (size_t i = 0; i < num_areas; ++ i) {
+        const Eigen::AlignedBox<coord_t, 2> &bbox_i = influence_areas[order[i]].bbox();
+        for (size_t j = i + 1; j < num_areas; ++ j) {
+            const Eigen::AlignedBox<coord_t, 2> &bbox_j = influence_areas[order[j]].bbox();
+            if (bbox_j.min().x() > bbox_i.max().x() + max_radius_delta)
+                break;
+            if (bbox_j.min().y() <= bbox_i.max().y() + max_radius_delta && bbox_i.min().y() <= bbox_j.max().y() + max_radius_delta) {
+                size_t root_i = find_root(order[i]);
+                size_t root_j = find_root(order[j]);
+                if (root_i != root_j)
+                    parent[std::max(root_i, root_j)] = std::min(root_i, root_j);
+            }
+        }
+    }
+
+    std::vector<size_t> cluster_of_root(num_areas, std::numeric_limits<size_t>::max());
+    std::vector<size_t> out(num_areas);
+    size_t              num_clusters = 0;
+    for (size_t i = 0; i < num_areas; ++ i) {
+        size_t &cluster = cluster_of_root[find_root(i)];
+        if (cluster == std::numeric_limits<size_t>::max())
+            cluster = num_clusters ++;
+        out[i] = cluster;
+    }
+    return out;
+}
+
+/*!
+ * \brief Merges Influence Areas at one layer if possible.
+ *
+ * The influence areas are first split into clusters of influence areas with overlapping bounding boxes.
+ * The clusters are merged in parallel by merge_influence_areas_cluster(), which parallelizes merging of a single cluster as well.
+ *
+ * \param influence_areas[in,out] The Elements of the current Layer.
+ * \param layer_idx[in] The current layer.
+ */
+static void merge_influence_areas(
+    const TreeModelVolumes             &volumes, 
+    const TreeSupportSettings          &config, 
+    const LayerIndex                    layer_idx,
+    std::vector<SupportElementMerging> &influence_areas,
+    std::function<void()>               throw_on_cancel)
+{
+    if (influence_areas.size() < 2)
+        return;
+
+    coord_t min_radius = std::numeric_limits<coord_t>::max();
+    coord_t max_radius = 0;
+    for (const SupportElementMerging &elem : influence_areas) {
+        coord_t radius = support_element_radius(config, elem.state);
+        min_radius = std::min(min_radius, radius);
+        max_radius = std::max(max_radius, radius);
+    }
+
+    std::vector<size_t> cluster_ids  = cluster_influence_areas(influence_areas, max_radius - min_radius);
+    const size_t        num_clusters = *std::max_element(cluster_ids.begin(), cluster_ids.end()) + 1;
+    if (num_clusters == 1) {
+        merge_influence_areas_cluster(volumes, config, layer_idx, influence_areas, throw_on_cancel);
+        return;
+    }
+
+    std::vector<std::vector<SupportElementMerging>> clusters(num_clusters);
+    for (size_t i = 0; i < influence_areas.size(); ++ i)
+        clusters[cluster_ids[i]].emplace_back(std::move(influence_areas[i]));
+    influence_areas.clear();
+
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_clusters, 1),
+        [&](const tbb::blocked_range<size_t> &range) {
+        for (size_t cluster_idx = range.begin(); cluster_idx < range.end(); ++ cluster_idx)
+            merge_influence_areas_cluster(volumes, config, layer_idx, clusters[cluster_idx], throw_on_cancel);
+    });
+
+    bool radii_in_bounds = true;
+    for (std::vector<SupportElementMerging> &cluster : clusters)
+        for (SupportElementMerging &elem : cluster) {
+            coord_t radius = support_element_radius(config, elem.state);
+            radii_in_bounds &= radius >= min_radius && radius <= max_radius;
+            influence_areas.emplace_back(std::move(elem));
+        }
+
+    if (! radii_in_bounds)
+        // A merged branch got thicker than any of the branches before merging, thus it may now reach a branch of another cluster.
+        merge_influence_areas_cluster(volumes, config, layer_idx, influence_areas, throw_on_cancel);
+}
+
 /*!
  * \brief Propagates influence downwards, and merges overlapping ones.
  *
@@ -2506,9 +2619,16 @@ static void create_layer_pathing(const TreeModelVolumes &volumes, const TreeSupp
             dur_total += std::chrono::high_resolution_clock::now() - ta;
 
             // Save calculated elements to output, and allocate Polygons on heap, as they will not be changed again.
-            for (SupportElementMerging &elem : influence_areas)
-                if (! elem.areas.influence_areas.empty()) {
-                    Polygons new_area = safe_union(elem.areas.influence_areas);
+            std::vector<Polygons> new_areas(influence_areas.size());
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, influence_areas.size()),
+                [&influence_areas, &new_areas](const tbb::blocked_range<size_t> &range) {
+                for (size_t elem_idx = range.begin(); elem_idx < range.end(); ++ elem_idx)
+                    if (const SupportElementMerging &elem = influence_areas[elem_idx]; ! elem.areas.influence_areas.empty())
+                        new_areas[elem_idx] = safe_union(elem.areas.influence_areas);
+            });
+            for (size_t elem_idx = 0; elem_idx < influence_areas.size(); ++ elem_idx)
+                if (SupportElementMerging &elem = influence_areas[elem_idx]; ! elem.areas.influence_areas.empty()) {
+                    Polygons &new_area = new_areas[elem_idx];
                     if (area(new_area) < tiny_area_threshold) {
                         BOOST_LOG_TRIVIAL(error) << "Insert Error of Influence area on layer " << layer_idx - 1 << ". Origin of " << elem.parents.size() << " areas. Was to bp " << elem.state.to_buildplate;
                         tree_supports_show_error("Insert error of area after merge.\n"sv, true);
@@ -3466,11 +3586,18 @@ static void generate_support_areas(Print &print, const BuildVolume &build_volume
 #endif // SLIC3R_TREESUPPORT_PROGRESS
         PrintObject &print_object = *print.get_object(processing.second.front());
         // Generator for model collision, avoidance and internal guide volumes.
-        TreeModelVolumes volumes{ print_object, build_volume, config.maximum_move_distance, config.maximum_move_distance_slow, processing.second.front(),
+        TreeModelVolumesPtr new_volumes{ new TreeModelVolumes{ print_object, build_volume, config.maximum_move_distance, config.maximum_move_distance_slow, processing.second.front(),
 #ifdef SLIC3R_TREESUPPORTS_PROGRESS
             m_progress_multiplier, m_progress_offset, 
 #endif // SLIC3R_TREESUPPORTS_PROGRESS
-            /* additional_excluded_areas */{} };
+            /* additional_excluded_areas */{} } };
+        // Reuse the collisions and avoidances calculated by the previous run if the slices and the relevant parameters did not change,
+        // for example if just the support interface parameters were modified. The volumes are kept by the PrintObject for the next run.
+        TreeModelVolumesPtr &cached_volumes = print_object.tree_model_volumes_cache();
+        if (cached_volumes && new_volumes->reuse_caches(std::move(*cached_volumes)))
+            BOOST_LOG_TRIVIAL(info) << "Reusing tree support collision and avoidance caches of the previous run.";
+        cached_volumes = std::move(new_volumes);
+        TreeModelVolumes &volumes = *cached_volumes;
 
         //FIXME generating overhangs just for the furst mesh of the group.
         assert(processing.second.size() == 1);
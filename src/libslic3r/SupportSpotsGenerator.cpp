@@ -9,6 +9,7 @@
 #include <oneapi/tbb/concurrent_vector.h>
 #include <oneapi/tbb/parallel_for.h>
 #include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/task_group.h>
 #include <algorithm>
 #include <cmath>
 #include <cstddef>
@@ -997,32 +998,45 @@ std::optional<PartialObject> to_partial_object(const ObjectPart& part) {
     return {};
 }
 
-SliceMappings update_active_object_parts(const Layer                        *layer,
-                                         const Params                       &params,
-                                         const std::vector<SliceConnection> &precomputed_slice_connections,
-                                         const SliceMappings                &previous_slice_mappings,
-                                         ActiveObjectParts                  &active_object_parts,
-                                         PartialObjects                     &partial_objects)
+// Object parts of the individual slices of a layer, not yet merged with the object parts below.
+// Independent of the other layers, thus they may be calculated in parallel ahead of the bottom-up sweep.
+std::vector<ObjectPart> compute_slices_object_parts(const Layer *layer, const Params &params)
 {
-    SliceMappings new_slice_mappings;
-
+    std::vector<ObjectPart> slices_object_parts;
+    slices_object_parts.reserve(layer->lslices_ex.size());
+    const bool connected_to_bed = int(layer->id()) == params.raft_layers_count;
     for (size_t slice_idx = 0; slice_idx < layer->lslices_ex.size(); ++slice_idx) {
         const LayerSlice &slice             = layer->lslices_ex.at(slice_idx);
         const std::vector<const ExtrusionEntityCollection*> extrusion_collections{gather_extrusions(slice, layer)};
-        const bool connected_to_bed = int(layer->id()) == params.raft_layers_count;
 
         const std::optional<Polygons> brim{
              has_brim(layer, params) ?
              std::optional{get_brim(layer->lslices[slice_idx], params.brim_type, params.brim_width)} :
              std::nullopt
         };
-        ObjectPart new_part{
+        slices_object_parts.emplace_back(
             extrusion_collections,
             connected_to_bed,
             layer->print_z,
             layer->height,
             brim
-        };
+        );
+    }
+    return slices_object_parts;
+}
+
+SliceMappings update_active_object_parts(const Layer                        *layer,
+                                         const std::vector<ObjectPart>      &slices_object_parts,
+                                         const std::vector<SliceConnection> &precomputed_slice_connections,
+                                         const SliceMappings                &previous_slice_mappings,
+                                         ActiveObjectParts                  &active_object_parts,
+                                         PartialObjects                     &partial_objects)
+{
+    SliceMappings new_slice_mappings;
+
+    for (size_t slice_idx = 0; slice_idx < layer->lslices_ex.size(); ++slice_idx) {
+        const LayerSlice &slice             = layer->lslices_ex.at(slice_idx);
+        const ObjectPart &new_part          = slices_object_parts[slice_idx];
 
         const SliceConnection &connection_to_below = precomputed_slice_connections[slice_idx];
 
@@ -1124,57 +1138,80 @@ void reckon_global_supports(const tbb::concurrent_vector<ExtrusionLine> &externa
 
 std::tuple<SupportPoints, PartialObjects> check_stability(const PrintObject                 *po,
                                                           const PrecomputedSliceConnections &precomputed_slices_connections,
-                                                          const PrintTryCancel              &cancel_func,
+                                                          const std::function<void()>       &cancel_func,
                                                           const Params                      &params)
 {
     SupportPoints     supp_points{};
     SupportGridFilter supports_presence_grid(po, params.min_distance_between_support_points);
     ActiveObjectParts active_object_parts{};
     PartialObjects    partial_objects{};
-    LD                prev_layer_ext_perim_lines;
-
-    SliceMappings slice_mappings;
+    SliceMappings     slice_mappings;
+
+    // The object parts of the slices do not depend on the layers below, calculate them for all layers in parallel.
+    std::vector<std::vector<ObjectPart>> slices_object_parts(po->layer_count());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, po->layer_count()), [po, &params, &slices_object_parts, &cancel_func](tbb::blocked_range<size_t> r) {
+        for (size_t layer_idx = r.begin(); layer_idx < r.end(); ++layer_idx) {
+            cancel_func();
+            slices_object_parts[layer_idx] = compute_slices_object_parts(po->get_layer(layer_idx), params);
+        }
+    });
 
+    // The extrusion checks of a layer only depend on the external perimeters of the layer below, not on the merged object parts.
+    // They are calculated one layer ahead, in parallel with the sequential sweep merging the object parts of the current layer.
+    auto compute_layer_local_supports = [po, &params](size_t layer_idx, const LD &prev_layer_ext_perim_lines) {
+        const Layer          *layer               = po->get_layer(layer_idx);
+        std::optional<Linesf> prev_layer_boundary = layer->lower_layer != nullptr ?
+                                                        std::optional{to_unscaled_linesf(layer->lower_layer->lslices)} :
+                                                        std::nullopt;
+        return compute_local_supports(gather_entities_to_check(layer), prev_layer_boundary, prev_layer_ext_perim_lines,
+                                      layer->lslices_ex.size(), params);
+    };
+    LD            prev_layer_ext_perim_lines;
+    LocalSupports local_supports;
+    LocalSupports next_local_supports;
+    if (po->layer_count() > 0)
+        local_supports = compute_layer_local_supports(0, prev_layer_ext_perim_lines);
 
     for (size_t layer_idx = 0; layer_idx < po->layer_count(); ++layer_idx) {
         cancel_func();
         const Layer *layer                 = po->get_layer(layer_idx);
         float        bottom_z              = layer->bottom_z();
 
-        slice_mappings = update_active_object_parts(layer, params, precomputed_slices_connections[layer_idx], slice_mappings, active_object_parts, partial_objects);
-
-        std::optional<Linesf> prev_layer_boundary = layer->lower_layer != nullptr ?
-                                                        std::optional{to_unscaled_linesf(layer->lower_layer->lslices)} :
-                                                        std::nullopt;
+        {
+            std::vector<ExtrusionLine> current_layer_ext_perims_lines{};
+            current_layer_ext_perims_lines.reserve(prev_layer_ext_perim_lines.get_lines().size());
+            for (const tbb::concurrent_vector<ExtrusionLine> &external_perimeter_lines : local_supports.ext_perim_lines_per_slice)
+                current_layer_ext_perims_lines.insert(current_layer_ext_perims_lines.end(), external_perimeter_lines.begin(), external_perimeter_lines.end());
+            prev_layer_ext_perim_lines = LD(current_layer_ext_perims_lines);
+        }
+        tbb::task_group next_layer_task;
+        if (layer_idx + 1 < po->layer_count())
+            next_layer_task.run([&compute_layer_local_supports, &next_local_supports, &prev_layer_ext_perim_lines, layer_idx]() {
+                next_local_supports = compute_layer_local_supports(layer_idx + 1, prev_layer_ext_perim_lines);
+            });
 
-        LocalSupports local_supports{
-            compute_local_supports(gather_entities_to_check(layer), prev_layer_boundary, prev_layer_ext_perim_lines, layer->lslices_ex.size(), params)};
+        slice_mappings = update_active_object_parts(layer, slices_object_parts[layer_idx], precomputed_slices_connections[layer_idx], slice_mappings, active_object_parts, partial_objects);
+        slices_object_parts[layer_idx].clear();
 
-        std::vector<ExtrusionLine> current_layer_ext_perims_lines{};
-        current_layer_ext_perims_lines.reserve(prev_layer_ext_perim_lines.get_lines().size());
         // All object parts updated, and for each slice we have coresponding weakest connection.
         // We can now check each slice and its corresponding weakest connection and object part for stability.
-        for (size_t slice_idx = 0; slice_idx < layer->lslices_ex.size(); ++slice_idx) {
-            ObjectPart                &part         = active_object_parts.access(slice_mappings.index_to_object_part_mapping[slice_idx]);
-            SliceConnection           &weakest_conn = slice_mappings.index_to_weakest_connection[slice_idx];
+        if (layer_idx > 1) {
+            for (size_t slice_idx = 0; slice_idx < layer->lslices_ex.size(); ++slice_idx) {
+                ObjectPart                &part         = active_object_parts.access(slice_mappings.index_to_object_part_mapping[slice_idx]);
+                SliceConnection           &weakest_conn = slice_mappings.index_to_weakest_connection[slice_idx];
 
-            if (layer_idx > 1) {
                 for (const auto &l : local_supports.unstable_lines_per_slice[slice_idx]) {
                     assert(l.support_point_generated.has_value());
                     SupportPoint support_point{*l.support_point_generated, to_3d(l.b, bottom_z),
                                                params.support_points_interface_radius};
                     reckon_new_support_point(part, weakest_conn, supp_points, supports_presence_grid, support_point);
                 }
-            }
-
-            const tbb::concurrent_vector<ExtrusionLine> &external_perimeter_lines = local_supports.ext_perim_lines_per_slice[slice_idx];
-            if (layer_idx > 1) {
-                reckon_global_supports(external_perimeter_lines, bottom_z, params, part, weakest_conn, supp_points, supports_presence_grid);
-            }
 
-            current_layer_ext_perims_lines.insert(current_layer_ext_perims_lines.end(), external_perimeter_lines.begin(), external_perimeter_lines.end());
-        } // slice iterations
-        prev_layer_ext_perim_lines = LD(current_layer_ext_perims_lines);
+                reckon_global_supports(local_supports.ext_perim_lines_per_slice[slice_idx], bottom_z, params, part, weakest_conn, supp_points, supports_presence_grid);
+            } // slice iterations
+        }
+        next_layer_task.wait();
+        std::swap(local_supports, next_local_supports);
     } // layer iterations
 
     for (const auto& active_obj_pair : slice_mappings.index_to_object_part_mapping) {
@@ -1227,7 +1264,7 @@ void debug_export(const SupportPoints& support_points,const PartialObjects& obje
 }
 #endif
 
-std::tuple<SupportPoints, PartialObjects> full_search(const PrintObject *po, const PrintTryCancel& cancel_func, const Params &params)
+std::tuple<SupportPoints, PartialObjects> full_search(const PrintObject *po, const std::function<void()> &cancel_func, const Params &params)
 {
     auto precomputed_slices_connections = precompute_slices_connections(po);
     auto results = check_stability(po, precomputed_slices_connections, cancel_func, params);
@@ -7,6 +7,7 @@
 
 #include <boost/log/trivial.hpp>
 #include <cstddef>
+#include <functional>
 #include <vector>
 #include <algorithm>
 #include <optional>
@@ -270,7 +271,7 @@ public:
 using PartialObjects = std::vector<PartialObject>;
 
 // Both support points and partial objects are sorted from the lowest z to the highest
-std::tuple<SupportPoints, PartialObjects> full_search(const PrintObject *po, const PrintTryCancel& cancel_func, const Params &params);
+std::tuple<SupportPoints, PartialObjects> full_search(const PrintObject *po, const std::function<void()> &cancel_func, const Params &params);
 
 void estimate_supports_malformations(std::vector<SupportLayer *> &layers, float supports_flow_width, const Params &params);
 void estimate_malformations(std::vector<Layer *> &layers, const Params &params);
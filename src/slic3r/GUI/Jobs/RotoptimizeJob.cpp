@@ -28,13 +28,20 @@ void RotoptimizeJob::prepare()
     std::string method_str =
         wxGetApp().app_config->get("sla_auto_rotate", "method_id");
 
+    std::string time_budget_str =
+        wxGetApp().app_config->get("sla_auto_rotate", "time_budget");
+
     if (!accuracy_str.empty())
         m_accuracy = std::stof(accuracy_str);
 
     if (!method_str.empty())
         m_method_id = std::stoi(method_str);
 
+    if (!time_budget_str.empty())
+        m_time_budget = std::stod(time_budget_str);
+
     m_accuracy = std::max(0.f, std::min(m_accuracy, 1.f));
+    m_time_budget = std::max(0., m_time_budget);
     m_method_id = std::max(size_t(0), std::min(get_methods_count() - 1, m_method_id));
 
     m_default_print_cfg = wxGetApp().preset_bundle->full_config();
@@ -60,6 +67,7 @@ void RotoptimizeJob::process(Ctl &ctl)
     auto params =
         sla::RotOptimizeParams{}
             .accuracy(m_accuracy)
+            .time_budget(m_time_budget)
             .print_config(&m_default_print_cfg)
             .statucb([this, &prev_status, &ctl, &statustxt](int s)
         {
@@ -38,6 +38,8 @@ class RotoptimizeJob : public Job
 
     size_t m_method_id = 0;
     float  m_accuracy  = 0.75;
+    // Seconds per object, zero means no limit.
+    double m_time_budget = 0.;
 
     DynamicPrintConfig m_default_print_cfg;
 
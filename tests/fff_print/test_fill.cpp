@@ -3,9 +3,12 @@
 #include <numeric>
 #include <sstream>
 
+#include <oneapi/tbb/task_arena.h>
+
 #include "libslic3r/libslic3r.h"
 
 #include "libslic3r/ClipperUtils.hpp"
+#include "libslic3r/Fill/FillGyroid.hpp"
 #include "libslic3r/Flow.hpp"
 #include "libslic3r/Layer.hpp"
 #include "libslic3r/Geometry.hpp"
@@ -197,6 +200,65 @@ TEST_CASE("Fill: Pattern Path Length", "[Fill]") {
     }
 }
 
+TEST_CASE("Fill: Gyroid waves repeat with the gyroid period", "[Fill]") {
+    std::unique_ptr<Slic3r::Fill> filler(Slic3r::Fill::new_from_type("gyroid"));
+    FillParams fill_params;
+    fill_params.density = 0.2f;
+    filler->spacing = 0.45;
+
+    Slic3r::ExPolygon expolygon(Slic3r::Points{ Point::new_scale(0, 0), Point::new_scale(40, 0), Point::new_scale(40, 40), Point::new_scale(0, 40) });
+    Slic3r::Surface   surface(stInternal, expolygon);
+    // Period of the gyroid along Z in mm.
+    const double period = 2. * PI * filler->spacing / (fill_params.density * FillGyroid::DensityAdjust);
+
+    for (double z : { 0.2, 1.35, 7.1 }) {
+        filler->z = z;
+        Slic3r::Polylines paths = filler->fill_surface(&surface, fill_params);
+        filler->z = z + 3. * period;
+        Slic3r::Polylines paths_next_period = filler->fill_surface(&surface, fill_params);
+        REQUIRE(! paths.empty());
+        REQUIRE(paths == paths_next_period);
+        // paths don't leave the surface
+        REQUIRE(diff_pl(paths, offset(expolygon, float(SCALED_EPSILON * 10))).empty());
+    }
+}
+
+TEST_CASE("Fill: Surface groups filled in parallel match the serial fill", "[Fill]") {
+    // Infill of all the layers, region by region, in the order of the extrusions.
+    auto collect_fills = [](const Print &print) {
+        std::vector<Polylines> out;
+        for (const Layer *layer : print.get_object(0)->layers())
+            for (const LayerRegion *layerm : layer->regions()) {
+                out.emplace_back();
+                for (const ExtrusionEntity *ee : layerm->fills().entities)
+                    ee->collect_polylines(out.back());
+            }
+        return out;
+    };
+
+    for (const char *pattern : { "rectilinear", "honeycomb", "gyroid", "concentric" }) {
+        DynamicPrintConfig config = DynamicPrintConfig::full_print_config_with({
+            { "fill_pattern",     pattern },
+            { "fill_density",     "20%" },
+            { "top_solid_layers", 2 },
+            { "perimeters",       1 }
+        });
+        // Two islands per layer and solid infill at the top and bottom, thus several surface groups per layer.
+        Print print_parallel;
+        Test::init_and_process_print({ Test::TestMesh::two_hollow_squares }, print_parallel, config);
+        // A single thread runs the fill tasks one after another, reusing the fillers.
+        Print print_serial;
+        tbb::task_arena serial_arena(1);
+        serial_arena.execute([&print_serial, &config]() {
+            Test::init_and_process_print({ Test::TestMesh::two_hollow_squares }, print_serial, config);
+        });
+        INFO("Pattern " << pattern);
+        std::vector<Polylines> fills = collect_fills(print_parallel);
+        REQUIRE(std::any_of(fills.begin(), fills.end(), [](const Polylines &p) { return ! p.empty(); }));
+        REQUIRE(fills == collect_fills(print_serial));
+    }
+}
+
 SCENARIO("Infill does not exceed perimeters", "[Fill]") 
 {
     auto test = [](const std::string_view pattern) {
@@ -7,6 +7,7 @@
 #include "libslic3r/Geometry.hpp"
 #include "libslic3r/Geometry/ConvexHull.hpp"
 #include "libslic3r/Print.hpp"
+#include "libslic3r/TriangleSelector.hpp"
 #include "libslic3r/libslic3r.h"
 
 #include "test_data.hpp"
@@ -269,3 +270,92 @@ SCENARIO("Stacked cubes", "[Multi]")
         }
     }
 }
+
+// Paint facets of the first volume, which are fully inside one of the bands (from the bottom of the mesh), with the second extruder.
+static void paint_bands(Model &model, const std::vector<std::pair<double, double>> &bands)
+{
+    ModelVolume              &volume = *model.objects.front()->volumes.front();
+    const indexed_triangle_set &its  = volume.mesh().its;
+    const double              z_min  = volume.mesh().bounding_box().min.z();
+    TriangleSelector          selector(volume.mesh());
+    for (int facet_idx = 0; facet_idx < int(its.indices.size()); ++ facet_idx) {
+        auto [facet_min, facet_max] = std::minmax({ its.vertices[its.indices[facet_idx](0)].z(), its.vertices[its.indices[facet_idx](1)].z(), its.vertices[its.indices[facet_idx](2)].z() });
+        for (const auto &[band_min, band_max] : bands)
+            if (facet_min - z_min >= band_min && facet_max - z_min <= band_max)
+                selector.set_facet(facet_idx, TriangleStateType::Extruder2);
+    }
+    volume.mm_segmentation_facets.set(selector);
+}
+
+static std::vector<std::vector<ExPolygons>> region_slices(const Print &print)
+{
+    std::vector<std::vector<ExPolygons>> out;
+    for (const Layer *layer : print.objects().front()->layers()) {
+        std::vector<ExPolygons> &regions = out.emplace_back();
+        for (const LayerRegion *layerm : layer->regions())
+            regions.emplace_back(to_expolygons(layerm->slices().surfaces));
+    }
+    return out;
+}
+
+TEST_CASE("MMU segmentation of a repainted object matches a fresh segmentation", "[Multi]")
+{
+    auto config = Slic3r::DynamicPrintConfig::full_print_config_with({
+        { "nozzle_diameter",        "0.4,0.4" },
+        { "layer_height",           0.2 },
+        { "first_layer_height",     0.2 },
+        { "top_solid_layers",       4 },
+        { "bottom_solid_layers",    4 }
+    });
+    // The painted facets of the lower half of the sphere are projected to the bottom surfaces,
+    // the painted facets of the upper half are projected to the top surfaces.
+    Print print;
+    Model model;
+    Test::init_print({ make_sphere(10., PI / 24.) }, print, model, config);
+    paint_bands(model, { { 4., 7. }, { 13., 16. } });
+    print.apply(model, config);
+    print.process();
+
+    // Repaint a few layers: move a band by less than the number of top solid layers, extend a band below its bottom surface,
+    // then remove a band. The repainted object is segmented again reusing the segmentation of the previous run.
+    const std::vector<std::vector<std::pair<double, double>>> repaints {
+        { { 4., 7. }, { 14., 17. } },
+        { { 2., 7. }, { 14., 17. } },
+        { { 2., 7. } }
+    };
+    // Heights far enough from the repainted band, so that the layers there shall be reused.
+    const std::vector<std::pair<double, double>> unchanged {
+        { 0., 10. },
+        { 9., 20. },
+        { 0., 10. }
+    };
+    for (size_t repaint_idx = 0; repaint_idx < repaints.size(); ++ repaint_idx) {
+        paint_bands(model, repaints[repaint_idx]);
+        print.apply(model, config);
+        print.process();
+
+        const PrintObject        &object         = *print.objects().front();
+        const std::vector<size_t> updated_layers = print.mm_segmentation_cache().updated_layers(object);
+        INFO("Repaint " << repaint_idx);
+        // Only the layers around the repainted band are segmented again.
+        REQUIRE(! updated_layers.empty());
+        REQUIRE(updated_layers.size() < object.layer_count());
+        for (size_t layer_idx : updated_layers) {
+            INFO("Layer " << layer_idx);
+            const double print_z = object.get_layer(int(layer_idx))->print_z;
+            CHECK((print_z < unchanged[repaint_idx].first || print_z > unchanged[repaint_idx].second));
+        }
+
+        Model model_fresh = model;
+        Print print_fresh;
+        print_fresh.apply(model_fresh, config);
+        print_fresh.process();
+        std::vector<std::vector<ExPolygons>> slices       = region_slices(print);
+        std::vector<std::vector<ExPolygons>> slices_fresh = region_slices(print_fresh);
+        REQUIRE(slices.size() == slices_fresh.size());
+        for (size_t layer_idx = 0; layer_idx < slices.size(); ++ layer_idx) {
+            INFO("Layer " << layer_idx);
+            CHECK(slices[layer_idx] == slices_fresh[layer_idx]);
+        }
+    }
+}
@@ -628,3 +628,88 @@ SCENARIO("Seam alignment", "[Perimeters]")
         test(Slic3r::Test::TestMesh::small_dorito);
     }
 }
+
+TEST_CASE("Perimeters regenerated after a region config change match a clean slice", "[Perimeters]")
+{
+    auto config = Slic3r::DynamicPrintConfig::full_print_config_with({
+        { "layer_height",       0.2 },
+        { "first_layer_height", 0.2 },
+        { "fill_density",       "20%" }
+    });
+    // Each layer range gets its own region.
+    auto set_range_perimeters = [](Model &model, int lower_perimeters, int upper_perimeters) {
+        ModelObject &object = *model.objects.front();
+        for (auto [range, perimeters] : { std::make_pair(t_layer_height_range{ 0., 10. }, lower_perimeters), std::make_pair(t_layer_height_range{ 10., 20. }, upper_perimeters) }) {
+            ModelConfig &range_config = object.layer_config_ranges[range];
+            range_config.set("layer_height", 0.2);
+            range_config.set("perimeters", perimeters);
+        }
+    };
+    auto perimeters_and_fills = [](const Print &print) {
+        std::vector<std::vector<Polylines>> out;
+        for (const Layer *layer : print.objects().front()->layers()) {
+            std::vector<Polylines> &regions = out.emplace_back();
+            for (const LayerRegion *layerm : layer->regions()) {
+                Polylines &polylines = regions.emplace_back();
+                layerm->perimeters().collect_polylines(polylines);
+                layerm->fills().collect_polylines(polylines);
+                for (const ExPolygon &expolygon : layerm->fill_expolygons())
+                    polylines.emplace_back(expolygon.contour.split_at_first_point());
+            }
+        }
+        return out;
+    };
+
+    Print print;
+    Model model;
+    Test::init_print({ Test::TestMesh::cube_20x20x20 }, print, model, config);
+    set_range_perimeters(model, 2, 3);
+    print.apply(model, config);
+    print.process();
+
+    auto perimeters = [](const Layer &layer) {
+        Polylines out;
+        for (const LayerRegion *layerm : layer.regions())
+            layerm->perimeters().collect_polylines(out);
+        return out;
+    };
+    std::vector<Polylines> perimeters_before;
+    for (const Layer *layer : print.objects().front()->layers())
+        perimeters_before.emplace_back(perimeters(*layer));
+
+    // Change the perimeters of the upper region only, the layers of the lower region keep their perimeters.
+    set_range_perimeters(model, 2, 5);
+    print.apply(model, config);
+    print.process();
+
+    const PrintObject          &object         = *print.objects().front();
+    const std::vector<uint8_t> &updated_layers = object.perimeters_updated_layers();
+    REQUIRE(updated_layers.size() == object.layer_count());
+    REQUIRE(perimeters_before.size() == object.layer_count());
+    for (size_t layer_idx = 0; layer_idx < object.layer_count(); ++ layer_idx) {
+        INFO("Layer " << layer_idx);
+        const Layer &layer = *object.get_layer(int(layer_idx));
+        if (layer.slice_z < 10.) {
+            // Layers of the lower region were not processed, they keep their perimeters.
+            CHECK(! updated_layers[layer_idx]);
+            CHECK(perimeters(layer) == perimeters_before[layer_idx]);
+        } else {
+            // Only the layers of the upper region were rebuilt with more perimeters.
+            CHECK(updated_layers[layer_idx]);
+            CHECK(perimeters(layer).size() > perimeters_before[layer_idx].size());
+        }
+    }
+
+    Model model_clean = model;
+    Print print_clean;
+    print_clean.apply(model_clean, config);
+    print_clean.process();
+
+    std::vector<std::vector<Polylines>> layers       = perimeters_and_fills(print);
+    std::vector<std::vector<Polylines>> layers_clean = perimeters_and_fills(print_clean);
+    REQUIRE(layers.size() == layers_clean.size());
+    for (size_t layer_idx = 0; layer_idx < layers.size(); ++ layer_idx) {
+        INFO("Layer " << layer_idx);
+        CHECK(layers[layer_idx] == layers_clean[layer_idx]);
+    }
+}
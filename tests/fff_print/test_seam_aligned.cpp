@@ -1,6 +1,7 @@
 #include <libslic3r/Point.hpp>
 #include <catch2/catch.hpp>
 #include <libslic3r/GCode/SeamAligned.hpp>
+#include <libslic3r/Geometry.hpp>
 #include "test_data.hpp"
 #include <fstream>
 
@@ -162,3 +163,25 @@ TEST_CASE_METHOD(Test::SeamsFixture, "Calculate visibility", "[Seams][SeamAligne
         }
     }
 }
+
+TEST_CASE_METHOD(Test::SeamsFixture, "Visibility cache", "[Seams][SeamAligned][Integration]") {
+    Slic3r::ModelInfo::VisibilityCache cache;
+    const std::shared_ptr<const Slic3r::ModelInfo::Visibility> first{
+        cache.get(transformation, volumes, params.visibility, [](){})};
+    CHECK(cache.get(transformation, volumes, params.visibility, [](){}) == first);
+    CHECK(first->mesh_samples_visibility == visibility.mesh_samples_visibility);
+
+    const Transform3d moved{Slic3r::Geometry::translation_transform(Vec3d{1.0, 0.0, 0.0}) * transformation};
+    CHECK(cache.get(moved, volumes, params.visibility, [](){}) != first);
+
+    Slic3r::ModelInfo::Visibility::Params other_params{params.visibility};
+    other_params.sqr_rays_per_sample_point += 1;
+    CHECK(cache.get(transformation, volumes, other_params, [](){}) != first);
+
+    // Visibility used since the last release is kept, the rest is released.
+    cache.release_unused();
+    CHECK(cache.get(transformation, volumes, params.visibility, [](){}) == first);
+    cache.release_unused();
+    cache.release_unused();
+    CHECK(cache.get(transformation, volumes, params.visibility, [](){}) != first);
+}
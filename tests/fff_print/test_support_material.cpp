@@ -1,7 +1,17 @@
 #include <catch2/catch.hpp>
 
+#include <atomic>
+#include <set>
+
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
+#include <oneapi/tbb/task_arena.h>
+
 #include "libslic3r/GCodeReader.hpp"
 #include "libslic3r/Layer.hpp"
+#include "libslic3r/Support/RadiusLayerPolygonCache.hpp"
+#include "libslic3r/Support/TreeModelVolumes.hpp"
+#include "libslic3r/SupportSpotsGenerator.hpp"
 
 #include "test_data.hpp" // get access to init_print, etc
 
@@ -495,3 +505,262 @@ Old Perl tests, which were disabled by Vojtech at the time of first Support Gene
 }
 
 */
+
+TEST_CASE("SupportMaterial: tree support caches are reused only for unchanged inputs", "[SupportMaterial]")
+{
+    DynamicPrintConfig config = DynamicPrintConfig::full_print_config_with({
+        { "support_material",                   1 },
+        { "support_material_style",             "tree" },
+        { "support_material_interface_layers",  2 }
+    });
+    Model model;
+    Print print;
+    Test::init_print({ TestMesh::overhang }, print, model, config);
+    print.process();
+
+    auto cache_key = [](Print &print) {
+        const FFFTreeSupport::TreeModelVolumesPtr &volumes = print.get_object(0)->tree_model_volumes_cache();
+        REQUIRE(volumes);
+        return volumes->cache_key();
+    };
+    auto support_polylines = [](const Print &print) {
+        Polylines out;
+        for (const SupportLayer *support_layer : print.objects().front()->support_layers())
+            support_layer->support_fills.collect_polylines(out);
+        return out;
+    };
+    // Support generated by a new print with no cache kept from a previous run.
+    auto fresh_support_polylines = [&support_polylines](const Model &model, const DynamicPrintConfig &config) {
+        Print fresh;
+        fresh.apply(model, config);
+        fresh.set_status_silent();
+        fresh.process();
+        return support_polylines(fresh);
+    };
+    size_t key = cache_key(print);
+
+    SECTION("Changed interface layers reuse the caches") {
+        config.set_deserialize_strict({ { "support_material_interface_layers", 3 } });
+        print.apply(model, config);
+        print.process();
+        REQUIRE(cache_key(print) == key);
+        REQUIRE(support_polylines(print) == fresh_support_polylines(model, config));
+    }
+    SECTION("Changed XY distance invalidates the caches") {
+        config.set_deserialize_strict({ { "support_material_xy_spacing", "150%" } });
+        print.apply(model, config);
+        print.process();
+        REQUIRE(cache_key(print) != key);
+        REQUIRE(support_polylines(print) == fresh_support_polylines(model, config));
+    }
+    SECTION("Changed mesh invalidates the caches") {
+        model.objects.front()->scale(1.2);
+        model.objects.front()->ensure_on_bed();
+        print.apply(model, config);
+        print.process();
+        REQUIRE(cache_key(print) != key);
+        REQUIRE(support_polylines(print) == fresh_support_polylines(model, config));
+    }
+}
+
+TEST_CASE("SupportMaterial: tree support polygon cache is filled and read concurrently", "[SupportMaterial]")
+{
+    using Cache      = FFFTreeSupport::RadiusLayerPolygonCache;
+    using LayerIndex = FFFTreeSupport::LayerIndex;
+    using Items      = std::vector<std::pair<FFFTreeSupport::RadiusLayerPair, Polygons>>;
+    // Polygons identifying the radius and layer they are cached for.
+    auto make_polygons = [](coord_t radius, LayerIndex layer_idx) {
+        return Polygons{ Polygon{ { 0, layer_idx }, { radius + 1, layer_idx }, { radius + 1, layer_idx + 1 } } };
+    };
+    // The layers span several segments of the cache.
+    const LayerIndex        num_layers = 1000;
+    const std::vector<coord_t> radii { 0, 300, 100, 200, 50 };
+    const size_t            num_items  = size_t(num_layers) * radii.size();
+    Cache                   cache;
+    std::atomic<bool>       lookups_ok { true };
+
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_items, 8), [&](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++ i) {
+            // Insert the layers in a scattered order, the radii of a layer out of order.
+            size_t     item      = (i * 7919) % num_items;
+            LayerIndex layer_idx = LayerIndex(item / radii.size());
+            coord_t    radius    = radii[item % radii.size()];
+            cache.insert(Items{ { { radius, layer_idx }, make_polygons(radius, layer_idx) } });
+            // Look up items possibly being inserted by other threads right now.
+            for (LayerIndex l : { layer_idx, std::max(layer_idx - 1, 0), std::min(layer_idx + 1, num_layers - 1) })
+                for (coord_t r : radii)
+                    if (auto area = cache.getArea({ r, l }); area && area->get() != make_polygons(r, l))
+                        lookups_ok = false;
+            if (! cache.getArea({ radius, layer_idx }))
+                lookups_ok = false;
+        }
+    });
+    REQUIRE(lookups_ok);
+
+    auto items = cache.sorted();
+    REQUIRE(items.size() == num_items);
+    for (size_t i = 0; i < items.size(); ++ i) {
+        LayerIndex layer_idx = LayerIndex(i / radii.size());
+        coord_t    radius    = *std::next(std::set<coord_t>(radii.begin(), radii.end()).begin(), i % radii.size());
+        REQUIRE(items[i].first == std::make_pair(radius, layer_idx));
+        REQUIRE(items[i].second.get() == make_polygons(radius, layer_idx));
+    }
+    REQUIRE(cache.getMaxCalculatedLayer(200) == num_layers - 1);
+    REQUIRE(cache.get_lower_bound_area({ 250, 10 })->first == 200);
+
+    // Inserting a cached radius and layer again keeps the polygons already cached.
+    const Polygons *cached = &cache.getArea({ 100, 10 })->get();
+    cache.insert(Items{ { { 100, 10 }, make_polygons(999, 999) } });
+    REQUIRE(&cache.getArea({ 100, 10 })->get() == cached);
+    REQUIRE(*cached == make_polygons(100, 10));
+
+    // Layer with no radius 0 item.
+    cache.insert(Items{ { { 50, num_layers }, make_polygons(50, num_layers) } });
+    cache.clear_all_but_radius0();
+    REQUIRE(cache.getArea({ 0, 500 }));
+    REQUIRE(! cache.getArea({ 100, 500 }));
+    REQUIRE(! cache.getArea({ 50, num_layers }));
+}
+
+// Process the same print in the default task arena and in a single threaded arena.
+static void process_print_parallel_and_serial(const TriangleMesh &mesh, const DynamicPrintConfig &config, Print &print_parallel, Print &print_serial)
+{
+    Test::init_and_process_print({ mesh }, print_parallel, config);
+    tbb::task_arena serial_arena(1);
+    serial_arena.execute([&print_serial, &mesh, &config]() {
+        Test::init_and_process_print({ mesh }, print_serial, config);
+    });
+}
+
+// Two overhangs far apart in a single object.
+static TriangleMesh two_separate_overhangs()
+{
+    TriangleMesh mesh = Test::mesh(TestMesh::overhang);
+    TriangleMesh mesh2 = mesh;
+    mesh2.translate(50.f, 0.f, 0.f);
+    mesh.merge(mesh2);
+    return mesh;
+}
+
+static Polylines support_polylines(const Print &print)
+{
+    Polylines out;
+    for (const SupportLayer *support_layer : print.objects().front()->support_layers())
+        support_layer->support_fills.collect_polylines(out);
+    return out;
+}
+
+TEST_CASE("SupportMaterial: tree support merged in parallel matches a serial run", "[SupportMaterial]")
+{
+    // The influence areas of the two overhangs fall into different clusters when being merged.
+    // No support interfaces, so that the support tips are generated in the same order by the parallel tasks.
+    DynamicPrintConfig config = DynamicPrintConfig::full_print_config_with({
+        { "support_material",                   1 },
+        { "support_material_style",             "tree" },
+        { "support_material_interface_layers",  0 }
+    });
+    Print print_parallel;
+    Print print_serial;
+    process_print_parallel_and_serial(two_separate_overhangs(), config, print_parallel, print_serial);
+    Polylines supports = support_polylines(print_parallel);
+    REQUIRE(! supports.empty());
+    REQUIRE(supports == support_polylines(print_serial));
+}
+
+TEST_CASE("SupportMaterial: organic branches meshed and sliced in parallel match a serial run", "[SupportMaterial]")
+{
+    DynamicPrintConfig config = DynamicPrintConfig::full_print_config_with({
+        { "support_material",                   1 },
+        { "support_material_style",             "organic" },
+        { "support_material_interface_layers",  0 }
+    });
+    Print print_parallel;
+    Print print_serial;
+    process_print_parallel_and_serial(two_separate_overhangs(), config, print_parallel, print_serial);
+    auto layers_parallel = print_parallel.objects().front()->support_layers();
+    auto layers_serial   = print_serial.objects().front()->support_layers();
+    REQUIRE(layers_parallel.size() == layers_serial.size());
+    for (size_t i = 0; i < layers_parallel.size(); ++ i) {
+        CHECK(layers_parallel[i]->print_z == Approx(layers_serial[i]->print_z));
+        CHECK(layers_parallel[i]->support_islands == layers_serial[i]->support_islands);
+    }
+    Polylines supports = support_polylines(print_parallel);
+    REQUIRE(! supports.empty());
+    REQUIRE(supports == support_polylines(print_serial));
+}
+
+static void check_same_support_spots(SupportSpotsGenerator::SupportPoints &points, SupportSpotsGenerator::PartialObjects &objects,
+                                    SupportSpotsGenerator::SupportPoints &points_expected, SupportSpotsGenerator::PartialObjects &objects_expected)
+{
+    REQUIRE(points.size() == points_expected.size());
+    for (size_t i = 0; i < points.size(); ++ i) {
+        CHECK(points[i].cause == points_expected[i].cause);
+        CHECK(points[i].position == points_expected[i].position);
+    }
+    REQUIRE(objects.size() == objects_expected.size());
+    for (size_t i = 0; i < objects.size(); ++ i) {
+        CHECK(objects[i].centroid == objects_expected[i].centroid);
+        CHECK(objects[i].volume == objects_expected[i].volume);
+        CHECK(objects[i].connected_to_bed == objects_expected[i].connected_to_bed);
+    }
+    CHECK(SupportSpotsGenerator::gather_issues(points, objects) == SupportSpotsGenerator::gather_issues(points_expected, objects_expected));
+}
+
+TEST_CASE("SupportMaterial: support spots searched in parallel match a serial search", "[SupportMaterial]")
+{
+    // No supports, the overhang of the object is printed in the air and needs to be reported.
+    Print print;
+    Test::init_and_process_print({ TestMesh::overhang }, print, { { "support_material", 0 } });
+    const PrintObject *object = print.objects().front();
+    const PrintConfig &print_config = print.config();
+    SupportSpotsGenerator::Params params{ print_config.filament_type.values, float(print_config.perimeter_acceleration.value),
+                                          object->config().raft_layers.value, object->config().brim_type.value,
+                                          float(object->config().brim_width.value) };
+
+    auto [points_parallel, objects_parallel] = SupportSpotsGenerator::full_search(object, []() {}, params);
+    SupportSpotsGenerator::SupportPoints  points_serial;
+    SupportSpotsGenerator::PartialObjects objects_serial;
+    tbb::task_arena serial_arena(1);
+    serial_arena.execute([&]() {
+        std::tie(points_serial, objects_serial) = SupportSpotsGenerator::full_search(object, []() {}, params);
+    });
+
+    REQUIRE(! points_parallel.empty());
+    check_same_support_spots(points_parallel, objects_parallel, points_serial, objects_serial);
+}
+
+TEST_CASE("SupportMaterial: support spots of objects searched in parallel match a serial run", "[SupportMaterial]")
+{
+    DynamicPrintConfig config = DynamicPrintConfig::full_print_config_with({ { "support_material", 0 } });
+    Print print_parallel;
+    Model model;
+    Test::init_print({ TestMesh::overhang, TestMesh::overhang }, print_parallel, model, config);
+    // A rotated instance makes another PrintObject sharing the regions and the support spots of the first ModelObject.
+    ModelInstance *rotated = model.objects.front()->add_instance(*model.objects.front()->instances.front());
+    rotated->set_rotation(Vec3d(0., 0., 0.5 * PI));
+    rotated->set_offset(rotated->get_offset() + Vec3d(0., 60., 0.));
+    print_parallel.apply(model, config);
+    print_parallel.process();
+
+    Print print_serial;
+    print_serial.apply(model, config);
+    tbb::task_arena serial_arena(1);
+    serial_arena.execute([&print_serial]() { print_serial.process(); });
+
+    REQUIRE(print_parallel.objects().size() == 3);
+    REQUIRE(print_serial.objects().size() == print_parallel.objects().size());
+    std::set<const PrintObjectRegions*> shared_regions;
+    for (size_t idx = 0; idx < print_parallel.objects().size(); ++ idx) {
+        INFO("PrintObject " << idx);
+        const PrintObjectRegions *regions        = print_parallel.objects()[idx]->shared_regions();
+        const PrintObjectRegions *regions_serial = print_serial.objects()[idx]->shared_regions();
+        shared_regions.insert(regions);
+        REQUIRE(regions->generated_support_points.has_value());
+        REQUIRE(regions_serial->generated_support_points.has_value());
+        PrintObjectRegions::GeneratedSupportPoints spots        = *regions->generated_support_points;
+        PrintObjectRegions::GeneratedSupportPoints spots_serial = *regions_serial->generated_support_points;
+        CHECK(spots.object_transform.isApprox(spots_serial.object_transform));
+        check_same_support_spots(spots.support_points, spots.partial_objects, spots_serial.support_points, spots_serial.partial_objects);
+    }
+    CHECK(shared_regions.size() == 2);
+}
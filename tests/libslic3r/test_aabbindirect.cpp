@@ -61,6 +61,57 @@ TEST_CASE("Building a tree over a box, ray caster and closest query", "[AABBIndi
     REQUIRE(closest_point.z() == Approx(1.));
 }
 
+TEST_CASE("Ray packet casting matches single ray casting", "[AABBIndirect]")
+{
+    TriangleMesh tmesh = make_sphere(1., 2. * PI / 20.);
+    tmesh.merge(make_cube(1., 1., 1.));
+
+    auto tree = AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set(tmesh.its.vertices, tmesh.its.indices);
+    REQUIRE(! tree.empty());
+
+    constexpr size_t PacketSize = AABBTreeIndirect::RayPacketSize;
+    // Rays shot from a common origin into all directions, the last packet is partial.
+    const size_t num_rays = 5 * PacketSize + 3;
+    std::vector<Vec3d> dirs;
+    for (size_t i = 0; i < num_rays; ++ i) {
+        double z   = 1. - 2. * (double(i) + 0.5) / double(num_rays);
+        double phi = double(i) * 2.399963;
+        double r   = std::sqrt(1. - z * z);
+        dirs.emplace_back(r * std::cos(phi), r * std::sin(phi), z);
+    }
+
+    for (const Vec3d &origin : { Vec3d(0.1, 0.2, 0.3), Vec3d(-3., 0.5, 0.5), Vec3d(0.5, 0.5, 5.) }) {
+        size_t num_hits = 0;
+        for (size_t begin = 0; begin < num_rays; begin += PacketSize) {
+            const size_t                          n = std::min(PacketSize, num_rays - begin);
+            std::array<Vec3d, PacketSize>         packet_origins;
+            std::array<Vec3d, PacketSize>         packet_dirs;
+            std::array<igl::Hit, PacketSize>      packet_hits;
+            for (size_t i = 0; i < n; ++ i) {
+                packet_origins[i] = origin;
+                packet_dirs[i]    = dirs[begin + i];
+            }
+            bool any_hit = AABBTreeIndirect::intersect_ray_packet_first_hit(
+                tmesh.its.vertices, tmesh.its.indices, tree, packet_origins, packet_dirs, n, packet_hits);
+            bool any_hit_single = false;
+            for (size_t i = 0; i < n; ++ i) {
+                igl::Hit hit;
+                bool     intersected = AABBTreeIndirect::intersect_ray_first_hit(
+                    tmesh.its.vertices, tmesh.its.indices, tree, origin, dirs[begin + i], hit);
+                REQUIRE(intersected == (packet_hits[i].id != -1));
+                if (intersected) {
+                    REQUIRE(packet_hits[i].id == hit.id);
+                    REQUIRE(packet_hits[i].t == Approx(hit.t));
+                    any_hit_single = true;
+                    ++ num_hits;
+                }
+            }
+            REQUIRE(any_hit == any_hit_single);
+        }
+        REQUIRE(num_hits > 0);
+    }
+}
+
 TEST_CASE("Creating a several 2d lines, testing closest point query", "[AABBIndirect]")
 {
     std::vector<Linef> lines { };
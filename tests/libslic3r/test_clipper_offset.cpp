@@ -212,3 +212,41 @@ SCENARIO("Constant offset", "[ClipperUtils]") {
 		}
 	}
 }
+
+TEST_CASE("Vectorized offset kernels match the scalar kernels", "[ClipperUtils]") {
+	// Wavy polygon with segments of varying lengths and directions, including a zero length segment.
+	Polygon wavy;
+	for (int i = 0; i < 257; ++ i) {
+		double a = 2. * M_PI * i / 257.;
+		double r = scale_(10.) + scale_(2.) * std::sin(7. * a) + scale_(0.3) * std::cos(31. * a);
+		wavy.points.emplace_back(coord_t(r * std::cos(a)), coord_t(r * std::sin(a)));
+	}
+	wavy.points.insert(wavy.points.begin() + 100, wavy.points[100]);
+	Polygon wavy_cw = wavy;
+	wavy_cw.reverse();
+
+	auto offset_all = [](const Polygon &polygon, ClipperLib::OffsetKernels kernels) {
+		std::vector<ClipperLib::Paths> out;
+		for (ClipperLib::JoinType join_type : { ClipperLib::jtRound, ClipperLib::jtMiter, ClipperLib::jtSquare })
+			for (ClipperLib::EndType end_type : { ClipperLib::etClosedPolygon, ClipperLib::etClosedLine, ClipperLib::etOpenRound, ClipperLib::etOpenButt })
+				for (double delta : { scale_(0.45), - scale_(0.45), scale_(3.), - scale_(3.) }) {
+					ClipperLib::ClipperOffset co;
+					REQUIRE(co.SetKernels(kernels));
+					co.ArcTolerance = scale_(0.01);
+					co.AddPath(polygon.points, join_type, end_type);
+					out.emplace_back();
+					co.Execute(out.back(), delta);
+				}
+		return out;
+	};
+
+	std::vector<ClipperLib::Paths> scalar    = offset_all(wavy, ClipperLib::OffsetKernels::Scalar);
+	std::vector<ClipperLib::Paths> scalar_cw = offset_all(wavy_cw, ClipperLib::OffsetKernels::Scalar);
+	for (ClipperLib::OffsetKernels kernels : { ClipperLib::OffsetKernels::SSE2, ClipperLib::OffsetKernels::AVX })
+		if (ClipperLib::ClipperOffset().SetKernels(kernels)) {
+			DYNAMIC_SECTION("Kernels " << int(kernels)) {
+				REQUIRE(offset_all(wavy, kernels) == scalar);
+				REQUIRE(offset_all(wavy_cw, kernels) == scalar_cw);
+			}
+		}
+}
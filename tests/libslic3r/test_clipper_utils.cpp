@@ -382,3 +382,77 @@ TEST_CASE("Traversing Clipper PolyTree", "[ClipperUtils]") {
         REQUIRE(count_polys(output) == reference.size());
     }
 }
+
+TEST_CASE("Reused thread engines match fresh engines", "[ClipperUtils]") {
+    Polygons subjects;
+    for (coord_t i = 0; i < 20; ++ i)
+        subjects.push_back({ { 100 * i, 0 }, { 100 * i + 150, 0 }, { 100 * i + 150, 150 }, { 100 * i, 150 } });
+    Polygons clip { { { 0, 50 }, { 3000, 50 }, { 3000, 100 }, { 0, 100 } } };
+
+    SECTION("Sequence of boolean operations") {
+        for (const Polygon &subject : subjects) {
+            ClipperLib::Clipper clipper;
+            clipper.AddPath(subject.points, ClipperLib::ptSubject, true);
+            clipper.AddPaths(ClipperUtils::PolygonsProvider(clip), ClipperLib::ptClip, true);
+            ClipperLib::Paths out;
+            clipper.Execute(ClipperLib::ctDifference, out, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+            REQUIRE(diff(Polygons{ subject }, clip) == to_polygons(std::move(out)));
+        }
+    }
+    SECTION("Sequence of offsets") {
+        for (const Polygon &subject : subjects)
+            for (float delta : { 20.f, -20.f }) {
+                ClipperLib::ClipperOffset co;
+                co.ArcTolerance = 0.25;
+                co.ShortestEdgeLength = std::abs(delta * ClipperOffsetShortestEdgeFactor);
+                co.AddPath(subject.points, ClipperLib::jtRound, ClipperLib::etClosedPolygon);
+                ClipperLib::Paths out;
+                co.Execute(out, delta);
+                REQUIRE(offset(subject, delta, ClipperLib::jtRound, 0.25) == to_polygons(std::move(out)));
+            }
+    }
+    SECTION("Nested use of the thread engine") {
+        ClipperUtils::ClipperEngine engine;
+        engine->AddPaths(ClipperUtils::PolygonsProvider(Polygons{ subjects.front() }), ClipperLib::ptSubject, true);
+        // Boolean operation executed while the engine of this thread is leased.
+        Polygons inner = diff(Polygons{ subjects[1] }, clip);
+        ClipperLib::Paths out;
+        engine->Execute(ClipperLib::ctUnion, out, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+        REQUIRE(to_polygons(std::move(out)) == union_(Polygons{ subjects.front() }));
+        REQUIRE(inner == diff(Polygons{ subjects[1] }, clip));
+    }
+}
+
+TEST_CASE("Batched clipping matches one by one clipping", "[ClipperUtils]") {
+    std::vector<Polygons> subjects;
+    for (coord_t i = 0; i < 20; ++ i)
+        subjects.push_back({ { { 100 * i, 0 }, { 100 * i + 150, 0 }, { 100 * i + 150, 150 }, { 100 * i, 150 } } });
+    Polygons clip { { { 0, 50 }, { 3000, 50 }, { 3000, 100 }, { 0, 100 } } };
+    std::vector<const Polygons*> subject_ptrs;
+    std::vector<const Polygons*> clip_ptrs;
+    for (const Polygons &subject : subjects) {
+        subject_ptrs.emplace_back(&subject);
+        clip_ptrs.emplace_back(&clip);
+    }
+    // The last subject is not clipped at all.
+    clip_ptrs.back() = nullptr;
+
+    SECTION("Difference with a clip per subject") {
+        std::vector<Polygons> batched = diff_batch(subject_ptrs, clip_ptrs);
+        REQUIRE(batched.size() == subjects.size());
+        for (size_t i = 0; i < subjects.size(); ++ i)
+            REQUIRE(batched[i] == diff(subjects[i], clip_ptrs[i] ? *clip_ptrs[i] : Polygons{}));
+    }
+    SECTION("Intersection with a shared clip and safety offset") {
+        std::vector<ExPolygons> batched = intersection_ex_batch(subject_ptrs, clip, ApplySafetyOffset::Yes);
+        REQUIRE(batched.size() == subjects.size());
+        for (size_t i = 0; i < subjects.size(); ++ i)
+            REQUIRE(batched[i] == intersection_ex(subjects[i], clip, ApplySafetyOffset::Yes));
+    }
+    SECTION("Missing subjects give empty results") {
+        subject_ptrs[1] = nullptr;
+        std::vector<ExPolygons> batched = diff_ex_batch(subject_ptrs, clip);
+        REQUIRE(batched[1].empty());
+        REQUIRE(batched[0] == diff_ex(subjects[0], clip));
+    }
+}
@@ -436,6 +436,41 @@ SCENARIO("Path chaining", "[Geometry]") {
 			REQUIRE(connection_length < 85206000.);
 		}
 	}
+	GIVEN("Many short polylines on a grid") {
+		// More polylines than chain_polylines() improves by the exhaustive exchanges, exercising the bounded 2-opt.
+		Polylines polylines;
+		for (coord_t i = 0; i < 60; ++ i)
+			for (coord_t j = 0; j < 30; ++ j) {
+				coord_t x = scaled<coord_t>(2. * ((i * 37) % 60));
+				coord_t y = scaled<coord_t>(4. * ((j * 11) % 30));
+				polylines.push_back(((i + j) & 1) ? Polyline{ { x, y }, { x, y + scaled<coord_t>(1.) } } : Polyline{ { x, y + scaled<coord_t>(1.) }, { x, y } });
+			}
+		auto connection_length = [](const Polylines &pls) {
+			double len = 0.;
+			for (size_t i = 1; i < pls.size(); ++ i)
+				len += (pls[i].first_point() - pls[i - 1].last_point()).cast<double>().norm();
+			return len;
+		};
+		Polylines chained = chain_polylines(polylines);
+		THEN("All polylines are chained exactly once") {
+			// End points of each polyline, sorted by x then y.
+			auto end_points = [](const Polylines &pls) {
+				std::vector<std::array<coord_t, 4>> out;
+				for (const Polyline &pl : pls) {
+					Point a = pl.first_point(), b = pl.last_point();
+					if (std::make_pair(b.x(), b.y()) < std::make_pair(a.x(), a.y()))
+						std::swap(a, b);
+					out.push_back({ a.x(), a.y(), b.x(), b.y() });
+				}
+				std::sort(out.begin(), out.end());
+				return out;
+			};
+			REQUIRE(end_points(chained) == end_points(polylines));
+		}
+		THEN("Travels are much shorter than in the input order") {
+			REQUIRE(connection_length(chained) < 0.25 * connection_length(polylines));
+		}
+	}
 	GIVEN("Loop pieces") {
 		Point a { 2185796, 19058485 };
 		Point b { 3957902, 18149382 };
@@ -19,3 +19,81 @@ TEST_CASE("Hollow two overlapping spheres") {
     sphere1.WriteOBJFile("twospheres.obj");
 }
 
+
+TEST_CASE("Interior generated from a reused grid") {
+    using namespace Slic3r;
+
+    TriangleMesh sphere = make_sphere(10., 2 * PI / 20.);
+
+    auto csgmesh = std::array{csg::CSGPart{&sphere.its}};
+
+    sla::HollowingConfig hc;
+    double voxel_scale = sla::get_voxel_scale(sphere.volume(), hc);
+    VoxelGridPtr grid = sla::generate_interior_grid(range(csgmesh), voxel_scale);
+    REQUIRE(grid);
+
+    for (double thickness : {2., 3.}) {
+        hc.min_thickness = thickness;
+
+        sla::InteriorPtr interior     = sla::generate_interior(*grid, hc);
+        sla::InteriorPtr ref_interior = sla::generate_interior(sphere.its, hc);
+        REQUIRE(interior);
+        REQUIRE(ref_interior);
+
+        REQUIRE(its_volume(sla::get_mesh(*interior)) ==
+                Approx(its_volume(sla::get_mesh(*ref_interior))));
+    }
+}
+
+TEST_CASE("Voxelizing a csg mesh with cached part grids") {
+    using namespace Slic3r;
+
+    TriangleMesh sphere = make_sphere(10., 2 * PI / 20.);
+    TriangleMesh hole   = make_cylinder(2., 30.);
+
+    std::vector<csg::CSGPart> csgmesh;
+    csgmesh.emplace_back(&sphere.its);
+    csgmesh.emplace_back(&hole.its, csg::CSGType::Difference,
+                         Transform3f{Eigen::Translation3f{0.f, 0.f, -15.f}});
+    csgmesh.emplace_back(&hole.its, csg::CSGType::Difference,
+                         Transform3f{Eigen::Translation3f{5.f, 0.f, -15.f}});
+
+    auto params = csg::VoxelizeParams{}.voxel_scale(2.f);
+    csg::VoxelGridCache cache;
+
+    auto check_volume = [&] {
+        VoxelGridPtr grid     = csg::voxelize_csgmesh(range(csgmesh), params, cache);
+        VoxelGridPtr ref_grid = csg::voxelize_csgmesh(range(csgmesh), params);
+        REQUIRE(grid);
+        REQUIRE(ref_grid);
+
+        REQUIRE(its_volume(grid_to_mesh(*grid)) ==
+                Approx(its_volume(grid_to_mesh(*ref_grid))));
+    };
+
+    check_volume();
+
+    SECTION("after moving the last hole") {
+        csgmesh.back().trafo = Transform3f{Eigen::Translation3f{-5.f, 0.f, -15.f}};
+        check_volume();
+        csgmesh.back().trafo = Transform3f{Eigen::Translation3f{0.f, 5.f, -15.f}};
+        check_volume();
+    }
+
+    SECTION("after changing the first part, then the last hole") {
+        // Moving the last hole stores the partial result before it, which
+        // becomes stale once the first part changes.
+        csgmesh.back().trafo = Transform3f{Eigen::Translation3f{-5.f, 0.f, -15.f}};
+        check_volume();
+        csgmesh.front().trafo = Transform3f{Eigen::Scaling(1.2f)};
+        check_volume();
+        csgmesh.back().trafo = Transform3f{Eigen::Translation3f{0.f, 5.f, -15.f}};
+        check_volume();
+    }
+
+    SECTION("after adding a hole") {
+        csgmesh.emplace_back(&hole.its, csg::CSGType::Difference,
+                             Transform3f{Eigen::Translation3f{0.f, -5.f, -15.f}});
+        check_volume();
+    }
+}
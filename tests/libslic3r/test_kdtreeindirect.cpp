@@ -85,6 +85,45 @@ TEST_CASE("Test kdtree query for a Box", "[KDTreeIndirect]")
     REQUIRE(call_count < pgrid.point_count());
 }
 
+TEST_CASE("Removed points are not found by kdtree queries", "[KDTreeIndirect]")
+{
+    std::vector<Vec2d> pts;
+    for (int i = 0; i < 50; ++ i)
+        for (int j = 0; j < 50; ++ j)
+            pts.emplace_back(i, j);
+
+    auto coordfn = [&pts] (size_t i, size_t D) { return pts[i](int(D)); };
+    KDTreeIndirect<2, double, decltype(coordfn)> tree{coordfn, pts.size()};
+
+    // Remove every point on the left half and every other point of the right half.
+    std::vector<bool> removed(pts.size(), false);
+    for (size_t i = 0; i < pts.size(); ++ i)
+        if (pts[i].x() < 25 || (i & 1) == 0) {
+            tree.remove(i);
+            removed[i] = true;
+        }
+
+    bool succ = true;
+    for (size_t i = 0; i < pts.size(); ++ i) {
+        REQUIRE(tree.removed(i) == removed[i]);
+        // Brute force distance to the closest point among the points left.
+        // Only the distances are compared, the grid has many equidistant points.
+        double dist = std::numeric_limits<double>::max();
+        for (size_t j = 0; j < pts.size(); ++ j)
+            if (! removed[j])
+                dist = std::min(dist, (pts[j] - pts[i]).squaredNorm());
+        size_t found = find_closest_point(tree, pts[i]);
+        succ = succ && found != KDTreeIndirect<2, double, decltype(coordfn)>::npos && ! removed[found] && 
+            std::abs((pts[found] - pts[i]).squaredNorm() - dist) < EPSILON;
+    }
+    REQUIRE(succ);
+
+    std::vector<size_t> out = find_nearby_points(tree, Vec2d{0., 0.}, Vec2d{49., 49.}, [](size_t) { return true; });
+    REQUIRE(out.size() == size_t(std::count(removed.begin(), removed.end(), false)));
+    for (size_t idx : out)
+        REQUIRE(! removed[idx]);
+}
+
 //TEST_CASE("Test kdtree query for a Sphere", "[KDTreeIndirect]") {
 //    auto vol = BoundingBox3Base<Vec3f>{{0.f, 0.f, 0.f}, {10.f, 10.f, 10.f}};
 
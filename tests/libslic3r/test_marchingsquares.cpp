@@ -309,6 +309,92 @@ TEST_CASE("Circle with hole in the middle", "[MarchingSquares]") {
     test_expolys(create_raster({1000, 1000}), circle_with_hole(25.), W2x2, "circle_with_hole");   
 }
 
+// Views of an AGG raster for the marching squares, read either by whole rows
+// or pixel by pixel
+struct RowReadRaster { const sla::RasterGrayscaleAA &rst; };
+struct PixelReadRaster { const sla::RasterGrayscaleAA &rst; };
+
+namespace marchsq {
+
+template<> struct _RasterTraits<PixelReadRaster> {
+    using ValueType = uint8_t;
+    
+    static uint8_t get(const PixelReadRaster &r, size_t row, size_t col)
+    {
+        return r.rst.read_pixel(col, row);
+    }
+    
+    static size_t rows(const PixelReadRaster &r) { return r.rst.resolution().height_px; }
+    static size_t cols(const PixelReadRaster &r) { return r.rst.resolution().width_px; }
+};
+
+template<> struct _RasterTraits<RowReadRaster> {
+    using ValueType = uint8_t;
+    
+    static uint8_t get(const RowReadRaster &r, size_t row, size_t col)
+    {
+        return r.rst.read_pixel(col, row);
+    }
+    
+    static const uint8_t *row(const RowReadRaster &r, size_t row)
+    {
+        return r.rst.row_pixels(row);
+    }
+    
+    static size_t rows(const RowReadRaster &r) { return r.rst.resolution().height_px; }
+    static size_t cols(const RowReadRaster &r) { return r.rst.resolution().width_px; }
+};
+
+} // namespace marchsq
+
+TEST_CASE("Row access and pixel access give the same rings", "[MarchingSquares]") {
+    auto rst = create_raster({500, 300}, 100., 60.);
+    for (const ExPolygon &expoly : circle_with_hole(20., {scaled(-20.), 0}))
+        rst.draw(expoly);
+    rst.draw(square_with_hole(30., {scaled(25.), 0}));
+    
+    for (long w : {2l, 3l, 4l, 8l}) {
+        std::vector<marchsq::Ring> rows_rings =
+            marchsq::execute(RowReadRaster{rst}, 128, {w, w});
+        std::vector<marchsq::Ring> px_rings =
+            marchsq::execute(PixelReadRaster{rst}, 128, {w, w});
+        
+        REQUIRE(!rows_rings.empty());
+        REQUIRE(rows_rings.size() == px_rings.size());
+        for (size_t i = 0; i < rows_rings.size(); ++i) {
+            REQUIRE(rows_rings[i].size() == px_rings[i].size());
+            for (size_t j = 0; j < rows_rings[i].size(); ++j) {
+                REQUIRE(rows_rings[i][j].r == px_rings[i][j].r);
+                REQUIRE(rows_rings[i][j].c == px_rings[i][j].c);
+            }
+        }
+    }
+}
+
+TEST_CASE("Tags from the corner lattice match the tags of the cells", "[MarchingSquares]") {
+    auto rst = create_raster({500, 300}, 100., 60.);
+    for (const ExPolygon &expoly : circle_with_hole(20., {scaled(-20.), 0}))
+        rst.draw(expoly);
+    rst.draw(square_with_hole(30., {scaled(25.), 0}));
+
+    auto check_tags = [](const auto &raster, const marchsq::Coord &window) {
+        using Grid = marchsq::__impl::Grid<std::decay_t<decltype(raster)>>;
+        Grid lattice_grid{raster, window, marchsq::Coord{1}};
+        Grid cell_grid{raster, window, marchsq::Coord{1}};
+        lattice_grid.tag_grid(nullptr, 128);
+        cell_grid.tag_cells(nullptr, 128);
+
+        REQUIRE(lattice_grid.tags() == cell_grid.tags());
+    };
+
+    for (const marchsq::Coord &w : {marchsq::Coord{2, 2}, marchsq::Coord{3, 3},
+                                    marchsq::Coord{4, 4}, marchsq::Coord{8, 8},
+                                    marchsq::Coord{2, 5}, marchsq::Coord{7, 3}}) {
+        check_tags(RowReadRaster{rst}, w);
+        check_tags(PixelReadRaster{rst}, w);
+    }
+}
+
 static void recreate_object_from_rasters(const std::string &objname, float lh) {
     TriangleMesh mesh = load_model(objname);
     
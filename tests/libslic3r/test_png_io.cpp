@@ -4,6 +4,7 @@
 
 #include <catch2/catch.hpp>
 
+#include <cstring>
 #include <numeric>
 
 #include "libslic3r/PNGReadWrite.hpp"
@@ -56,3 +57,72 @@ TEST_CASE("PNG read", "[PNG]") {
         REQUIRE(sum == rstsum);
     }
 }
+
+TEST_CASE("PNG of a frame deflated in chunks decodes to the original", "[PNG]") {
+    // Large enough to be deflated in several chunks in parallel.
+    sla::Resolution res{2000, 1500};
+    sla::RasterGrayscaleAA rst{res, sla::PixelDim{.05, .05}, {}, agg::gamma_power(1.)};
+
+    ExPolygon poly;
+    poly.contour.points = {{0, 0}, {scaled(90.), scaled(10.)}, {scaled(30.), scaled(70.)}};
+    rst.draw(poly);
+
+    for (int level : {0, 1, 6}) {
+        auto enc_rst = rst.encode(sla::PNGRasterEncoder{level});
+
+        png::ImageGreyscale img;
+        REQUIRE(png::decode_png({enc_rst.data(), enc_rst.size()}, img));
+        REQUIRE(img.rows == res.height_px);
+        REQUIRE(img.cols == res.width_px);
+
+        size_t mismatches = 0;
+        for (size_t r = 0; r < img.rows; ++r)
+            for (size_t c = 0; c < img.cols; ++c)
+                mismatches += img.get(r, c) != rst.read_pixel(c, r);
+
+        REQUIRE(mismatches == 0);
+    }
+}
+
+TEST_CASE("Black and white PNG written with 1 bit per pixel and row filters decodes to the original", "[PNG]") {
+    // Odd width, so the packed rows end with a partial byte.
+    sla::Resolution res{1001, 1500};
+    sla::PixelDim   pixdim{.05, .05};
+    sla::RasterGrayscaleAA     rst{res, pixdim, {}, agg::gamma_threshold(.5)};
+    sla::RasterGrayscaleAARuns rst_runs{res, pixdim, {}, agg::gamma_threshold(.5)};
+
+    ExPolygon poly;
+    poly.contour.points = {{0, 0}, {scaled(45.), scaled(10.)}, {scaled(15.), scaled(70.)}};
+    rst.draw(poly);
+    rst_runs.draw(poly);
+
+    sla::EncodedRaster gray_png = rst.encode(sla::PNGRasterEncoder{});
+
+    using Filter = sla::PNGRasterEncoder::Filter;
+    for (Filter filter : {Filter::None, Filter::Sub, Filter::Up, Filter::Average, Filter::Paeth}) {
+        sla::PNGRasterEncoder encoder;
+        encoder.filter  = filter;
+        encoder.bilevel = true;
+
+        sla::EncodedRaster enc_rst = rst.encode(encoder);
+        if (filter == Filter::None)
+            REQUIRE(enc_rst.size() < gray_png.size());
+
+        png::ImageGreyscale img;
+        REQUIRE(png::decode_png({enc_rst.data(), enc_rst.size()}, img));
+        REQUIRE(img.rows == res.height_px);
+        REQUIRE(img.cols == res.width_px);
+
+        size_t mismatches = 0;
+        for (size_t r = 0; r < img.rows; ++r)
+            for (size_t c = 0; c < img.cols; ++c)
+                mismatches += img.get(r, c) != rst.read_pixel(c, r);
+
+        REQUIRE(mismatches == 0);
+
+        // The runs are packed the same way as the full frame.
+        sla::EncodedRaster enc_runs = rst_runs.encode(encoder, encoder);
+        REQUIRE(enc_runs.size() == enc_rst.size());
+        REQUIRE(std::memcmp(enc_runs.data(), enc_rst.data(), enc_rst.size()) == 0);
+    }
+}
@@ -68,3 +68,41 @@ TEST_CASE("Archive export test", "[sla_archives]") {
         }
     }
 }
+
+TEST_CASE("Archive export reports progress and can be canceled", "[sla_archives]") {
+    SLAPrint print;
+    SLAFullPrintConfig fullcfg;
+
+    auto m = Model::read_from_file(TEST_DATA_DIR PATH_SEPARATOR + std::string("20mm_cube.obj"), nullptr);
+
+    fullcfg.printer_technology.setInt(ptSLA);
+    fullcfg.set("sla_archive_format", "SL1");
+    fullcfg.set("supports_enable", false);
+    fullcfg.set("pad_enable", false);
+
+    DynamicPrintConfig cfg;
+    cfg.apply(fullcfg);
+
+    std::vector<int> export_status;
+    print.set_status_callback([&export_status](const PrintBase::SlicingStatus &status) {
+        if (status.text == "Rasterizing layers")
+            export_status.emplace_back(status.percent);
+    });
+    print.apply(m, cfg);
+
+    ThumbnailsList thumbnails;
+    const std::string outputfname = "output_canceled.sl1";
+
+    // The layers are only rasterized while exporting, a print has to be processed first.
+    REQUIRE_THROWS_AS(print.export_print(outputfname, thumbnails), ExportError);
+
+    print.process();
+    export_status.clear();
+    print.export_print(outputfname, thumbnails);
+    REQUIRE(! export_status.empty());
+    REQUIRE(std::is_sorted(export_status.begin(), export_status.end()));
+    REQUIRE(export_status.back() == 100);
+
+    print.cancel();
+    REQUIRE_THROWS_AS(print.export_print(outputfname, thumbnails), CanceledException);
+}
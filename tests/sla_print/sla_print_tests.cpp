@@ -2,12 +2,21 @@
 #include <random>
 #include <numeric>
 #include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <atomic>
 
 #include "sla_test_utils.hpp"
 
 #include <libslic3r/TriangleMeshSlicer.hpp>
 #include <libslic3r/SLA/SupportTreeMesher.hpp>
+#include <libslic3r/SLA/BranchingTreeSLA.hpp>
 #include <libslic3r/BranchingTree/PointCloud.hpp>
+#include <libslic3r/Format/AnycubicSLA.hpp>
+#include <libslic3r/SLA/Rotfinder.hpp>
+#include <libslic3r/Geometry.hpp>
+
+#include <tbb/task_arena.h>
 
 namespace {
 
@@ -186,6 +195,136 @@ TEST_CASE("BranchingSupports::FloorSupportsDoNotPierceModel", "[SLASupportGenera
         test_support_model_collision(fname, supportcfg);
 }
 
+TEST_CASE("BranchingSupports::BatchCheckedConnectionsGiveSameTree", "[SLASupportGeneration][Branching]") {
+    using namespace branchingtree;
+
+    // Refuses the connections crossing a box shaped obstacle, either in the
+    // add_* calls only or in a batch check as well.
+    struct ObstacleBuilder : public Builder {
+        bool batched = false;
+        size_t checked_cnt = 0;
+        std::vector<std::tuple<int, int, int>> added;
+
+        static bool crosses_obstacle(const Node &from, const Node &to)
+        {
+            for (float t = 0.f; t <= 1.f; t += 0.05f) {
+                Vec3f p = from.pos + t * (to.pos - from.pos);
+                if (std::abs(p.x()) < 2.f && std::abs(p.y()) < 8.f && p.z() > 5.f && p.z() < 10.f)
+                    return true;
+            }
+
+            return false;
+        }
+
+        bool add(int type, const Node &from, const Node &to, bool feasible)
+        {
+            if (feasible)
+                added.emplace_back(type, from.id, to.id);
+
+            return feasible;
+        }
+
+        std::vector<bool> check_connections(const std::vector<Connection> &conns) override
+        {
+            if (!batched)
+                return Builder::check_connections(conns);
+
+            checked_cnt += conns.size();
+            std::vector<bool> ret;
+            for (const Connection &c : conns)
+                ret.emplace_back(c.type == Connection::Merger ?
+                                     !crosses_obstacle(c.from, c.merge_node) &&
+                                         !crosses_obstacle(c.to, c.merge_node) :
+                                     !crosses_obstacle(c.from, c.to));
+
+            return ret;
+        }
+
+        bool add_bridge(const Node &from, const Node &to) override
+        {
+            return add(0, from, to, !crosses_obstacle(from, to));
+        }
+        bool add_merger(const Node &node, const Node &closest, const Node &merge) override
+        {
+            return add(1, node, closest,
+                       !crosses_obstacle(node, merge) && !crosses_obstacle(closest, merge));
+        }
+        bool add_ground_bridge(const Node &from, const Node &to) override
+        {
+            return add(2, from, to, !crosses_obstacle(from, to));
+        }
+        bool add_mesh_bridge(const Node &from, const Node &to) override
+        {
+            return add(3, from, to, !crosses_obstacle(from, to));
+        }
+        void report_unroutable(const Node &j) override { added.emplace_back(-1, j.id, -1); }
+    };
+
+    auto props = Properties{}.max_slope(PI / 4.).max_branch_length(5.);
+    coord_t    d   = scaled(15.);
+    ExPolygons bed = {ExPolygon{{-d, -d}, {d, -d}, {d, d}, {-d, d}}};
+
+    std::vector<Node> leafs;
+    for (float x = -10.f; x <= 10.f; x += 2.f)
+        for (float y = -10.f; y <= 10.f; y += 2.f)
+            leafs.emplace_back(Vec3f{x, y, 15.f + 0.1f * x}, 0.2f);
+
+    // The bed is sampled randomly, the same samples are needed for both trees
+    std::vector<Node> bedpts = sample_bed(bed, 0.f, 1.);
+
+    auto build = [&](bool batched) {
+        ObstacleBuilder builder;
+        builder.batched = batched;
+        build_tree(PointCloud{{}, bedpts, leafs, props}, builder);
+
+        return builder;
+    };
+
+    ObstacleBuilder sequential = build(false), batched = build(true);
+
+    REQUIRE(batched.checked_cnt > 0);
+    REQUIRE(!sequential.added.empty());
+    REQUIRE(batched.added == sequential.added);
+}
+
+TEST_CASE("BranchingSupports::BatchCheckedConnectionsGiveSameSupportTree", "[SLASupportGeneration][Branching]") {
+    sla::SupportTreeConfig supportcfg;
+    supportcfg.object_elevation_mm = 10.;
+    supportcfg.tree_type = sla::SupportTreeType::Branching;
+
+    TriangleMesh mesh = load_model("A_upsidedown.obj");
+    REQUIRE_FALSE(mesh.empty());
+
+    sla::SupportableMesh sm{mesh.its, calc_support_pts(mesh), supportcfg};
+    REQUIRE_FALSE(sm.pts.empty());
+
+    auto build = [&sm](bool batch_checks) {
+        // The mesh and the bed are sampled randomly, the same samples are
+        // needed for both trees
+        std::srand(0);
+
+        sla::SupportTreeBuilder treebuilder;
+        sla::create_branching_tree(treebuilder, sm, batch_checks);
+
+        return treebuilder;
+    };
+
+    sla::SupportTreeBuilder sequential = build(false), batched = build(true);
+
+    REQUIRE_FALSE(sequential.pillars().empty());
+    REQUIRE(batched.pillars().size() == sequential.pillars().size());
+    REQUIRE(batched.heads().size() == sequential.heads().size());
+
+    for (size_t i = 0; i < sequential.heads().size(); ++i)
+        REQUIRE(batched.heads()[i].is_valid() == sequential.heads()[i].is_valid());
+
+    const indexed_triangle_set &seq_mesh = sequential.retrieve_mesh(sla::MeshType::Support);
+    const indexed_triangle_set &bat_mesh = batched.retrieve_mesh(sla::MeshType::Support);
+
+    REQUIRE(bat_mesh.indices == seq_mesh.indices);
+    REQUIRE(bat_mesh.vertices == seq_mesh.vertices);
+}
+
 TEST_CASE("InitializedRasterShouldBeNONEmpty", "[SLARasterOutput]") {
     // Default Prusa SL1 display parameters
     sla::Resolution res{2560, 1440};
@@ -251,6 +390,364 @@ TEST_CASE("RasterizedPolygonAreaShouldMatch", "[SLARasterOutput]") {
     REQUIRE(raster_pxsum(raster0) == 0);
 }
 
+TEST_CASE("RasterWithPixelRunsShouldMatchFullRaster", "[SLARasterOutput]") {
+    double disp_w = 120., disp_h = 68.;
+    sla::Resolution res{2560, 1440};
+    sla::PixelDim pixdim{disp_w / res.width_px, disp_h / res.height_px};
+    auto bb = BoundingBox({0, 0}, {scaled(disp_w), scaled(disp_h)});
+
+    // Overlapping polygons, one of them reaching out of the display.
+    ExPolygons polys;
+    for (double size : {10., 25., 60.}) {
+        ExPolygon poly = square_with_hole(size);
+        poly.rotate(size / 10.);
+        poly.translate(bb.center().x() + scaled(size / 2.), bb.center().y());
+        polys.emplace_back(std::move(poly));
+    }
+
+    for (double gamma : {1., 0.}) {
+        sla::RasterBase::Trafo trafo{sla::RasterBase::roPortrait, sla::RasterBase::MirrorX};
+        auto raster_full = sla::create_raster_grayscale_aa(res, pixdim, gamma, trafo);
+        auto raster_runs = sla::create_raster_grayscale_aa_runs(res, pixdim, gamma, trafo);
+
+        for (const ExPolygon &poly : polys) {
+            raster_full->draw(poly);
+            raster_runs->draw(poly);
+        }
+
+        auto &raster = static_cast<const sla::RasterGrayscaleAA&>(*raster_full);
+        auto &runs = static_cast<const sla::RasterGrayscaleAARuns&>(*raster_runs).runs();
+        std::vector<uint8_t> row(res.width_px);
+        size_t mismatches = 0, empty_rows = 0;
+        for (size_t y = 0; y < res.height_px; ++y) {
+            std::fill(row.begin(), row.end(), uint8_t(0));
+            runs.unpack_row(y, row.data());
+            for (size_t x = 0; x < res.width_px; ++x)
+                mismatches += row[x] != raster.read_pixel(x, y);
+            empty_rows += runs.rows[y].empty();
+        }
+        REQUIRE(mismatches == 0);
+        REQUIRE(empty_rows > 0);
+
+        sla::EncodedRaster png      = raster.encode(sla::PNGRasterEncoder{});
+        sla::EncodedRaster png_runs = raster_runs->encode(sla::PNGRasterEncoder{}, sla::PNGRasterEncoder{});
+        REQUIRE(png.size() == png_runs.size());
+        REQUIRE(std::memcmp(png.data(), png_runs.data(), png.size()) == 0);
+    }
+}
+
+namespace {
+// Gives the tests access to the raster encoders of the Anycubic writer.
+class AnycubicSLAEncoders : public AnycubicSLAArchive
+{
+public:
+    using AnycubicSLAArchive::get_encoder;
+    using AnycubicSLAArchive::get_runs_encoder;
+};
+} // namespace
+
+TEST_CASE("AnycubicRasterWithPixelRunsShouldMatchFullRaster", "[SLARasterOutput]") {
+    double disp_w = 120., disp_h = 68.;
+    sla::Resolution res{2560, 1440};
+    sla::PixelDim pixdim{disp_w / res.width_px, disp_h / res.height_px};
+    auto bb = BoundingBox({0, 0}, {scaled(disp_w), scaled(disp_h)});
+
+    ExPolygons polys;
+    for (double size : {10., 25., 60.}) {
+        ExPolygon poly = square_with_hole(size);
+        poly.rotate(size / 10.);
+        poly.translate(bb.center().x() + scaled(size / 2.), bb.center().y());
+        polys.emplace_back(std::move(poly));
+    }
+
+    // A band over the whole display width, its white spans continue over
+    // the row ends and have to be split at the longest span length.
+    ExPolygon band;
+    band.contour.points = {{-scaled(1.), scaled(5.)}, {scaled(disp_w + 1.), scaled(5.)},
+                           {scaled(disp_w + 1.), scaled(10.)}, {-scaled(1.), scaled(10.)}};
+    polys.emplace_back(std::move(band));
+
+    AnycubicSLAEncoders archive;
+    for (double gamma : {1., 0.}) {
+        sla::RasterBase::Trafo trafo{sla::RasterBase::roLandscape, sla::RasterBase::NoMirror};
+        auto raster_full = sla::create_raster_grayscale_aa(res, pixdim, gamma, trafo);
+        auto raster_runs = sla::create_raster_grayscale_aa_runs(res, pixdim, gamma, trafo);
+
+        for (const ExPolygon &poly : polys) {
+            raster_full->draw(poly);
+            raster_runs->draw(poly);
+        }
+
+        sla::EncodedRaster rle      = raster_full->encode(archive.get_encoder());
+        sla::EncodedRaster rle_runs = raster_runs->encode(archive.get_encoder(),
+                                                          archive.get_runs_encoder());
+        REQUIRE(rle.size() > 0);
+        REQUIRE(rle.size() == rle_runs.size());
+        REQUIRE(std::memcmp(rle.data(), rle_runs.data(), rle.size()) == 0);
+    }
+}
+
+
+TEST_CASE("Moving an object should merge the same layers as a new print", "[SLAPrint]") {
+    auto make_model = [] {
+        Model m = Model::read_from_file(TEST_DATA_DIR PATH_SEPARATOR "20mm_cube.obj", nullptr);
+        m.add_object(*m.objects.front());
+        m.objects.back()->instances.front()->set_offset(Vec3d{40., 0., 0.});
+        m.objects.back()->scale(Vec3d{1., 1., 1.5});
+
+        return m;
+    };
+
+    SLAFullPrintConfig fullcfg;
+    fullcfg.printer_technology.setInt(ptSLA);
+    fullcfg.set("supports_enable", false);
+    fullcfg.set("pad_enable", false);
+
+    DynamicPrintConfig cfg;
+    cfg.apply(fullcfg);
+
+    Model model = make_model();
+    SLAPrint print;
+    print.set_status_callback([](const PrintBase::SlicingStatus&) {});
+    print.apply(model, cfg);
+    print.process();
+
+    model.objects.front()->instances.front()->set_offset(Vec3d{-40., 10., 0.});
+    print.apply(model, cfg);
+    print.process();
+
+    Model ref_model = make_model();
+    ref_model.objects.front()->instances.front()->set_offset(Vec3d{-40., 10., 0.});
+    SLAPrint ref_print;
+    ref_print.set_status_callback([](const PrintBase::SlicingStatus&) {});
+    ref_print.apply(ref_model, cfg);
+    ref_print.process();
+
+    const auto &layers = print.print_layers();
+    const auto &ref_layers = ref_print.print_layers();
+    REQUIRE(layers.size() == ref_layers.size());
+
+    for (size_t i = 0; i < layers.size(); ++i) {
+        REQUIRE(layers[i].level() == ref_layers[i].level());
+        REQUIRE(get_extents(layers[i].transformed_slices()) ==
+                get_extents(ref_layers[i].transformed_slices()));
+    }
+
+    REQUIRE(print.print_statistics().objects_used_material ==
+            Approx(ref_print.print_statistics().objects_used_material));
+    REQUIRE(print.print_statistics().estimated_print_time ==
+            Approx(ref_print.print_statistics().estimated_print_time));
+}
+
+TEST_CASE("Editing support points should slice the same supports as a new print", "[SLAPrint]") {
+    Model model = Model::read_from_file(TEST_DATA_DIR PATH_SEPARATOR "20mm_cube.obj", nullptr);
+    model.add_object(*model.objects.front());
+    model.objects.back()->instances.front()->set_offset(Vec3d{40., 0., 0.});
+
+    SLAFullPrintConfig fullcfg;
+    fullcfg.printer_technology.setInt(ptSLA);
+    fullcfg.set("supports_enable", true);
+    fullcfg.set("pad_enable", true);
+
+    DynamicPrintConfig cfg;
+    cfg.apply(fullcfg);
+
+    // The support tree is built in parallel and the order of merging its
+    // branches depends on the scheduling. Both prints run on one thread, so
+    // that only the incremental slicing can make them differ.
+    tbb::task_arena arena(1);
+    auto process = [&arena, &cfg](SLAPrint &print, const Model &m) {
+        print.set_status_callback([](const PrintBase::SlicingStatus&) {});
+        arena.execute([&print, &m, &cfg] {
+            print.apply(m, cfg);
+            print.process();
+        });
+    };
+
+    SLAPrint print;
+    process(print, model);
+
+    // Take over the generated points of the first object the same way the
+    // support points gizmo does, the edits below are the user's.
+    const SLAPrintObject *po = print.objects().front();
+    REQUIRE(po->model_object()->id() == model.objects.front()->id());
+    Transform3f inv = po->trafo().inverse().cast<float>();
+    sla::SupportPoints pts;
+    for (const sla::SupportPoint &pt : po->get_support_points())
+        pts.emplace_back(inv * pt.pos, pt.head_front_radius, pt.is_new_island);
+    REQUIRE(pts.size() > 2);
+
+    auto check_same_as_new_print = [&] {
+        model.objects.front()->sla_support_points = pts;
+        model.objects.front()->sla_points_status  = sla::PointsStatus::UserModified;
+        process(print, model);
+
+        SLAPrint ref_print;
+        process(ref_print, model);
+
+        REQUIRE(print.objects().size() == ref_print.objects().size());
+        for (size_t i = 0; i < print.objects().size(); ++i) {
+            const SLAPrintObject &obj = *print.objects()[i];
+            const SLAPrintObject &ref_obj = *ref_print.objects()[i];
+            REQUIRE(obj.get_support_points().size() == ref_obj.get_support_points().size());
+
+            const auto &index = obj.get_slice_index();
+            const auto &ref_index = ref_obj.get_slice_index();
+            REQUIRE(index.size() == ref_index.size());
+            for (size_t j = 0; j < index.size(); ++j) {
+                REQUIRE(index[j].print_level() == ref_index[j].print_level());
+                REQUIRE(index[j].get_slice(soModel) == ref_index[j].get_slice(soModel));
+                REQUIRE(index[j].get_slice(soSupport) == ref_index[j].get_slice(soSupport));
+            }
+        }
+
+        const auto &layers = print.print_layers();
+        const auto &ref_layers = ref_print.print_layers();
+        REQUIRE(layers.size() == ref_layers.size());
+        for (size_t i = 0; i < layers.size(); ++i) {
+            REQUIRE(layers[i].level() == ref_layers[i].level());
+            REQUIRE(layers[i].transformed_slices() == ref_layers[i].transformed_slices());
+        }
+
+        REQUIRE(print.print_statistics().support_used_material ==
+                Approx(ref_print.print_statistics().support_used_material));
+    };
+
+    SECTION("Moving a support point") {
+        pts.front().pos += Vec3f{1.f, 1.f, 0.f};
+        check_same_as_new_print();
+    }
+
+    SECTION("Removing a support point") {
+        pts.pop_back();
+        check_same_as_new_print();
+    }
+
+    SECTION("Moving, then removing support points") {
+        pts.front().pos += Vec3f{1.f, 1.f, 0.f};
+        check_same_as_new_print();
+        pts.erase(pts.begin());
+        check_same_as_new_print();
+    }
+}
+
+namespace {
+// Misalignment of the faces after the rotation found by the rotation finder,
+// the area weighted sum of the absolute normal components per unit area.
+// It is 1 for a mesh with all its faces aligned with the axes.
+double misalignment(const TriangleMesh &mesh, const Vec2d &rot)
+{
+    Transform3d tr = Geometry::rotation_transform(Vec3d{rot.x(), rot.y(), 0.});
+    double S = 0., A = 0.;
+    for (const Vec3i &face : mesh.its.indices) {
+        Vec3d v0 = tr * mesh.its.vertices[face(0)].cast<double>();
+        Vec3d v1 = tr * mesh.its.vertices[face(1)].cast<double>();
+        Vec3d v2 = tr * mesh.its.vertices[face(2)].cast<double>();
+        Vec3d n  = (v1 - v0).cross(v2 - v0);
+        double area = n.norm() / 2.;
+        S += area * n.normalized().cwiseAbs().sum();
+        A += area;
+    }
+
+    return S / A;
+}
+
+// Largest reported status and the number of the status queries, the
+// callback is called from the threads scoring the rotations.
+struct RotfinderStatus {
+    std::atomic<int> max_status{-1};
+    std::atomic<size_t> queries{0};
+
+    void report(int s)
+    {
+        ++queries;
+        for (int prev = max_status; s > prev && !max_status.compare_exchange_weak(prev, s);) ;
+    }
+};
+} // namespace
+
+TEST_CASE("Best misalignment rotation of a rotated cube", "[SLARotfinder]") {
+    // The faces of a cube are the most misaligned with the axes when it is
+    // turned by 45 degrees around both x and y, the sum of the absolute
+    // components of a face normal is then (2 + 2 * sqrt(2)) / 3 on average.
+    const double best = (2. + 2. * std::sqrt(2.)) / 3.;
+
+    // The search rotates around x, then y. Turning the input around x keeps
+    // the best orientation reachable.
+    for (float angle : {0.f, 0.3f, -1.1f}) {
+        TriangleMesh cube = make_cube(20., 20., 20.);
+        cube.translate(-10.f, -10.f, -10.f);
+        cube.rotate_x(angle);
+        REQUIRE(misalignment(cube, Vec2d::Zero()) < best - 0.05);
+
+        Model model;
+        ModelObject *mo = model.add_object("cube", "", cube);
+        mo->add_instance();
+
+        Vec2d rot = sla::find_best_misalignment_rotation(*mo);
+        REQUIRE(misalignment(cube, rot) == Approx(best).epsilon(1e-3));
+    }
+}
+
+TEST_CASE("Rotation finder should stop early when canceled or out of time", "[SLARotfinder]") {
+    TriangleMesh cube = make_cube(20., 20., 20.);
+    cube.rotate_x(0.3f);
+
+    Model model;
+    ModelObject *mo = model.add_object("cube", "", cube);
+    mo->add_instance();
+
+    SECTION("Canceled before the search") {
+        RotfinderStatus status;
+        Vec2d rot = sla::find_best_misalignment_rotation(
+            *mo, sla::RotOptimizeParams{}.statucb([&status](int s) {
+                status.report(s);
+                return false;
+            }));
+
+        // Nothing was scored, the identity is returned.
+        REQUIRE(rot == Vec2d::Zero());
+        REQUIRE(status.max_status < 0);
+        REQUIRE(status.queries > 0);
+    }
+
+    SECTION("Canceled during the search") {
+        RotfinderStatus status;
+        sla::find_best_misalignment_rotation(
+            *mo, sla::RotOptimizeParams{}.statucb([&status](int s) {
+                status.report(s);
+                return status.max_status < 10;
+            }));
+
+        // Only the rotations being scored at the time of the cancel are
+        // finished.
+        REQUIRE(status.max_status >= 10);
+        REQUIRE(status.max_status < 50);
+    }
+
+    SECTION("Time budget runs out") {
+        RotfinderStatus status;
+        Vec2d rot = sla::find_best_misalignment_rotation(
+            *mo, sla::RotOptimizeParams{}.time_budget(1e-9).statucb([&status](int s) {
+                status.report(s);
+                return true;
+            }));
+
+        REQUIRE(rot == Vec2d::Zero());
+        REQUIRE(status.max_status < 50);
+    }
+
+    SECTION("Enough time for the whole search") {
+        RotfinderStatus status;
+        sla::find_best_misalignment_rotation(
+            *mo, sla::RotOptimizeParams{}.time_budget(600.).statucb([&status](int s) {
+                status.report(s);
+                return true;
+            }));
+
+        REQUIRE(status.max_status >= 50);
+    }
+}
 
 TEST_CASE("halfcone test", "[halfcone]") {
     sla::DiffBridge br{Vec3d{1., 1., 1.}, Vec3d{10., 10., 10.}, 0.25, 0.5};
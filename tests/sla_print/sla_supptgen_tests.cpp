@@ -5,6 +5,8 @@
 #include <libslic3r/BoundingBox.hpp>
 #include <libslic3r/SLA/SpatIndex.hpp>
 
+#include <tbb/task_arena.h>
+
 #include "sla_test_utils.hpp"
 
 namespace Slic3r { namespace sla {
@@ -139,4 +141,31 @@ TEST_CASE("Two parallel plates should be supported", "[SupGen][Hollowed]")
     REQUIRE(!pts.empty());
 }
 
+TEST_CASE("Seeded generator should give the same points on many islands", "[SupGen]")
+{
+    // A plate of small pillars at different heights. Each layer has many
+    // islands, the neighbouring ones close enough to be covered in order
+    // within a group, the others covered in parallel.
+    TriangleMesh mesh;
+    for (int i = 0; i < 8; ++i)
+        for (int j = 0; j < 8; ++j) {
+            TriangleMesh pillar = make_cube(2., 2., 2. + (i + j) % 3);
+            pillar.translate(3.f * i, 3.f * j, 5.f + 0.5f * ((i * j) % 4));
+            mesh.merge(pillar);
+        }
+
+    mesh.WriteOBJFile("pillar_plate.obj");
+
+    sla::SupportPointGenerator::Config cfg;
+    sla::SupportPoints pts = calc_support_pts(mesh, cfg);
+    REQUIRE(pts.size() >= 64);
+
+    REQUIRE(calc_support_pts(mesh, cfg) == pts);
+
+    sla::SupportPoints pts_serial;
+    tbb::task_arena arena(1);
+    arena.execute([&] { pts_serial = calc_support_pts(mesh, cfg); });
+    REQUIRE(pts_serial == pts);
+}
+
 }} // namespace Slic3r::sla